@@ -13,6 +13,7 @@
 
 // standard library headers
 #include <chrono>
+#include <cstdint>
 
 // VATA headers
 #include <vata/vata.hh>
@@ -26,14 +27,195 @@ using VATA::InclParam;
 using VATA::EqParam;
 using VATA::SimParam;
 using VATA::ExplicitTreeAut;
+using VATA::ExplicitFiniteAut;
 
 using std::chrono::high_resolution_clock;
 using TimePoint = std::chrono::time_point<high_resolution_clock>;
 
 TimePoint startTime;
 
+// number of worker threads given by an option, throws on invalid values
+unsigned ParseThreads(const std::string& str, const std::runtime_error& optErrorEx)
+{
+	int threads = 0;
+	try
+	{
+		threads = Convert::FromString<int>(str);
+	}
+	catch (const std::invalid_argument&)
+	{
+		throw optErrorEx;
+	}
+
+	if (threads <= 0) { throw optErrorEx; }
+
+	return static_cast<unsigned>(threads);
+}
+
+// number of bytes given by an option with an optional suffix K, M, or G,
+// throws on invalid values
+size_t ParseMemory(const std::string& str, const std::runtime_error& optErrorEx)
+{
+	if (str.empty()) { throw optErrorEx; }
+
+	size_t unit = 1;
+	std::string number = str;
+	switch (str.back())
+	{
+		case 'K': case 'k': unit = 1024; break;
+		case 'M': case 'm': unit = 1024 * 1024; break;
+		case 'G': case 'g': unit = 1024 * 1024 * 1024; break;
+		default: break;
+	}
+
+	if (1 != unit) { number.pop_back(); }
+
+	if (number.empty() ||
+		(number.find_first_not_of("0123456789") != std::string::npos))
+	{
+		throw optErrorEx;
+	}
+
+	size_t value = 0;
+	try
+	{
+		value = Convert::FromString<size_t>(number);
+	}
+	catch (const std::invalid_argument&)
+	{
+		throw optErrorEx;
+	}
+
+	if (value > SIZE_MAX / unit) { throw optErrorEx; }
+
+	return value * unit;
+}
+
+// prints counters of a cache to the error output stream
+void PrintCacheCounters(
+	const std::string&                          name,
+	const VATA::CacheStatistics::Counters&      counters)
+{
+	std::cerr << name << ": " << counters.hits << " hits, " << counters.misses
+		<< " misses, " << counters.evictions << " evictions";
+
+	const size_t lookups = counters.hits + counters.misses;
+	if (0 != lookups)
+	{
+		std::cerr << " (hit rate "
+			<< 100.0 * static_cast<double>(counters.hits) / static_cast<double>(lookups)
+			<< "%)";
+	}
+
+	std::cerr << "\n";
+}
+
+// prints counters of the caches of downward inclusion of tree automata
 template <class Automaton>
-bool CheckInclusion(Automaton smaller, Automaton bigger, const Arguments& args)
+void PrintCacheStatistics(
+	const Automaton&                     /* aut */,
+	const InclParam&                     params,
+	const VATA::CacheStatistics&         stats)
+{
+	if ((InclParam::e_algorithm::antichains == params.GetAlgorithm()) &&
+		(InclParam::e_direction::downward == params.GetDirection()))
+	{
+		PrintCacheCounters("comparisons", stats.lte);
+		PrintCacheCounters("macrostates", stats.macrostates);
+		PrintCacheCounters("antichains", stats.antichains);
+	}
+}
+
+// prints counters of the store of macrostates of finite automata
+void PrintCacheStatistics(
+	const ExplicitFiniteAut&             /* aut */,
+	const InclParam&                     /* params */,
+	const VATA::CacheStatistics&         stats)
+{
+	PrintCacheCounters("macrostates", stats.finiteMacrostates);
+	std::cerr << "macrostates: " << stats.finiteMacrostateCollisions
+		<< " collisions\n";
+}
+
+// a word as a line of symbols separated by spaces
+std::string WordToString(
+	const ExplicitFiniteAut::Word&             word,
+	const ExplicitFiniteAut::AlphabetType&     alphabet)
+{
+	ExplicitFiniteAut::AbstractAlphabet::BwdTranslatorPtr symbolTransl =
+		alphabet->GetSymbolBackTransl();
+
+	std::string str;
+	for (const auto& symbol : word)
+	{
+		if (!str.empty()) { str += " "; }
+		str += (*symbolTransl)(symbol);
+	}
+
+	return str + "\n";
+}
+
+// counterexamples are given only by finite automata
+template <class Automaton, class Param>
+bool CheckWithCounterexample(
+	const Automaton&     /* smaller */,
+	const Automaton&     /* bigger */,
+	const Param&         /* params */,
+	std::string&         /* counterexample */)
+{
+	throw std::runtime_error("Counterexamples are supported only for finite automata");
+}
+
+bool CheckWithCounterexample(
+	const ExplicitFiniteAut&     smaller,
+	const ExplicitFiniteAut&     bigger,
+	const InclParam&             params,
+	ExplicitFiniteAut::Word&     word)
+{
+	return ExplicitFiniteAut::CheckInclusion(smaller, bigger, params, word);
+}
+
+bool CheckWithCounterexample(
+	const ExplicitFiniteAut&     smaller,
+	const ExplicitFiniteAut&     bigger,
+	const EqParam&               params,
+	ExplicitFiniteAut::Word&     word)
+{
+	return ExplicitFiniteAut::CheckEquivalence(smaller, bigger, params, word);
+}
+
+template <class Param>
+bool CheckWithCounterexample(
+	const ExplicitFiniteAut&     smaller,
+	const ExplicitFiniteAut&     bigger,
+	const Param&                 params,
+	std::string&                 counterexample)
+{
+	ExplicitFiniteAut::Word word;
+	bool res = CheckWithCounterexample(smaller, bigger, params, word);
+	if (!res)
+	{
+		counterexample = WordToString(word, smaller.GetAlphabet());
+	}
+
+	return res;
+}
+
+// whether a word witnessing the result should be given, throws on invalid values
+bool ParseCounterexample(const std::string& str, const std::runtime_error& optErrorEx)
+{
+	if (str == "yes") { return true; }
+	if (str == "no") { return false; }
+
+	throw optErrorEx;
+}
+
+template <class Automaton>
+bool CheckInclusion(
+	Automaton            smaller,
+	Automaton            bigger,
+	const Arguments&     args,
+	std::string&         counterexample)
 {
 	// insert default values
 	Options options = args.options;
@@ -43,7 +225,11 @@ bool CheckInclusion(Automaton smaller, Automaton bigger, const Arguments& args)
 	options.insert(std::make_pair("timeS", "yes"));
 	options.insert(std::make_pair("rec", "no"));
 	options.insert(std::make_pair("alg", "antichains"));
-	options.insert(std::make_pair("order", "depth"));
+	options.insert(std::make_pair("order", "size"));
+	options.insert(std::make_pair("threads", "1"));
+	options.insert(std::make_pair("cex", "no"));
+	options.insert(std::make_pair("cachemem", "0"));
+	options.insert(std::make_pair("cachestats", "no"));
 
 	std::runtime_error optErrorEx("Invalid options for inclusion: " +
 			Convert::ToString(options));
@@ -112,6 +298,7 @@ bool CheckInclusion(Automaton smaller, Automaton bigger, const Arguments& args)
 	}
 	else { throw optErrorEx; }
 
+	// order of processing of pairs
 	if (options["order"] == "depth")
 	{
 		ip.SetSearchOrder(InclParam::e_search_order::depth);
@@ -120,8 +307,37 @@ bool CheckInclusion(Automaton smaller, Automaton bigger, const Arguments& args)
 	{
 		ip.SetSearchOrder(InclParam::e_search_order::breadth);
 	}
+	else if (options["order"] == "size")
+	{
+		ip.SetSearchOrder(InclParam::e_search_order::size);
+	}
+	else if (options["order"] == "final")
+	{
+		ip.SetSearchOrder(InclParam::e_search_order::final);
+	}
 	else {throw optErrorEx; }
 
+	// number of worker threads
+	ip.SetThreads(ParseThreads(options["threads"], optErrorEx));
+
+	// memory budget for caches of downward inclusion
+	ip.SetCacheMemory(ParseMemory(options["cachemem"], optErrorEx));
+
+	// print counters of the caches?
+	bool cacheStatistics = false;
+	if (options["cachestats"] == "no")
+	{
+		cacheStatistics = false;
+	}
+	else if (options["cachestats"] == "yes")
+	{
+		cacheStatistics = true;
+	}
+	else { throw optErrorEx; }
+
+	// print a word accepted by the smaller automaton only?
+	bool cex = ParseCounterexample(options["cex"], optErrorEx);
+
 	bool incl_sim_time = false;
 	if (options["timeS"] == "no")
 	{
@@ -142,26 +358,35 @@ bool CheckInclusion(Automaton smaller, Automaton bigger, const Arguments& args)
 
 	AutBase::StateDiscontBinaryRelation sim;
 
-	if (ip.GetUseSimulation())
+	// the congruence algorithm for tree automata computes the simulation itself
+	bool treeCongr = (ip.GetAlgorithm() == InclParam::e_algorithm::congruences) &&
+		(args.representation != REPRESENTATION_EXPLICIT_FA);
+
+	if (ip.GetUseSimulation() && !treeCongr)
 	{	// if simulation is desired, then compute it here!
-		//Automaton unionAut = Automaton::UnionDisjointStates(smaller, bigger);
-		Automaton unionAut;
+		Automaton unionAut = Automaton::UnionDisjointStates(smaller, bigger);
 
 		if (ip.GetAlgorithm() == InclParam::e_algorithm::congruences)
-		{
-			smaller = Automaton::UnionDisjointStates(smaller, bigger);
-		}
-		else
-		{
-			unionAut = Automaton::UnionDisjointStates(smaller, bigger);
+		{	// the congruence algorithm for finite automata runs on the union
+			smaller = unionAut;
 		}
 
 		// TODO: why so much code duplicity?
-		if (InclParam::e_direction::upward == ip.GetDirection())
+		if (args.representation == REPRESENTATION_EXPLICIT_FA)
+		{	// for finite automata compute the forward simulation
+			SimParam sp;
+			sp.SetRelation(VATA::SimParam::e_sim_relation::FA_FORWARD);
+			sp.SetNumStates(states);
+			sp.SetThreads(ip.GetThreads());
+			sim = unionAut.ComputeSimulation(sp);
+			ip.SetSimulation(&sim);
+		}
+		else if (InclParam::e_direction::upward == ip.GetDirection())
 		{	// for upward algorithm compute the upward simulation
 			SimParam sp;
 			sp.SetRelation(VATA::SimParam::e_sim_relation::TA_UPWARD);
 			sp.SetNumStates(states);
+			sp.SetThreads(ip.GetThreads());
 			sim = unionAut.ComputeSimulation(sp);
 			ip.SetSimulation(&sim);
 		}
@@ -170,6 +395,7 @@ bool CheckInclusion(Automaton smaller, Automaton bigger, const Arguments& args)
 			SimParam sp;
 			sp.SetRelation(VATA::SimParam::e_sim_relation::TA_DOWNWARD);
 			sp.SetNumStates(states);
+			sp.SetThreads(ip.GetThreads());
 			sim = unionAut.ComputeSimulation(sp);
 			ip.SetSimulation(&sim);
 		}
@@ -185,7 +411,22 @@ bool CheckInclusion(Automaton smaller, Automaton bigger, const Arguments& args)
 		startTime = high_resolution_clock::now();
 	}
 
-	return Automaton::CheckInclusion(smaller, bigger, ip);
+	if (cex)
+	{
+		return CheckWithCounterexample(smaller, bigger, ip, counterexample);
+	}
+
+	VATA::CacheStatistics cacheStats;
+	ip.SetCacheStatistics(&cacheStats);
+
+	bool res = Automaton::CheckInclusion(smaller, bigger, ip);
+
+	if (cacheStatistics)
+	{
+		PrintCacheStatistics(smaller, ip, cacheStats);
+	}
+
+	return res;
 }
 
 template <
@@ -212,6 +453,10 @@ VATA::AutBase::StateDiscontBinaryRelation ComputeSimulation(
 	// insert default values
 	Options options = args.options;
 	options.insert(std::make_pair("dir", "down"));
+	options.insert(std::make_pair("threads", "1"));
+
+	std::runtime_error optErrorEx("Invalid options for simulation: " +
+			Convert::ToString(options));
 
 	StateType stateCnt = 0;
 	StateToStateTranslator stateTransl(translMap,
@@ -242,10 +487,12 @@ VATA::AutBase::StateDiscontBinaryRelation ComputeSimulation(
 	}
 	else
 	{
-		throw std::runtime_error("Invalid options for simulation: " +
-			Convert::ToString(options));
+		throw optErrorEx;
 	}
 
+	// number of worker threads
+	sp.SetThreads(ParseThreads(options["threads"], optErrorEx));
+
 	return aut.ComputeSimulation(sp);
 }
 
@@ -274,7 +521,11 @@ Automaton ComputeReduction(
 }
 
 template <class Automaton>
-bool CheckEquiv(Automaton smaller, Automaton bigger, const Arguments& args)
+bool CheckEquiv(
+	Automaton            smaller,
+	Automaton            bigger,
+	const Arguments&     args,
+	std::string&         counterexample)
 {
 	// insert default values
 	Options options = args.options;
@@ -282,6 +533,10 @@ bool CheckEquiv(Automaton smaller, Automaton bigger, const Arguments& args)
 	options.insert(std::make_pair("congr", "no"));
 	options.insert(std::make_pair("cache", "no"));
 	options.insert(std::make_pair("dir", "up"));
+	options.insert(std::make_pair("sim", "no"));
+	options.insert(std::make_pair("order", "size"));
+	options.insert(std::make_pair("threads", "1"));
+	options.insert(std::make_pair("cex", "no"));
 
 	// parameters for equivalence
 	EqParam ip;
@@ -303,6 +558,11 @@ bool CheckEquiv(Automaton smaller, Automaton bigger, const Arguments& args)
 	{
 		ip.SetAlgorithm(EqParam::e_algorithm::bisimulation);
 	}
+	else if (options["alg"] == "congr")
+	{	// shortcut for bisimulation up to congruence
+		ip.SetAlgorithm(EqParam::e_algorithm::bisimulation);
+		options["congr"] = "yes";
+	}
 
 	if (options["congr"] == "no")
 	{
@@ -313,6 +573,15 @@ bool CheckEquiv(Automaton smaller, Automaton bigger, const Arguments& args)
 		ip.SetUseCongr(true);
 	}
 
+	if (options["sim"] == "no")
+	{
+		ip.SetUseSimulation(false);
+	}
+	else if (options["sim"] == "yes")
+	{
+		ip.SetUseSimulation(true);
+	}
+
 	if (options["cache"] == "no")
 	{
 		ip.SetUseCache(false);
@@ -342,6 +611,34 @@ bool CheckEquiv(Automaton smaller, Automaton bigger, const Arguments& args)
 
 	else { throw optErrorEx; }
 
+	// order of processing of pairs
+	if (options["order"] == "depth")
+	{
+		ip.SetSearchOrder(EqParam::e_search_order::depth);
+	}
+	else if (options["order"] == "breadth")
+	{
+		ip.SetSearchOrder(EqParam::e_search_order::breadth);
+	}
+	else if (options["order"] == "size")
+	{
+		ip.SetSearchOrder(EqParam::e_search_order::size);
+	}
+	else if (options["order"] == "final")
+	{
+		ip.SetSearchOrder(EqParam::e_search_order::final);
+	}
+	else { throw optErrorEx; }
+
+	// number of worker threads
+	ip.SetThreads(ParseThreads(options["threads"], optErrorEx));
+
+	// print a word accepted by just one of the automata?
+	if (ParseCounterexample(options["cex"], optErrorEx))
+	{
+		return CheckWithCounterexample(smaller, bigger, ip, counterexample);
+	}
+
 	// TODO: change
 	// assert(false);
 	return Automaton::CheckEquivalence(smaller, bigger, ip);
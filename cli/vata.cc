@@ -71,12 +71,31 @@ const char VATA_USAGE_COMMANDS[] =
 	"                              'dir=up'   : upward simulation\n"
 	"               finite automata: 'dir=fwd'  : forward simulation (default)\n"
 	"                                'dir=bwd'  : backward simulation\n"
+	"               'threads=N': use N worker threads for simulation of explicit automata\n"
+	"                            (default 1)\n"
 	"    red <file>   Reduces the automaton in <file> using simulation relation\n"
 	"      Options: 'dir=down' : downward simulation (default)\n"
 	"               'dir=up'   : upward simulation\n"
 	"    equiv <file1> <file2>   Checks whether L(<file1>) == L(<file2>)\n"
-	"      Options: 'order=depth': use depth-first search for congruence algorithm (default)\n"
+	"      Options: 'alg=antichains' : use an antichain-based algorithm (default)\n"
+	"               'alg=congr'      : use a bisimulation up-to congruence algorithm\n"
+	"               'sim=yes'  : use upward simulation in congruence algorithm for tree automata\n"
+	"                            (forward simulation for finite automata)\n"
+	"               'sim=no'   : do not use simulation (default)\n"
+	"               'order=size' : process smallest pairs first in congruence algorithm (default,\n"
+	"                              finite automata use depth-first search)\n"
+	"               'order=depth': use depth-first search for congruence algorithm\n"
 	"               'order=breadth': use breadth-first search for congruence algorithm\n"
+	"               'order=final': process pairs with most final states first in congruence\n"
+	"                              algorithm for tree automata\n"
+	"               'threads=N': use N worker threads for congruence algorithm, upward\n"
+	"                            antichain algorithm for tree automata and simulation\n"
+	"                            (default 1, congruence algorithm for finite automata only\n"
+	"                            with order=breadth)\n"
+	"               'cex=yes'  : print a word accepted by just one automaton on the next line\n"
+	"                            (congruence algorithm for finite automata, the shortest word\n"
+	"                            with order=breadth)\n"
+	"               'cex=no'   : do not print the word (default)\n"
 	"    incl <file1> <file2>    Checks whether L(<file1>) <= L(<file2>)\n"
 	"      Options: 'alg=antichains' : use an antichain-based algorithm (default)\n"
 	"               'alg=congr'      : use a bisimulation up-to congruence algorithm\n"
@@ -84,12 +103,31 @@ const char VATA_USAGE_COMMANDS[] =
 	"               'dir=up'   : upward inclusion checking (default)\n"
 	"               'sim=yes'  : use corresponding simulation\n"
 	"               'sim=no'   : do not use simulation (default)\n"
-	"               'order=depth': use depth-first search for congruence algorithm (default)\n"
+	"               'order=size' : process smallest pairs first in congruence algorithm (default,\n"
+	"                              finite automata use depth-first search)\n"
+	"               'order=depth': use depth-first search for congruence algorithm\n"
 	"               'order=breadth': use breadth-first search for congruence algorithm\n"
+	"               'order=final': process pairs with most final states first in congruence\n"
+	"                              algorithm for tree automata\n"
+	"               'threads=N': use N worker threads for congruence algorithm, upward\n"
+	"                            antichain algorithm for tree automata and simulation\n"
+	"                            (default 1, congruence algorithm for finite automata only\n"
+	"                            with order=breadth)\n"
+	"               'cex=yes'  : print a word accepted only by <file1> on the next line\n"
+	"                            (congruence algorithm for finite automata, the shortest word\n"
+	"                            with order=breadth)\n"
+	"               'cex=no'   : do not print the word (default)\n"
+	"               'cachemem=N': memory budget for caches of downward inclusion in bytes,\n"
+	"                            suffixes K, M, G are allowed (default 0 ... unlimited)\n"
+	"               'cachestats=yes': print counters of the caches of downward inclusion\n"
+	"                                 and of macrostates of finite automata to the\n"
+	"                                 error output stream\n"
+	"               'cachestats=no' : do not print the counters (default)\n"
 	"               'optC=yes' : use optimised cache for downward direction\n"
 	"               'optC=no'  : without optimised cache (default)\n"
-	"               'rec=no'   : recursive version of the algorithm (default)\n"
-	"               'rec=yes'  : non-recursive version of the algorithm\n"
+	"               'rec=no'   : non-recursive version of the algorithm (default)\n"
+	"               'rec=yes'  : recursive version of the algorithm (explicit automata\n"
+	"                            always use the non-recursive version)\n"
 	"               'timeS=yes': include time of simulation computation (default)\n"
 	"               'timeS=no' : do not include time of simulation computation\n"
 	;
@@ -151,6 +189,7 @@ int performOperation(
 	Aut autInput2;
 	Aut autResult;
 	bool boolResult = false;
+	std::string counterexample;
 	VATA::AutBase::StateDiscontBinaryRelation relResult;
 
 	StateDict stateDict1;
@@ -237,11 +276,11 @@ int performOperation(
 	}
 	else if (args.command == COMMAND_INCLUSION)
 	{
-		boolResult = CheckInclusion(autInput1, autInput2, args);
+		boolResult = CheckInclusion(autInput1, autInput2, args, counterexample);
 	}
 	else if (args.command == COMMAND_EQUIV)
 	{
-		boolResult = CheckEquiv(autInput1, autInput2, args);
+		boolResult = CheckEquiv(autInput1, autInput2, args, counterexample);
 	}
 	else if (args.command == COMMAND_SIM)
 	{
@@ -306,6 +345,7 @@ int performOperation(
 		if ((args.command == COMMAND_INCLUSION) || (args.command == COMMAND_EQUIV))
 		{
 			std::cout << boolResult << "\n";
+			std::cout << counterexample;
 		}
 
 		if (args.command == COMMAND_SIM)
@@ -37,6 +37,14 @@ namespace VATA
 			upward
 		};
 
+		enum class e_search_order
+		{
+			breadth,
+			depth,
+			size,
+			final
+		};
+
 		typedef unsigned TOptions;
 
 	private: // constants
@@ -51,6 +59,8 @@ namespace VATA
 		static const unsigned FLAG_MASK_CACHE                  = 1 << 3;
 		/// 0 ... be strict (default),		1 ... be lax
 		static const unsigned FLAG_MASK_LAX                    = 1 << 4;
+		/// 0 ... do not use (default),		1 ... use simulation
+		static const unsigned FLAG_MASK_SIMULATION             = 1 << 5;
 
 	public:  // constants
 		static const unsigned ANTICHAINS_UP = 0
@@ -74,6 +84,12 @@ namespace VATA
             | FLAG_MASK_CONGRUENCE
 			;
 
+		static const unsigned CONGRUENCE_UP_SIM = 0
+			| FLAG_MASK_ALGORITHM
+            | FLAG_MASK_CONGRUENCE
+			| FLAG_MASK_SIMULATION
+			;
+
 		static const unsigned CONGRUENCE_DOWN = 0
 			| FLAG_MASK_ALGORITHM
             | FLAG_MASK_CONGRUENCE
@@ -106,10 +122,22 @@ namespace VATA
 		 */
 		TOptions flags_;
 
+		/**
+		 * @brief  Number of worker threads (1 ... sequential)
+		 */
+		unsigned threads_;
+
+		/**
+		 * @brief  Order of processing of pairs
+		 */
+		e_search_order searchOrder_;
+
 	public:   // methods
 
 		EqParam() :
-			flags_(0)
+			flags_(0),
+			threads_(1),
+			searchOrder_(e_search_order::size)
 		{ }
 
 		void SetAlgorithm(e_algorithm alg)
@@ -207,11 +235,49 @@ namespace VATA
 			return flags_ & FLAG_MASK_LAX;
 		}
 
+		void SetUseSimulation(bool useSimulation)
+		{
+			if (useSimulation)
+			{
+				flags_ |=  FLAG_MASK_SIMULATION;
+			}
+			else
+			{
+				flags_ &= ~FLAG_MASK_SIMULATION;
+			}
+		}
+
+		bool GetUseSimulation() const
+		{
+			return flags_ & FLAG_MASK_SIMULATION;
+		}
+
 		TOptions GetOptions() const
 		{
 			return flags_;
 		}
 
+		void SetThreads(unsigned threads)
+		{
+			assert(0 < threads);
+			threads_ = threads;
+		}
+
+		unsigned GetThreads() const
+		{
+			return threads_;
+		}
+
+		void SetSearchOrder(e_search_order order)
+		{
+			searchOrder_ = order;
+		}
+
+		e_search_order GetSearchOrder() const
+		{
+			return searchOrder_;
+		}
+
 		std::string toString() const
 		{
 			// TODO add toString similar to one in InclParam
@@ -47,6 +47,7 @@ public: // public data types
 
 	using SymbolType       = uintptr_t ;
 	using SymbolSet        = std::unordered_set<SymbolType>;
+	using Word             = std::vector<SymbolType>;
 	using StringSymbolType = std::string;
 
 	using SymbolDict                     =
@@ -107,6 +108,13 @@ public: // public data types
 	class StateSet : public std::unordered_set<StateType>	 {
 	GCC_DIAG_ON(effc++)
 	public:
+		StateSet() : std::unordered_set<StateType>() {}
+
+		template <class InputIterator>
+		StateSet(InputIterator first, InputIterator last) :
+			std::unordered_set<StateType>(first, last)
+		{}
+
 		bool IsSubsetOf(const StateSet& rhs) const {
 			for (StateType state : *this) {
 				if (!rhs.count(state)) { // counterexample found
@@ -251,6 +259,19 @@ public: // public methods
 		const ExplicitFiniteAut&    bigger,
 		const InclParam&            params);
 
+	/**
+	 * Checks inclusion and if it does not hold, stores a word accepted
+	 * by smaller but not by bigger to counterexample. The word is
+	 * the shortest one for breadth-first order. Only the congruence
+	 * algorithm keeps words, NotImplementedException is thrown for
+	 * the other algorithms.
+	 */
+	static bool CheckInclusion(
+		const ExplicitFiniteAut&    smaller,
+		const ExplicitFiniteAut&    bigger,
+		const InclParam&            params,
+		Word&                       counterexample);
+
 	ExplicitFiniteAut Reverse(
 			AutBase::StateToStateMap* pTranslMap = nullptr) const;
 
@@ -265,12 +286,20 @@ public: // public methods
 	}
 
 	static bool CheckEquivalence(
-		__attribute__((unused)) const ExplicitFiniteAut&                 smaller,
-		__attribute__((unused)) const ExplicitFiniteAut&                 bigger,
-		__attribute__((unused)) const VATA::EqParam&                 params)
-	{
-		throw NotImplementedException(__func__);
-	}
+		const ExplicitFiniteAut&    smaller,
+		const ExplicitFiniteAut&    bigger,
+		const VATA::EqParam&        params);
+
+	/**
+	 * Checks equivalence and if it does not hold, stores a word accepted
+	 * by just one of the automata to counterexample (with the same
+	 * restrictions as for inclusion).
+	 */
+	static bool CheckEquivalence(
+		const ExplicitFiniteAut&    smaller,
+		const ExplicitFiniteAut&    bigger,
+		const VATA::EqParam&        params,
+		Word&                       counterexample);
 
 
 	AutBase::StateDiscontBinaryRelation ComputeSimulation(
@@ -127,14 +127,24 @@ public:
 
 public:
 
+	/**
+	 * @brief  Computes the maximal simulation on the LTS
+	 *
+	 * The simulation is restricted to states from 0 to @p outputSize - 1. With
+	 * more @p threads, changes of blocks of the partition after a refinement
+	 * are collected in parallel and applied in the same order as by the
+	 * sequential computation, so the result does not depend on @p threads.
+	 */
 	Util::BinaryRelation computeSimulation(
 		const std::vector<std::vector<size_t>>&   partition,
 		const Util::BinaryRelation&               relation,
-		size_t                                    outputSize
+		size_t                                    outputSize,
+		size_t                                    threads = 1
 	);
 
 	Util::BinaryRelation computeSimulation(
-		size_t   outputSize);
+		size_t   outputSize,
+		size_t   threads = 1);
 
 	Util::BinaryRelation computeSimulation();
 };
@@ -16,6 +16,67 @@
 
 namespace VATA
 {
+	/**
+	 * @brief  Counters of the caches of inclusion checking
+	 *
+	 * The caches of downward inclusion of tree automata and the store of
+	 * macrostates of finite automata are counted.
+	 */
+	struct CacheStatistics
+	{
+		struct Counters
+		{
+			size_t hits;
+			size_t misses;
+
+			/**
+			 * @brief  Entries dropped to fit into the memory budget
+			 */
+			size_t evictions;
+
+			Counters() :
+				hits(0),
+				misses(0),
+				evictions(0)
+			{ }
+		};
+
+		/**
+		 * @brief  Cache of comparisons of macrostates
+		 */
+		Counters lte;
+
+		/**
+		 * @brief  Cache of macrostates (released when not used anymore,
+		 *         evicted with the entries of antichains pointing to them)
+		 */
+		Counters macrostates;
+
+		/**
+		 * @brief  Antichains of pairs with known (non)inclusion
+		 */
+		Counters antichains;
+
+		/**
+		 * @brief  Store of macrostates of finite automata (never evicts)
+		 */
+		Counters finiteMacrostates;
+
+		/**
+		 * @brief  Probed slots of the store of macrostates of finite automata
+		 *         holding a different macrostate
+		 */
+		size_t finiteMacrostateCollisions;
+
+		CacheStatistics() :
+			lte(),
+			macrostates(),
+			antichains(),
+			finiteMacrostates(),
+			finiteMacrostateCollisions(0)
+		{ }
+	};
+
 	/**
 	 * @brief  Structure containing parameters for inclusion checking functions
 	 *
@@ -40,7 +101,9 @@ namespace VATA
 		enum class e_search_order
 		{
 			breadth,
-			depth
+			depth,
+			size,
+			final
 		};
 
 		typedef unsigned TOptions;
@@ -57,7 +120,7 @@ namespace VATA
 		static const unsigned FLAG_MASK_RECURSIVE              = 1 << 3;
 		/// 0 ... do not use (default),       1 ... use simulation
 		static const unsigned FLAG_MASK_SIMULATION             = 1 << 4;
-		/// 0 ... depth-first search (default), 1 ... breadth-first search
+		/// 0 ... other search orders (default), 1 ... breadth-first search
 		static const unsigned FLAG_MASK_SEARCH_ORDER           = 1 << 5;
 		/// 0 ... equivalence checking no (default), 1 ... yes
 		static const unsigned FLAG_MASK_EQUIV                  = 1 << 6;
@@ -136,6 +199,12 @@ namespace VATA
 			| FLAG_MASK_SEARCH_ORDER
 			;
 
+		static const unsigned CONGR_BREADTH_SIM = 0
+			| FLAG_MASK_ALGORITHM
+			| FLAG_MASK_SEARCH_ORDER
+			| FLAG_MASK_SIMULATION
+			;
+
 		static const unsigned CONGR_DEPTH_EQUIV_NOSIM = 0
 			| FLAG_MASK_ALGORITHM
 			| FLAG_MASK_EQUIV
@@ -147,6 +216,19 @@ namespace VATA
 			| FLAG_MASK_SEARCH_ORDER
 			;
 
+		static const unsigned CONGR_DEPTH_EQUIV_SIM = 0
+			| FLAG_MASK_ALGORITHM
+			| FLAG_MASK_EQUIV
+			| FLAG_MASK_SIMULATION
+			;
+
+		static const unsigned CONGR_BREADTH_EQUIV_SIM = 0
+			| FLAG_MASK_ALGORITHM
+			| FLAG_MASK_EQUIV
+			| FLAG_MASK_SEARCH_ORDER
+			| FLAG_MASK_SIMULATION
+			;
+
 	private: // data members
 
 		/**
@@ -159,11 +241,37 @@ namespace VATA
 		 */
 		const AutBase::StateDiscontBinaryRelation* simulation_;
 
+		/**
+		 * @brief  Number of worker threads (1 ... sequential)
+		 */
+		unsigned threads_;
+
+		/**
+		 * @brief  Memory budget for caches of downward inclusion checking in
+		 *         bytes (0 ... unlimited)
+		 */
+		size_t cacheMemory_;
+
+		/**
+		 * @brief  Where to store counters of the caches (if present)
+		 */
+		CacheStatistics* cacheStatistics_;
+
+		/**
+		 * @brief  Order of processing of pairs (finite automata only
+		 *         distinguish breadth-first search from depth-first search)
+		 */
+		e_search_order searchOrder_;
+
 	public:   // methods
 
 		InclParam() :
 			flags_(0),
-			simulation_(nullptr)
+			simulation_(nullptr),
+			threads_(1),
+			cacheMemory_(0),
+			cacheStatistics_(nullptr),
+			searchOrder_(e_search_order::size)
 		{ }
 
 		void SetAlgorithm(e_algorithm alg)
@@ -282,22 +390,19 @@ namespace VATA
 		{
 			switch (order)
 			{
-				case e_search_order::depth:   flags_ &= ~FLAG_MASK_SEARCH_ORDER; break;
+				case e_search_order::depth:
+				case e_search_order::size:
+				case e_search_order::final:   flags_ &= ~FLAG_MASK_SEARCH_ORDER; break;
 				case e_search_order::breadth: flags_ |=  FLAG_MASK_SEARCH_ORDER; break;
 				default: assert(false);
 			}
+
+			searchOrder_ = order;
 		}
 
 		e_search_order GetSearchOrder() const
 		{
-			if (flags_ & FLAG_MASK_SEARCH_ORDER)
-			{
-				return e_search_order::breadth;
-			}
-			else
-			{
-				return e_search_order::depth;
-			}
+			return searchOrder_;
 		}
 
 		void SetEquivalence(bool equiv)
@@ -324,6 +429,37 @@ namespace VATA
 			}
 		}
 
+		void SetThreads(unsigned threads)
+		{
+			assert(0 < threads);
+			threads_ = threads;
+		}
+
+		unsigned GetThreads() const
+		{
+			return threads_;
+		}
+
+		void SetCacheMemory(size_t cacheMemory)
+		{
+			cacheMemory_ = cacheMemory;
+		}
+
+		size_t GetCacheMemory() const
+		{
+			return cacheMemory_;
+		}
+
+		void SetCacheStatistics(CacheStatistics* stats)
+		{
+			cacheStatistics_ = stats;
+		}
+
+		CacheStatistics* GetCacheStatistics() const
+		{
+			return cacheStatistics_;
+		}
+
 		std::string toString() const;
 	};
 }
@@ -42,6 +42,15 @@ namespace VATA
 		 */
 		size_t numStates_ = static_cast<size_t>(-1);
 
+		/**
+		 * @brief  Number of worker threads (1 ... sequential)
+		 *
+		 * Explicit automata compute the relation on an LTS whose refinement
+		 * collects changes of blocks of the partition in parallel, the relation is
+		 * the same for any number of threads.
+		 */
+		unsigned threads_ = 1;
+
 	public:   // methods
 
 		void SetRelation(e_sim_relation rel)
@@ -64,6 +73,17 @@ namespace VATA
 			return numStates_;
 		}
 
+		void SetThreads(unsigned threads)
+		{
+			assert(0 < threads);
+			threads_ = threads;
+		}
+
+		unsigned GetThreads() const
+		{
+			return threads_;
+		}
+
 		std::string toString() const
 		{
 			std::string result = "SimParam relation: ";
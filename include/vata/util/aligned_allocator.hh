@@ -0,0 +1,86 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Description:
+ *    Allocator of memory aligned to a given boundary.
+ *
+ *****************************************************************************/
+
+#ifndef _VATA_ALIGNED_ALLOCATOR_HH_
+#define _VATA_ALIGNED_ALLOCATOR_HH_
+
+// Standard library headers
+#include <cstdlib>
+#include <new>
+
+namespace VATA
+{
+	namespace Util
+	{
+		template <class T, size_t Alignment>
+		class AlignedAllocator;
+	}
+}
+
+
+/**
+ * @brief  Allocator returning memory aligned to @p Alignment bytes
+ *
+ * The allocator is meant for containers of words processed a cache line at a
+ * time, e.g., rows of a bit matrix. @p Alignment needs to be a power of two
+ * and a multiple of the size of a pointer.
+ */
+template <class T, size_t Alignment>
+class VATA::Util::AlignedAllocator
+{
+public:   // data types
+
+	using value_type = T;
+
+	template <class U>
+	struct rebind
+	{
+		using other = AlignedAllocator<U, Alignment>;
+	};
+
+public:   // methods
+
+	AlignedAllocator()
+	{ }
+
+	template <class U>
+	AlignedAllocator(const AlignedAllocator<U, Alignment>&)
+	{ }
+
+	T* allocate(size_t n)
+	{
+		const size_t bytes = (0 == n) ? 1 : n * sizeof(T);
+
+		void* ptr = nullptr;
+		if (posix_memalign(&ptr, Alignment, bytes))
+		{
+			throw std::bad_alloc();
+		}
+
+		return static_cast<T*>(ptr);
+	}
+
+	void deallocate(T* ptr, size_t)
+	{
+		free(ptr);
+	}
+
+	template <class U>
+	bool operator==(const AlignedAllocator<U, Alignment>&) const
+	{
+		return true;
+	}
+
+	template <class U>
+	bool operator!=(const AlignedAllocator<U, Alignment>&) const
+	{
+		return false;
+	}
+};
+
+#endif
@@ -13,11 +13,13 @@
 
 // VATA headers
 #include <vata/vata.hh>
+#include <vata/util/aligned_allocator.hh>
 #include <vata/util/convert.hh>
 #include <vata/util/transl_weak.hh>
 #include <vata/util/two_way_dict.hh>
 
 // Standard library headers
+#include <cstdint>
 #include <vector>
 #include <algorithm>
 #include <unordered_map>
@@ -36,34 +38,164 @@ namespace VATA
 /**
  * @brief  A binary relation address continuously
  *
- * A binary relation addressed from indices from 0 to @p size_ - 1
+ * A binary relation addressed from indices from 0 to @p size_ - 1. The
+ * relation is stored as a row-major bit matrix where every row starts at
+ * a cache line boundary, so operations on whole rows (union, intersection,
+ * counting and enumeration of images) and transposition are done a word at
+ * a time. Bits of columns and rows outside of the relation are kept
+ * cleared.
  */
 class VATA::Util::BinaryRelation
 {
-	std::vector<bool> data_;
+public:   // data types
+
+	typedef uint64_t WordType;
+
+	static const size_t WORD_BITS = 64;
+
+	/// Alignment of rows in bytes
+	static const size_t ROW_ALIGNMENT = 64;
+
+private:  // data types
+
+	using StorageType = std::vector<WordType,
+		AlignedAllocator<WordType, ROW_ALIGNMENT>>;
+
+private:  // data members
+
+	StorageType data_;
+
+	/// Number of allocated rows (and columns)
 	size_t rowSize_;
+
+	/// Number of words of a row
+	size_t rowWords_;
+
 	size_t size_;
 
+private:  // methods
+
+	static size_t wordCount(size_t bits)
+	{
+		return (bits + WORD_BITS - 1) / WORD_BITS;
+	}
+
+	static size_t rowWordCount(size_t rowSize)
+	{
+		const size_t lineWords = ROW_ALIGNMENT / sizeof(WordType);
+
+		return (wordCount(rowSize) + lineWords - 1) / lineWords * lineWords;
+	}
+
+	static WordType bit(size_t c)
+	{
+		return WordType(1) << (c % WORD_BITS);
+	}
+
+	WordType* rowData(size_t r)
+	{
+		return data_.data() + r*rowWords_;
+	}
+
+	const WordType* rowData(size_t r) const
+	{
+		return data_.data() + r*rowWords_;
+	}
+
+	/**
+	 * @brief  Sets columns from @p first to @p last - 1 of the row @p r
+	 */
+	void fillRow(size_t r, size_t first, size_t last, bool val)
+	{
+		WordType* words = this->rowData(r);
+
+		for ( ; (first < last) && (first % WORD_BITS); ++first)
+		{
+			if (val) words[first / WORD_BITS] |= bit(first);
+			else     words[first / WORD_BITS] &= ~bit(first);
+		}
+
+		for ( ; first + WORD_BITS <= last; first += WORD_BITS)
+		{
+			words[first / WORD_BITS] = val ? ~WordType(0) : WordType(0);
+		}
+
+		for ( ; first < last; ++first)
+		{
+			if (val) words[first / WORD_BITS] |= bit(first);
+			else     words[first / WORD_BITS] &= ~bit(first);
+		}
+	}
+
+	/**
+	 * @brief  Transposes a 64x64 block of bits in place
+	 *
+	 * Swaps the off-diagonal halves of 32x32 quarters, then of 16x16 quarters
+	 * of these and so on (see Hacker's Delight, Section 7-3).
+	 */
+	static void transposeBlock(WordType* block)
+	{
+		WordType mask = 0x00000000FFFFFFFFULL;
+		for (size_t j = WORD_BITS / 2; j != 0; j >>= 1, mask ^= mask << j)
+		{
+			for (size_t k = 0; k < WORD_BITS; k = ((k | j) + 1) & ~j)
+			{
+				WordType t = ((block[k] >> j) ^ block[k | j]) & mask;
+				block[k] ^= t << j;
+				block[k | j] ^= t;
+			}
+		}
+	}
+
+	/**
+	 * @brief  Finds the first element of @p heads in both directions related
+	 *         to @p i
+	 *
+	 * @returns  The element or @p size_ if there is no such element
+	 */
+	size_t findSymmetric(size_t i, const std::vector<WordType>& heads) const
+	{
+		const WordType* words = this->rowData(i);
+
+		for (size_t w = 0; w < heads.size(); ++w)
+		{
+			for (WordType word = words[w] & heads[w]; word; word &= word - 1)
+			{
+				size_t j = w*WORD_BITS + __builtin_ctzll(word);
+				if (this->get(j, i))
+				{
+					return j;
+				}
+			}
+		}
+
+		return size_;
+	}
+
 protected:
 
-	void realloc(size_t newRowSize, bool defVal)
+	void realloc(size_t newRowSize)
 	{
 		// check for sane parameters
 		assert(0 < newRowSize);
+		assert(size_ <= newRowSize);
+
+		const size_t newRowWords = rowWordCount(newRowSize);
+		const size_t usedWords = wordCount(size_);
 
-		std::vector<bool> tmp(newRowSize*newRowSize, defVal);
-		std::vector<bool>::const_iterator src = data_.begin();
-		std::vector<bool>::iterator dst = tmp.begin();
-		for (size_t i = 0; i < size_; ++i) {
-			std::copy(src, src + size_, dst);
-			src += rowSize_;
-			dst += newRowSize;
+		StorageType tmp(newRowSize*newRowWords, 0);
+		for (size_t i = 0; i < size_; ++i)
+		{
+			const WordType* src = this->rowData(i);
+			std::copy(src, src + usedWords, tmp.data() + i*newRowWords);
 		}
+
 		std::swap(data_, tmp);
 		rowSize_ = newRowSize;
+		rowWords_ = newRowWords;
 	}
 
-	void grow(size_t newSize, bool defVal = false)
+	void grow(size_t newSize)
 	{
 		assert(rowSize_ <= newSize);
 
@@ -71,34 +203,56 @@ protected:
 		while (newRowSize <= newSize)
 			newRowSize <<= 1;
 		assert(newSize <= newRowSize);
-		this->realloc(newRowSize, defVal);
-
-	}
-/*
-	void shrinkToFit() {
-
-		assert(this->rowSize_ > this->size_);
-		size_t newRowSize = this->rowSize_;
-		while (this->size_ < (newRowSize >> 1))
-			newRowSize >>= 1;
-		assert(this->size_ <= newRowSize);
 		this->realloc(newRowSize);
 
 	}
-*/
+
 public:
 
 	void reset(bool defVal)
 	{
-		std::fill(data_.begin(), data_.end(), defVal);
+		for (size_t i = 0; i < size_; ++i)
+		{
+			this->fillRow(i, 0, size_, defVal);
+		}
 	}
 
+	/**
+	 * @brief  Changes the number of elements of the relation
+	 *
+	 * Pairs with new elements are set to @p defVal, pairs with removed elements
+	 * are dropped.
+	 */
 	void resize(size_t size, bool defVal = false)
 	{
-
 		if (rowSize_ < size)
 		{
-			this->grow(size, defVal);
+			this->grow(size);
+		}
+
+		if (size_ < size)
+		{
+			for (size_t i = 0; i < size_; ++i)
+			{
+				this->fillRow(i, size_, size, defVal);
+			}
+
+			for (size_t i = size_; i < size; ++i)
+			{
+				this->fillRow(i, 0, size, defVal);
+			}
+		}
+		else
+		{
+			for (size_t i = 0; i < size; ++i)
+			{
+				this->fillRow(i, size, size_, false);
+			}
+
+			for (size_t i = size; i < size_; ++i)
+			{
+				this->fillRow(i, 0, size_, false);
+			}
 		}
 
 		size_ = size;
@@ -123,26 +277,24 @@ public:
 			this->grow(size_ + 1);
 		}
 
-		assert((size_ + 1)*rowSize_ <= data_.size());
+		assert((size_ + 1)*rowWords_ <= data_.size());
 
 		// fill collumns
-		auto src = data_.begin() + i;
-		auto end = src + size_*rowSize_;
-		auto dst = data_.begin() + size_;
-
-		for ( ; src != end; src += rowSize_, dst += rowSize_)
+		for (size_t r = 0; r < size_; ++r)
 		{
-			*dst = *src;
+			if (this->get(r, i))
+			{
+				this->rowData(r)[size_ / WORD_BITS] |= bit(size_);
+			}
 		}
 
 		// fill rows
-		src = data_.begin() + i*rowSize_;
-		dst = data_.begin() + size_*rowSize_;
-
-		std::copy(src, src + size_, dst);
+		const WordType* src = this->rowData(i);
+		std::copy(src, src + wordCount(size_ + 1), this->rowData(size_));
 
 		// set the reflexive bit
-		*(dst + size_) = reflexive;
+		WordType& last = this->rowData(size_)[size_ / WORD_BITS];
+		last = reflexive ? (last | bit(size_)) : (last & ~bit(size_));
 
 		return size_++;
 	}
@@ -150,17 +302,18 @@ public:
 	bool get(size_t r, size_t c) const
 	{
 		assert(r < size_ && c < size_);
-		assert(r*rowSize_ + c < data_.size());
+		assert(r*rowWords_ + c / WORD_BITS < data_.size());
 
-		return data_[r*rowSize_ + c];
+		return (this->rowData(r)[c / WORD_BITS] & bit(c)) != 0;
 	}
 
 	void set(size_t r, size_t c, bool v)
 	{
 		assert(r < size_ && c < size_);
-		assert(r*rowSize_ + c < data_.size());
+		assert(r*rowWords_ + c / WORD_BITS < data_.size());
 
-		data_[r*rowSize_ + c] = v;
+		if (v) this->rowData(r)[c / WORD_BITS] |= bit(c);
+		else   this->rowData(r)[c / WORD_BITS] &= ~bit(c);
 	}
 
 	size_t size() const
@@ -168,6 +321,72 @@ public:
 		return size_;
 	}
 
+	/**
+	 * @brief  Adds images of @p src to images of @p dst
+	 */
+	void unionRows(size_t dst, size_t src)
+	{
+		assert(dst < size_ && src < size_);
+
+		WordType* dstWords = this->rowData(dst);
+		const WordType* srcWords = this->rowData(src);
+		for (size_t w = 0; w < rowWords_; ++w)
+		{
+			dstWords[w] |= srcWords[w];
+		}
+	}
+
+	/**
+	 * @brief  Keeps only those images of @p dst which are images of @p src
+	 */
+	void intersectRows(size_t dst, size_t src)
+	{
+		assert(dst < size_ && src < size_);
+
+		WordType* dstWords = this->rowData(dst);
+		const WordType* srcWords = this->rowData(src);
+		for (size_t w = 0; w < rowWords_; ++w)
+		{
+			dstWords[w] &= srcWords[w];
+		}
+	}
+
+	/**
+	 * @brief  Returns the number of images of @p r
+	 */
+	size_t countRow(size_t r) const
+	{
+		assert(r < size_);
+
+		const WordType* words = this->rowData(r);
+		size_t count = 0;
+		for (size_t w = 0; w < rowWords_; ++w)
+		{
+			count += __builtin_popcountll(words[w]);
+		}
+
+		return count;
+	}
+
+	/**
+	 * @brief  Appends images of @p r to @p images in the ascending order
+	 */
+	void appendRow(size_t r, std::vector<size_t>& images) const
+	{
+		assert(r < size_);
+
+		images.reserve(images.size() + this->countRow(r));
+
+		const WordType* words = this->rowData(r);
+		for (size_t w = 0; w < wordCount(size_); ++w)
+		{
+			for (WordType word = words[w]; word; word &= word - 1)
+			{
+				images.push_back(w*WORD_BITS + __builtin_ctzll(word));
+			}
+		}
+	}
+
 public:
 
 	using IndexType    = std::vector<std::vector<size_t>>;
@@ -176,8 +395,9 @@ public:
 		size_t         size = 0,
 		bool           defVal = false,
 		size_t         rowSize = 16) :
-		data_(rowSize*rowSize, defVal),
+		data_(rowSize*rowWordCount(rowSize), 0),
 		rowSize_(rowSize),
+		rowWords_(rowWordCount(rowSize)),
 		size_(0)
 	{
 		this->resize(size, defVal);
@@ -189,8 +409,9 @@ public:
 */
 
 	BinaryRelation(const std::vector<std::vector<bool> >& rel) :
-		data_(16*16, false),
+		data_(16*rowWordCount(16), 0),
 		rowSize_(16),
+		rowWords_(rowWordCount(16)),
 		size_(0)
 	{
 		this->resize(rel.size(), false);
@@ -215,23 +436,18 @@ public:
 	void buildClasses(std::vector<size_t>& headIndex) const
 	{
 		headIndex.resize(size_);
-		std::vector<size_t> head;
+		std::vector<WordType> heads(wordCount(size_), 0);
 		for (size_t i = 0; i < size_; ++i)
 		{
-			size_t j = 0;
-			while ((j < head.size()) && !this->sym(i, head[j]))
+			size_t j = this->findSymmetric(i, heads);
+			if (j < size_)
 			{
-				++j;
-			}
-
-			if (j < head.size())
-			{
-				headIndex[i] = head[j];
+				headIndex[i] = j;
 			}
 			else
 			{
 				headIndex[i] = i;
-				head.push_back(i);
+				heads[i / WORD_BITS] |= bit(i);
 			}
 		}
 	}
@@ -244,22 +460,19 @@ public:
 		index.resize(size_);
 		head.clear();
 
+		std::vector<WordType> heads(wordCount(size_), 0);
 		for (size_t i = 0; i < size_; ++i)
 		{
-			size_t j = 0;
-			while ((j < head.size()) && !this->sym(i, head[j]))
-			{
-				++j;
-			}
-
-			if (j < head.size())
-			{
-				index[i] = j;
+			size_t j = this->findSymmetric(i, heads);
+			if (j < size_)
+			{	// heads are sorted as they are added in the ascending order
+				index[i] = std::lower_bound(head.begin(), head.end(), j) - head.begin();
 			}
 			else
 			{
 				index[i] = head.size();
 				head.push_back(i);
+				heads[i / WORD_BITS] |= bit(i);
 			}
 		}
 	}
@@ -269,26 +482,118 @@ public:
 	{
 		assert(size_ == rhs.size_);
 
+		const size_t usedWords = wordCount(size_);
 		for (size_t i = 0; i < size_; ++i)
 		{
-			for (size_t j = 0; j < size_; ++j)
+			WordType* dst = this->rowData(i);
+			const WordType* src = rhs.rowData(i);
+			for (size_t w = 0; w < usedWords; ++w)
 			{
-				this->set(i, j, this->get(i, j) && rhs.get(i,j));
+				dst[w] &= src[w];
 			}
 		}
 
 		return *this;
 	}
 
-	// transposition
+	// or composition
+	BinaryRelation& operator|=(const BinaryRelation& rhs)
+	{
+		assert(size_ == rhs.size_);
+
+		const size_t usedWords = wordCount(size_);
+		for (size_t i = 0; i < size_; ++i)
+		{
+			WordType* dst = this->rowData(i);
+			const WordType* src = rhs.rowData(i);
+			for (size_t w = 0; w < usedWords; ++w)
+			{
+				dst[w] |= src[w];
+			}
+		}
+
+		return *this;
+	}
+
+	// transposition (by blocks of 64x64 bits)
 	BinaryRelation& transposed(BinaryRelation& dst) const
 	{
+		assert(&dst != this);
+
 		dst.resize(size_);
-		for (size_t i = 0; i < size_; ++i)
+
+		const size_t blocks = wordCount(size_);
+		WordType block[WORD_BITS];
+		for (size_t bi = 0; bi < blocks; ++bi)
+		{	// rows bi*64 .. bi*64 + 63
+			for (size_t bj = 0; bj < blocks; ++bj)
+			{	// columns bj*64 .. bj*64 + 63
+				WordType any = 0;
+				for (size_t k = 0; k < WORD_BITS; ++k)
+				{
+					size_t r = bi*WORD_BITS + k;
+					block[k] = (r < size_) ? this->rowData(r)[bj] : 0;
+					any |= block[k];
+				}
+
+				if (any)
+				{
+					transposeBlock(block);
+				}
+
+				for (size_t k = 0; (k < WORD_BITS) && (bj*WORD_BITS + k < size_); ++k)
+				{
+					dst.rowData(bj*WORD_BITS + k)[bi] = block[k];
+				}
+			}
+		}
+
+		return dst;
+	}
+
+	/**
+	 * @brief  Restricts the relation to a subset of elements
+	 *
+	 * Creates in @p dst the relation over elements from 0 to
+	 * @p elems.size() - 1 where the i-th element stands for the element
+	 * @p elems[i] of @p *this.
+	 *
+	 * @param[in]   elems  Distinct elements of the relation
+	 * @param[out]  dst    The restricted relation
+	 */
+	BinaryRelation& restricted(
+		const std::vector<size_t>&    elems,
+		BinaryRelation&               dst) const
+	{
+		assert(&dst != this);
+
+		const size_t NO_POSITION = static_cast<size_t>(-1);
+
+		std::vector<size_t> position(size_, NO_POSITION);
+		for (size_t i = 0; i < elems.size(); ++i)
 		{
-			for (size_t j = 0; j < size_; ++j)
+			assert(elems[i] < size_);
+			assert(NO_POSITION == position[elems[i]]);
+
+			position[elems[i]] = i;
+		}
+
+		dst.resize(0);
+		dst.resize(elems.size());
+
+		for (size_t i = 0; i < elems.size(); ++i)
+		{
+			const WordType* words = this->rowData(elems[i]);
+			for (size_t w = 0; w < wordCount(size_); ++w)
 			{
-				dst.set(j, i, this->get(i, j));
+				for (WordType word = words[w]; word; word &= word - 1)
+				{
+					size_t j = position[w*WORD_BITS + __builtin_ctzll(word)];
+					if (NO_POSITION != j)
+					{
+						dst.set(i, j, true);
+					}
+				}
 			}
 		}
 
@@ -310,23 +615,9 @@ public:
 	{
 		dst.resize(size_);
 
-		auto rowStart = data_.begin();
-		auto src = rowStart;
-		auto end = src + size_*rowSize_;
-		auto dstIter = dst.begin();
-
-		for (; src != end; src = rowStart, ++dstIter)
+		for (size_t i = 0; i < size_; ++i)
 		{
-			auto rowEnd = src + size_;
-			rowStart = src + rowSize_;
-
-			for (size_t i = 0; src != rowEnd; ++src, ++i)
-			{
-				if (*src)
-				{
-					dstIter->push_back(i);
-				}
-			}
+			this->appendRow(i, dst[i]);
 		}
 	}
 
@@ -342,18 +633,9 @@ public:
 	 */
 	void buildInvIndex(IndexType& dst) const
 	{
-		dst.resize(size_);
+		BinaryRelation inverse(0, false, rowSize_);
 
-		for (size_t i = 0; i < size_; ++i)
-		{
-			for (size_t j = 0; j < size_; ++j)
-			{
-				if (this->get(i, j))
-				{
-					dst[j].push_back(i);
-				}
-			}
-		}
+		this->transposed(inverse).buildIndex(dst);
 	}
 
 	/**
@@ -369,20 +651,8 @@ public:
 	 */
 	void buildIndex(IndexType& ind, IndexType& inv) const
 	{
-		ind.resize(size_);
-		inv.resize(size_);
-
-		for (size_t i = 0; i < size_; ++i)
-		{
-			for (size_t j = 0; j < size_; ++j)
-			{
-				if (this->get(i, j))
-				{
-					ind[i].push_back(j);
-					inv[j].push_back(i);
-				}
-			}
-		}
+		this->buildIndex(ind);
+		this->buildInvIndex(inv);
 	}
 
 	/**
@@ -390,15 +660,9 @@ public:
 	 */
 	void RestrictToSymmetric()
 	{
-		for (size_t row = 0; row < this->size(); ++row)
-		{
-			for (size_t col = row + 1; col < this->size(); ++col)
-			{	// traverse the matrix (we do just the part above the diagonal)
-				bool res = this->get(row, col) && this->get(col, row);
-				this->set(row, col, res);
-				this->set(col, row, res);
-			}
-		}
+		BinaryRelation inverse(0, false, rowSize_);
+
+		*this &= this->transposed(inverse);
 	}
 
 
@@ -434,10 +698,20 @@ public:
 			}
 
 			quotProj[row] = row;
-			for (size_t col = row + 1; col < this->size(); ++col)
+
+			const WordType* words = this->rowData(row);
+			const size_t first = row + 1;
+			for (size_t w = first / WORD_BITS; w < wordCount(size_); ++w)
 			{
-				if (this->get(row, col))
+				WordType word = words[w];
+				if (w == first / WORD_BITS)
+				{	// skip columns up to the diagonal
+					word &= ~WordType(0) << (first % WORD_BITS);
+				}
+
+				for ( ; word; word &= word - 1)
 				{	// if 'col' is equivalent (w.r.t. the relation) to 'row'
+					size_t col = w*WORD_BITS + __builtin_ctzll(word);
 					assert(UNDEF_PROJ == quotProj[col]);
 
 					quotProj[col] = row;
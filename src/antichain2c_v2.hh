@@ -11,9 +11,13 @@
 #ifndef _VATA_ANTICHAIN_2C_V2_HH_
 #define _VATA_ANTICHAIN_2C_V2_HH_
 
+#include <algorithm>
+#include <cstdint>
+#include <functional>
 #include <ostream>
 #include <list>
 #include <unordered_map>
+#include <vector>
 
 #include <vata/util/convert.hh>
 
@@ -45,6 +49,12 @@ namespace VATA
  * a simulation) and the order is the set inclusion relation (or set inclusion
  * enhanced by simulation).
  *
+ * Optionally, the antichain keeps a @e signature of every element of T (see
+ * Signature), which is a necessary condition of the partial order computed
+ * by bitwise operations. Signatures of elements with the same key are stored
+ * in a contiguous array, so contains() and refine() skip most of the
+ * incomparable elements without calling the (expensive) comparison.
+ *
  * @tparam  Key  The first domain
  * @tparam  T    The second domain
  */
@@ -58,6 +68,71 @@ public:
 	typedef std::list<T> TList;
 	typedef std::unordered_map<Key, TList> KeyToTListMap;
 
+	/**
+	 * @brief  Number of words of a set of bits of a signature
+	 *
+	 * Macrostates have often more than 64 states, so one word would be
+	 * mostly full.
+	 */
+	static const size_t SIGNATURE_WORDS = 4;
+
+	/**
+	 * @brief  Set of bits of states, a state sets the bit given by its
+	 *         number modulo the number of bits
+	 */
+	struct Bits
+	{
+		uint64_t words[SIGNATURE_WORDS];
+
+		void clear()
+		{
+			std::fill(words, words + SIGNATURE_WORDS, 0);
+		}
+
+		void set(size_t state)
+		{
+			words[(state / 64) % SIGNATURE_WORDS] |= static_cast<uint64_t>(1) << (state % 64);
+		}
+
+		void add(const Bits& rhs)
+		{
+			for (size_t i = 0; i < SIGNATURE_WORDS; ++i)
+			{
+				words[i] |= rhs.words[i];
+			}
+		}
+
+		bool isSubsetOf(const Bits& rhs) const
+		{
+			for (size_t i = 0; i < SIGNATURE_WORDS; ++i)
+			{
+				if (words[i] & ~rhs.words[i])
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+	};
+
+	/**
+	 * @brief  Signature of an element of T
+	 *
+	 * For an element P (a set of states), @p states has the bits of states
+	 * of P set and @p down has the bits of states that are smaller than some
+	 * state of P set. As P <= Q implies that every state of P is smaller than
+	 * some state of Q, P <= Q can hold only if the bits of P.states are
+	 * contained in Q.down.
+	 */
+	struct Signature
+	{
+		Bits states;
+		Bits down;
+	};
+
+	typedef std::function<void(const T&, Signature&)> SignatureFunc;
+
 protected:
 
 	/**
@@ -68,10 +143,61 @@ protected:
 		void operator()(const Key&, const typename TList::iterator&) const {}
 	};
 
+private:
+
+	/**
+	 * @brief  Signature of an element stored in a list of the antichain
+	 */
+	struct IndexEntry
+	{
+		Signature sig;
+		typename TList::iterator elem;
+	};
+
+	typedef std::vector<IndexEntry> IndexList;
+	typedef std::unordered_map<Key, IndexList> KeyToIndexListMap;
+
+	// positions of entries of elements (given by their addresses) in the index
+	typedef std::unordered_map<const T*, size_t> ElemToSlotMap;
+
 private:
 
 	KeyToTListMap data_;
 
+	// computes signatures, the index is not used when it is empty
+	SignatureFunc signature_;
+	KeyToIndexListMap index_;
+	ElemToSlotMap slots_;
+
+	// removes the entry of the element from the index, the last entry of the
+	// key takes its slot
+	void removeFromIndex(const Key& q, const typename TList::iterator& Q)
+	{
+		auto iter = index_.find(q);
+		assert(index_.end() != iter);
+
+		auto slotIter = slots_.find(&*Q);
+		assert(slots_.end() != slotIter);
+
+		IndexList& entries = iter->second;
+		const size_t slot = slotIter->second;
+		assert(slot < entries.size() && entries[slot].elem == Q);
+
+		slots_.erase(slotIter);
+		if (slot + 1 != entries.size())
+		{
+			entries[slot] = entries.back();
+			slots_[&*entries[slot].elem] = slot;
+		}
+
+		entries.pop_back();
+
+		if (entries.empty())
+		{
+			index_.erase(iter);
+		}
+	}
+
 protected:
 
 	/**
@@ -105,7 +231,26 @@ public:
 	 *
 	 * Default constructor.
 	 */
-	Antichain2Cv2() : data_() {}
+	Antichain2Cv2() : data_(), signature_(), index_(), slots_() {}
+
+
+	/**
+	 * @brief  Sets the function computing signatures of elements
+	 *
+	 * Sets the function computing signatures of elements of T and starts to
+	 * use the index of signatures. The antichain has to be empty.
+	 *
+	 * @param[in]  signature  The function computing signatures consistent
+	 *                        with the '<=' relation used by contains() and
+	 *                        refine()
+	 */
+	void setSignature(
+		const SignatureFunc&          signature)
+	{
+		assert(data_.empty());
+
+		signature_ = signature;
+	}
 
 
 	/**
@@ -119,6 +264,9 @@ public:
 		Antichain2Cv2&                rhs)
 	{
 		std::swap(data_, rhs.data_);
+		std::swap(signature_, rhs.signature_);
+		std::swap(index_, rhs.index_);
+		std::swap(slots_, rhs.slots_);
 	}
 
 
@@ -167,6 +315,31 @@ public:
 		const T&                     Q,
 		const Cmp&                   cmp) const
 	{
+		if (signature_)
+		{	// only elements P with signature allowing P <= Q are compared
+			Signature sig;
+			signature_(Q, sig);
+
+			for (const Key& p : candidates)
+			{
+				auto iter = index_.find(p);
+				if (index_.end() == iter)
+				{
+					continue;
+				}
+
+				for (const IndexEntry& entry : iter->second)
+				{
+					if (entry.sig.states.isSubsetOf(sig.down) && cmp(*entry.elem, Q))
+					{
+						return true;
+					}
+				}
+			}
+
+			return false;
+		}
+
 		for (const Key& p : candidates)
 		{	// check all candidates for 'p'
 			auto iter = data_.find(p);
@@ -212,6 +385,56 @@ public:
 		const Cmp&           cmp,
 		const Eraser&        eraser = DummyEraser())
 	{
+		if (signature_)
+		{	// only elements P with signature allowing Q <= P are compared
+			Signature sig;
+			signature_(Q, sig);
+
+			for (const Key& p : candidates)
+			{
+				auto iter = index_.find(p);
+				if (index_.end() == iter)
+				{
+					continue;
+				}
+
+				TList& list = data_.find(p)->second;
+				IndexList& entries = iter->second;
+
+				// the kept entries are moved to the front of the array
+				size_t kept = 0;
+				for (size_t slot = 0; slot < entries.size(); ++slot)
+				{
+					IndexEntry& entry = entries[slot];
+					if (sig.states.isSubsetOf(entry.sig.down) && cmp(*entry.elem, Q))
+					{	// if Q <= P, erase (p, P) from the antichain
+						eraser(p, entry.elem);
+						slots_.erase(&*entry.elem);
+						list.erase(entry.elem);
+					}
+					else
+					{
+						if (kept != slot)
+						{
+							entries[kept] = entry;
+							slots_[&*entry.elem] = kept;
+						}
+
+						++kept;
+					}
+				}
+				entries.erase(entries.begin() + kept, entries.end());
+
+				if (entries.empty())
+				{	// in case there is no (p, _) left, remove 'p'
+					index_.erase(iter);
+					data_.erase(p);
+				}
+			}
+
+			return;
+		}
+
 		for (const Key& p : candidates)
 		{	// check all candidates for 'p'
 			auto iter = data_.find(p);
@@ -258,7 +481,19 @@ public:
 	{
 		TList& list = data_.insert(std::make_pair(q, TList())).first->second;
 
-		return list.insert(list.end(), Q);
+		auto iter = list.insert(list.end(), Q);
+		if (signature_)
+		{
+			Signature sig;
+			signature_(Q, sig);
+
+			IndexEntry entry = {sig, iter};
+			IndexList& entries = index_[q];
+			slots_[&*iter] = entries.size();
+			entries.push_back(entry);
+		}
+
+		return iter;
 	}
 
 
@@ -294,6 +529,11 @@ public:
 		assert(!iter->second.empty());
 		Q = iter->second.front();
 
+		if (signature_)
+		{
+			removeFromIndex(q, iter->second.begin());
+		}
+
 		iter->second.pop_front();
 
 		if (iter->second.empty())
@@ -321,6 +561,11 @@ public:
 		assert(data_.end() != iter);
 		assert(Antichain2Cv2::checkIteratorPresence(iter->second, Q));
 
+		if (signature_)
+		{
+			removeFromIndex(q, Q);
+		}
+
 		iter->second.erase(Q);
 
 		if (iter->second.empty())
@@ -330,6 +575,54 @@ public:
 	}
 
 
+	/**
+	 * @brief  Removes all pairs satisfying a predicate from the antichain
+	 *
+	 * This method removes all pairs '(q, Q)' such that @p pred(q, Q) holds.
+	 * The antichain stays an antichain (removal keeps its elements pairwise
+	 * incomparable).
+	 *
+	 * @param[in]  pred  The predicate on pairs
+	 *
+	 * @returns  The number of removed pairs
+	 */
+	template <class Pred>
+	size_t removeIf(const Pred& pred)
+	{
+		size_t removed = 0;
+
+		for (auto iter = data_.begin(); iter != data_.end(); )
+		{
+			for (auto jter = iter->second.begin(); jter != iter->second.end(); )
+			{
+				auto kter = jter++;
+
+				if (pred(iter->first, *kter))
+				{
+					if (signature_)
+					{
+						removeFromIndex(iter->first, kter);
+					}
+
+					iter->second.erase(kter);
+					++removed;
+				}
+			}
+
+			if (iter->second.empty())
+			{	// in case there is no (q, _) left, remove 'q'
+				iter = data_.erase(iter);
+			}
+			else
+			{
+				++iter;
+			}
+		}
+
+		return removed;
+	}
+
+
 	/**
 	 * @brief  Retrieves the data of the antichain
 	 *
@@ -371,6 +664,8 @@ public:
 	void clear()
 	{
 		this->data_.clear();
+		this->index_.clear();
+		this->slots_.clear();
 	}
 
 
@@ -417,4 +712,7 @@ public:
 	}
 };
 
+template <typename Key, typename T>
+const size_t VATA::Util::Antichain2Cv2<Key, T>::SIGNATURE_WORDS;
+
 #endif
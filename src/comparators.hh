@@ -89,12 +89,9 @@ public: // public methods
 		candidates.push_back(state);
 	}
 
-	inline bool checkSmallerInBigger(const StateType& /*smaller*/, const StateSet& /*biggerSet*/)
+	inline bool checkSmallerInBigger(const StateType& smaller, const StateSet& biggerSet)
 	{
-		// something should be implemented here?
-		assert(false);
-
-		return false;
+		return biggerSet.count(smaller) > 0;
 	}
 };
 
@@ -16,7 +16,7 @@
 #include <vata/vata.hh>
 
 // Standard library headers
-#include <vector>
+#include <deque>
 
 namespace VATA {
 	template <class StateSet, class ProductState>
@@ -28,53 +28,82 @@ namespace VATA {
 }
 
 /*
- * Cache for caching macro state
+ * Set of product states (pairs of pointers to cached macrostates).
+ * It is backed by a deque, so adding product states to the end and
+ * removing them from the both ends takes constant time and the product
+ * states can be still accessed by their index. Pointers to macrostates
+ * are handed out instead of copies of macrostates.
  */
 GCC_DIAG_OFF(effc++)
 template<class StateSet,class ProductState>
-class VATA::ProductStateSet : public std::vector<ProductState>
+class VATA::ProductStateSet : public std::deque<ProductState>
 {
 GCC_DIAG_ON(effc++)
-private: //data types
-	typedef StateSet SmallerElementType;
-	typedef StateSet BiggerElementType;
+protected: //data types
+	typedef typename ProductState::first_type SmallerElementType;
+	typedef typename ProductState::second_type BiggerElementType;
 
 public:
-		bool get(SmallerElementType& smaller, BiggerElementType& bigger) {
-			if (this->size() == 0) {
-				return false;
-			}
-
-			auto& nextPair = this->back();
-			smaller = *nextPair.first;
-			bigger = *nextPair.second;
-			this->pop_back();
+	typedef StateSet MacroState;
 
-			return true;
+		void add(StateSet& smaller, StateSet& bigger) {
+			this->push_back(std::make_pair(&smaller,&bigger));
 		}
 };
 
+/*
+ * Product states are processed in the first in, first out order
+ */
 GCC_DIAG_OFF(effc++)
 template<class StateSet,class ProductState>
 class VATA::ProductStateSetBreadth :
 	public VATA::ProductStateSet<StateSet,ProductState>
 {
 GCC_DIAG_ON(effc++)
+		typedef VATA::ProductStateSet<StateSet,ProductState> Base;
+
 		public:
-			void add(StateSet& smaller, StateSet& bigger) {
-				this->insert(this->begin(),std::make_pair(&smaller,&bigger));
+			static const bool BREADTH_FIRST = true;
+
+			bool get(typename Base::SmallerElementType& smaller,
+					typename Base::BiggerElementType& bigger) {
+				if (this->empty()) {
+					return false;
+				}
+
+				smaller = this->front().first;
+				bigger = this->front().second;
+				this->pop_front();
+
+				return true;
 			}
 };
 
+/*
+ * Product states are processed in the last in, first out order
+ */
 GCC_DIAG_OFF(effc++)
 template<class StateSet,class ProductState>
 class VATA::ProductStateSetDepth :
 	public VATA::ProductStateSet<StateSet,ProductState>
 {
 GCC_DIAG_ON(effc++)
+		typedef VATA::ProductStateSet<StateSet,ProductState> Base;
+
 		public:
-			void add(StateSet& smaller, StateSet& bigger) {
-				this->push_back(std::make_pair(&smaller,&bigger));
+			static const bool BREADTH_FIRST = false;
+
+			bool get(typename Base::SmallerElementType& smaller,
+					typename Base::BiggerElementType& bigger) {
+				if (this->empty()) {
+					return false;
+				}
+
+				smaller = this->back().first;
+				bigger = this->back().second;
+				this->pop_back();
+
+				return true;
 			}
 };
 
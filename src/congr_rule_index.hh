@@ -0,0 +1,190 @@
+/*****************************************************************************
+ *	VATA Finite Automata Library
+ *
+ *	Copyright (c) 2013	Martin Hruska <xhrusk16@stud.fit.vutbr.cz>
+ *
+ *	Description:
+ *	Header file for index of rules used for computing of congruence
+ *	closure.
+ *
+ *****************************************************************************/
+
+
+#ifndef UTIL_CONGR_RULE_INDEX_
+#define UTIL_CONGR_RULE_INDEX_
+
+// VATA headers
+#include <vata/vata.hh>
+
+// Standard library headers
+#include <vector>
+
+namespace VATA {
+	template <class StateSet> class CongrRuleIndex;
+}
+
+/*
+ * Index of rules of the form premise -> conclusion, where the rule can be
+ * applied to a set when the premise is its subset and then the conclusion
+ * is added to the set. Every rule watches one state of its premise and it
+ * is kept in the list of rules of the watched state. When the watched
+ * state gets into the computed closure, the rule looks for another state
+ * of its premise which is not in the closure and watches it instead; when
+ * there is no such state, the rule is applied. Watches are kept between
+ * computations of closures, so the closure costs time proportional to the
+ * size of the closure and to the number of rules watching its states
+ * instead of to the size of all premises.
+ */
+GCC_DIAG_OFF(effc++)
+template <class StateSet>
+class VATA::CongrRuleIndex {
+GCC_DIAG_ON(effc++)
+public: // data types
+	typedef typename StateSet::value_type StateType;
+	typedef std::vector<StateType> StateVector;
+
+private: // private data types
+	struct Rule {
+		StateVector premise;
+		StateVector conclusion;
+		size_t watch; // position of the watched state in the premise
+		bool active;
+	};
+
+private: // private data members
+	std::vector<Rule> rules_;
+	std::vector<std::vector<size_t>> watchers_; // state -> rules watching it
+	std::vector<size_t> emptyPremises_; // rules applicable to any set
+	StateVector worklist_;
+
+	// States of premises in the actual closure are marked by its number
+	std::vector<size_t> marks_;
+	size_t epoch_; // number of computed closures
+
+	// Try to watch a state of the premise which is not in the closure
+	bool MoveWatch(Rule& rule) {
+		const size_t size = rule.premise.size();
+		for (size_t i = 1; i < size; ++i) {
+			const size_t position = (rule.watch + i) % size;
+			if (marks_[rule.premise[position]] != epoch_) {
+				rule.watch = position;
+				return true;
+			}
+		}
+		return false;
+	}
+
+public:
+	CongrRuleIndex() :
+		rules_(),
+		watchers_(),
+		emptyPremises_(),
+		worklist_(),
+		marks_(),
+		epoch_(0)
+	{}
+
+	/*
+	 * Add a new active rule and return its number
+	 */
+	template<class Premise>
+	size_t AddRule(const Premise& premise, StateVector conclusion) {
+		const size_t number = rules_.size();
+		Rule rule = {StateVector(premise.begin(), premise.end()),
+			std::move(conclusion), 0, true};
+
+		// Any state of the premise can be watched later
+		for (auto& state : rule.premise) {
+			if (watchers_.size() <= state) {
+				watchers_.resize(state + 1);
+				marks_.resize(state + 1, 0);
+			}
+		}
+
+		if (rule.premise.empty()) {
+			emptyPremises_.push_back(number);
+		}
+		else {
+			watchers_[rule.premise.front()].push_back(number);
+		}
+		rules_.push_back(std::move(rule));
+		return number;
+	}
+
+	/*
+	 * Inactive rules are not applied
+	 */
+	void SetActive(size_t rule, bool active) {
+		rules_[rule].active = active;
+	}
+
+	/*
+	 * Compute closure of the given set
+	 * @param set Set where congr closure is stored
+	 * @param congrMapManipulator Checks on the fly after every applied rule
+	 * whether the computation should continue
+	 * @return true when the computation has been stopped by the manipulator
+	 */
+	template<class CongrMapManipulator>
+	bool GetClosure(StateSet& set, CongrMapManipulator& congrMapManipulator) {
+		++epoch_;
+		worklist_.assign(set.begin(), set.end());
+		for (auto& state : worklist_) {
+			if (state < marks_.size()) {
+				marks_[state] = epoch_;
+			}
+		}
+
+		auto applyRule = [this, &set](const Rule& rule) {
+			for (auto& state : rule.conclusion) {
+				if (set.insert(state).second) {
+					worklist_.push_back(state);
+					if (state < marks_.size()) {
+						marks_[state] = epoch_;
+					}
+				}
+			}
+		};
+
+		for (size_t number : emptyPremises_) {
+			if (rules_[number].active) {
+				applyRule(rules_[number]);
+				if (!congrMapManipulator(set)) {
+					return true;
+				}
+			}
+		}
+
+		while (!worklist_.empty()) {
+			const StateType state = worklist_.back();
+			worklist_.pop_back();
+			if (watchers_.size() <= state) {
+				continue;
+			}
+
+			std::vector<size_t>& watchers = watchers_[state];
+			for (size_t i = 0; i < watchers.size(); ) {
+				Rule& rule = rules_[watchers[i]];
+				if (!rule.active) {
+					++i;
+					continue;
+				}
+				if (MoveWatch(rule)) { // premise is not in the closure
+					watchers_[rule.premise[rule.watch]].push_back(watchers[i]);
+					watchers[i] = watchers.back();
+					watchers.pop_back();
+					continue;
+				}
+
+				++i;
+				applyRule(rule);
+				if (!congrMapManipulator(set)) {
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+};
+
+#endif
@@ -14,10 +14,12 @@
 
 // VATA headers
 #include <vata/vata.hh>
+#include <vata/incl_param.hh>
 
 #include "antichain2c_v2.hh"
 #include "util/cache.hh"
 #include "util/cached_binary_op.hh"
+#include "util/macrostate_budget.hh"
 
 namespace VATA
 {
@@ -46,6 +48,8 @@ public:   // data types
 
 	typedef typename BiggerTypeCache::TPtr BiggerType;
 
+	typedef Util::MacrostateBudget<BiggerTypeCache> MacrostateBudget;
+
 	typedef Util::CachedBinaryOp<const StateSet*, const StateSet*, bool> LteCache;
 
 	typedef std::pair<StateType, BiggerType> WorkSetElement;
@@ -153,7 +157,8 @@ public:   // data types
 			}
 			else
 			{
-				return lteCache_.lookup(lhs.get(), rhs.get(), noncachedLte_);
+				return lteCache_.lookup(lhs.get(), rhs.get(), noncachedLte_,
+					lhs->size() * rhs->size());
 			}
 		}
 	};
@@ -260,6 +265,10 @@ private:  // data members
 	const SetComparerSmaller& smallerComparer_;
 	const SetComparerBigger& biggerComparer_;
 
+	MacrostateBudget& budget_;
+
+	CacheStatistics& stats_;
+
 private:  // methods
 
 	bool expand(const StateType& smallerState, const BiggerType& biggerStateSet)
@@ -272,10 +281,12 @@ private:  // methods
 		}
 		else if (isNoninclusionImplied(key))
 		{	// in case we know that the inclusion does not hold
+			++stats_.antichains.hits;
 			return false;
 		}
 		else if (isImpliedByChildren(key))
 		{
+			++stats_.antichains.hits;
 			return true;
 		}
 		else if (IsImpliedByPreorder(key))
@@ -283,6 +294,8 @@ private:  // methods
 			return true;
 		}
 
+		++stats_.antichains.misses;
+
 		workset_.insert(key);
 
 		DownwardInclusionFunctor innerFctor(*this);
@@ -318,9 +331,18 @@ private:  // methods
 			processFoundNoninclusion(smallerState, biggerStateSet);
 		}
 
+		enforceMemoryBudget();
+
 		return innerFctor.InclusionHolds();
 	}
 
+	// entries of the antichains are evicted when the macrostates kept alive
+	// only by them do not fit into the memory budget
+	inline void enforceMemoryBudget()
+	{
+		budget_.enforce({&nonIncl_, &childrenCache_});
+	}
+
 	inline void failProcessing()
 	{
 		inclusionHolds_ = false;
@@ -395,7 +417,9 @@ public:   // methods
 		const SetComparerSmaller&  smallerComparer,
 		const SetComparerBigger&   biggerComparer,
 		InclAntichainType&         /* ant */,
-		ConsequentType&            /* cons */) :
+		ConsequentType&            /* cons */,
+		MacrostateBudget&          budget,
+		CacheStatistics&           stats) :
 		smaller_(smaller),
 		bigger_(bigger),
 		biggerTypeCache_(biggerTypeCache),
@@ -408,7 +432,9 @@ public:   // methods
 		preorderSmaller_(preorderSmaller),
 		preorderBigger_(preorderBigger),
 		smallerComparer_(smallerComparer),
-		biggerComparer_(biggerComparer)
+		biggerComparer_(biggerComparer),
+		budget_(budget),
+		stats_(stats)
 	{ }
 
 	DownwardInclusionFunctor(
@@ -425,7 +451,9 @@ public:   // methods
 		preorderSmaller_(downFctor.preorderSmaller_),
 		preorderBigger_(downFctor.preorderBigger_),
 		smallerComparer_(downFctor.smallerComparer_),
-		biggerComparer_(downFctor.biggerComparer_)
+		biggerComparer_(downFctor.biggerComparer_),
+		budget_(downFctor.budget_),
+		stats_(downFctor.stats_)
 	{ }
 
 	inline bool IsImpliedByPreorder(const WorkSetElement& elem) const
@@ -14,9 +14,11 @@
 
 // VATA headers
 #include <vata/vata.hh>
+#include <vata/incl_param.hh>
 
 #include "antichain2c_v2.hh"
 #include "util/cache.hh"
+#include "util/macrostate_budget.hh"
 
 
 namespace VATA
@@ -43,6 +45,8 @@ public:   // data types
 
 	typedef typename BiggerTypeCache::TPtr BiggerType;
 
+	typedef Util::MacrostateBudget<BiggerTypeCache> MacrostateBudget;
+
 	typedef Util::CachedBinaryOp<const StateSet*, const StateSet*, bool> LteCache;
 
 	typedef std::pair<StateType, BiggerType> WorkSetElement;
@@ -152,7 +156,8 @@ public:   // data types
 			}
 			else
 			{
-				return lteCache_.lookup(lhs.get(), rhs.get(), noncachedLte_);
+				return lteCache_.lookup(lhs.get(), rhs.get(), noncachedLte_,
+					lhs->size() * rhs->size());
 			}
 		}
 	};
@@ -260,6 +265,10 @@ private:  // data members
 	const SetComparerSmaller& smallerComparer_;
 	const SetComparerBigger& biggerComparer_;
 
+	MacrostateBudget& budget_;
+
+	CacheStatistics& stats_;
+
 	InclAntichainType& ant_;
 	ConsequentType& cons_;
 
@@ -281,14 +290,17 @@ private:  // methods
 		}
 		else if (isInclusionImplied(key))
 		{	// in case we know that the inclusion does hold
+			++stats_.antichains.hits;
 			return std::make_tuple(true, InclAntichainType(), ConsequentType());
 		}
 		else if (isNoninclusionImplied(key))
 		{	// in case we know that the inclusion does not hold
+			++stats_.antichains.hits;
 			return std::make_tuple(false, InclAntichainType(), ConsequentType());
 		}
 		else if (isImpliedByChildren(key))
 		{
+			++stats_.antichains.hits;
 			return std::make_tuple(true, InclAntichainType(), ConsequentType());
 		}
 		else if (IsImpliedByPreorder(key))
@@ -296,6 +308,8 @@ private:  // methods
 			return std::make_tuple(true, InclAntichainType(), ConsequentType());
 		}
 
+		++stats_.antichains.misses;
+
 		workset_.insert(key);
 
 		InclAntichainType antecedent;
@@ -344,9 +358,18 @@ private:  // methods
 			consequent.clear();
 		}
 
+		enforceMemoryBudget();
+
 		return std::make_tuple(innerFctor.InclusionHolds(), antecedent, consequent);
 	}
 
+	// entries of the antichains are evicted when the macrostates kept alive
+	// only by them do not fit into the memory budget
+	inline void enforceMemoryBudget()
+	{
+		budget_.enforce({&incl_, &nonIncl_, &childrenCache_});
+	}
+
 	inline void failProcessing()
 	{
 		inclusionHolds_ = false;
@@ -440,7 +463,9 @@ public:   // methods
 		const SetComparerSmaller&       smallerComparer,
 		const SetComparerBigger&        biggerComparer,
 		InclAntichainType&              ant,
-		ConsequentType&                 cons) :
+		ConsequentType&                 cons,
+		MacrostateBudget&               budget,
+		CacheStatistics&                stats) :
 		smaller_(smaller),
 		bigger_(bigger),
 		biggerTypeCache_(biggerTypeCache),
@@ -455,6 +480,8 @@ public:   // methods
 		preorderBigger_(preorderBigger),
 		smallerComparer_(smallerComparer),
 		biggerComparer_(biggerComparer),
+		budget_(budget),
+		stats_(stats),
 		ant_(ant),
 		cons_(cons)
 	{ }
@@ -476,6 +503,8 @@ public:   // methods
 		preorderBigger_(downFctor.preorderBigger_),
 		smallerComparer_(downFctor.smallerComparer_),
 		biggerComparer_(downFctor.biggerComparer_),
+		budget_(downFctor.budget_),
+		stats_(downFctor.stats_),
 		ant_(ant),
 		cons_(cons)
 	{ }
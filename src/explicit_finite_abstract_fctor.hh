@@ -15,9 +15,16 @@
 
 // VATA headers
 #include <vata/vata.hh>
+#include <vata/notimpl_except.hh>
 
 #include "antichain1c.hh"
 #include "explicit_finite_aut_core.hh"
+#include "explicit_finite_frozen.hh"
+#include "sorted_state_set.hh"
+#include "util/worker_pool.hh"
+
+// Standard library headers
+#include <vector>
 
 namespace VATA {
 	template <class Rel> class ExplicitFAAbstractFunctor;
@@ -30,23 +37,107 @@ class VATA::ExplicitFAAbstractFunctor {
 GCC_DIAG_ON(effc++)
 public: // data types
 	typedef VATA::ExplicitFiniteAutCore ExplicitFA;
+	typedef VATA::ExplicitFAFrozen FrozenFA;
 
 	typedef typename ExplicitFA::StateType StateType;
 	typedef typename ExplicitFA::StateSet StateSet;
 	typedef typename ExplicitFA::SymbolType SymbolType;
+	typedef typename ExplicitFA::Word Word;
 
 	// Define single antichain
 	typedef VATA::Util::Antichain1C<StateType> Antichain1Type;
 
 	typedef typename Rel::IndexType IndexType;
 
+	typedef VATA::Util::WorkerPool WorkerPool;
+
 protected: // data memebers
 
 	bool inclNotHold_;
 
+private: // buffers for computing posts for all symbols
+
+	typedef std::vector<StateType> StateVector;
+
+	struct PostBuffers {
+		std::vector<StateVector> smallerPosts; // symbol -> successors
+		std::vector<StateVector> biggerPosts; // symbol -> successors
+		std::vector<bool> symbolUsed; // symbol -> has successors
+		std::vector<SymbolType> usedSymbols; // in order of the first use
+
+		PostBuffers() :
+			smallerPosts(),
+			biggerPosts(),
+			symbolUsed(),
+			usedSymbols()
+		{}
+	};
+
+	PostBuffers buffers_;
+	std::vector<PostBuffers> workerBuffers_; // for parallel computation
+
+	/*
+	 * Scatter successors of all states of the macrostate to the buffers
+	 * of their symbols
+	 */
+	template<class MacroState>
+	void ScatterPost(const MacroState& macroState, const FrozenFA& macroFA,
+			PostBuffers& buffers, std::vector<StateVector>& posts) {
+		for (const StateType& stateInMacro : macroState) {
+			const size_t rowEnd = macroFA.RowEnd(stateInMacro);
+			for (size_t entry = macroFA.RowBegin(stateInMacro); entry < rowEnd; ++entry) {
+				const SymbolType& symbol = macroFA.GetSymbol(entry);
+				if (buffers.symbolUsed.size() <= symbol) {
+					buffers.symbolUsed.resize(symbol + 1, false);
+					buffers.smallerPosts.resize(symbol + 1);
+					buffers.biggerPosts.resize(symbol + 1);
+				}
+				if (!buffers.symbolUsed[symbol]) {
+					buffers.symbolUsed[symbol] = true;
+					buffers.usedSymbols.push_back(symbol);
+				}
+
+				auto successors = macroFA.GetSuccessors(entry);
+				posts[symbol].insert(posts[symbol].end(), successors.begin(), successors.end());
+			}
+		}
+	}
+
+	/*
+	 * Move successors from the buffer to the new macrostate
+	 * @Return True if created macrostates is final
+	 */
+	bool GatherPost(StateSet& newMacroState, StateVector& post, const FrozenFA& macroFA) {
+		bool res = false;
+		for (const StateType& s : post) {
+			if (newMacroState.insert(s).second) {
+				res |= macroFA.IsStateFinal(s);
+			}
+		}
+		post.clear();
+		return res;
+	}
+
+	// Sorted macrostate is created from the whole buffer at once
+	bool GatherPost(SortedStateSet<StateType>& newMacroState, StateVector& post,
+			const FrozenFA& macroFA) {
+		newMacroState = SortedStateSet<StateType>(post);
+		post.clear();
+
+		bool res = false;
+		for (const StateType& s : newMacroState) {
+			res |= macroFA.IsStateFinal(s);
+		}
+		return res;
+	}
+
 public:
 
-	ExplicitFAAbstractFunctor() : inclNotHold_(false) {}
+	ExplicitFAAbstractFunctor() :
+		inclNotHold_(false),
+		buffers_(),
+		workerBuffers_()
+	{}
 
 protected:
 
@@ -58,28 +149,15 @@ protected:
 	 */
 	bool CreatePostOfMacroState(StateSet& newMacroState,
 			const StateSet& procMacroState, const SymbolType& symbol,
-			const ExplicitFA& macroFA) {
+			const FrozenFA& macroFA) {
 
 		bool res = false;
 		// Create new macro state from current macro state for given symbol
 		for (const StateType& stateInMacro : procMacroState) {
 
-			// Find transition for given state
-			auto iteratorTransForState = macroFA.transitions_->find(stateInMacro);
-			if (iteratorTransForState == macroFA.transitions_->end()) {
-				continue;
-			}
-			auto transForState = iteratorTransForState->second;
-
-			// States for given symbol
-			auto symbolToStateSet = transForState->find(symbol);
-			if (symbolToStateSet == transForState->end()) {
-				continue;
-			}
-
 			// The states are added to created macostate and at the
 			// same time is checked	 whether they are final or not
-			for (auto& s : symbolToStateSet->second) {
+			for (auto& s : macroFA.GetSuccessors(stateInMacro,symbol)) {
 				newMacroState.insert(s);
 				res |= macroFA.IsStateFinal(s);
 			}
@@ -93,26 +171,12 @@ protected:
 	 */
 	bool CreatePostOfMacroStateWithSum(StateSet& newMacroState,
 			const StateSet& procMacroState, const SymbolType& symbol,
-			const ExplicitFA& macroFA, size_t& sum) {
+			const FrozenFA& macroFA, size_t& sum) {
 
 		bool res = false;
 		// Create new macro state from current macro state for given symbol
 		for (const StateType& stateInMacro : procMacroState) {
-
-			// Find transition for given state
-			auto iteratorTransForState = macroFA.transitions_->find(stateInMacro);
-			if (iteratorTransForState == macroFA.transitions_->end()) {
-				continue;
-			}
-			auto transForState = iteratorTransForState->second;
-
-			// States for given symbol
-			auto symbolToStateSet = transForState->find(symbol);
-			if (symbolToStateSet == transForState->end()) {
-				continue;
-			}
-
-			for (auto& s : symbolToStateSet->second) {
+			for (auto& s : macroFA.GetSuccessors(stateInMacro,symbol)) {
 				newMacroState.insert(s);
 				sum += s;
 				res |= macroFA.IsStateFinal(s);
@@ -121,6 +185,103 @@ protected:
 		return res;
 	}
 
+	/*
+	 * Create post macrostates of the both macrostates for all symbols
+	 * with a transition from some of them. Transitions of each macrostate
+	 * are walked only once, successors are scattered to buffers of symbols
+	 * which are reused by all calls. Symbols are processed in order of their
+	 * first occurrence in smaller and then in bigger macrostate.
+	 * @param postFunc Called for each symbol as postFunc(symbol, newSmaller,
+	 * newSmallerAccept, newBigger, newBiggerAccept), computation stops
+	 * when it returns false
+	 */
+	template<class MacroState, class PostFunc>
+	void CreatePostsOfMacroStates(
+			const MacroState& smaller, const FrozenFA& smallerFA,
+			const MacroState& bigger, const FrozenFA& biggerFA,
+			PostFunc postFunc) {
+		CreatePostsOfMacroStates(smaller, smallerFA, bigger, biggerFA,
+			buffers_, postFunc);
+	}
+
+	template<class MacroState, class PostFunc>
+	void CreatePostsOfMacroStates(
+			const MacroState& smaller, const FrozenFA& smallerFA,
+			const MacroState& bigger, const FrozenFA& biggerFA,
+			PostBuffers& buffers, PostFunc postFunc) {
+
+		ScatterPost(smaller, smallerFA, buffers, buffers.smallerPosts);
+		ScatterPost(bigger, biggerFA, buffers, buffers.biggerPosts);
+
+		bool cont = true;
+		for (const SymbolType& symbol : buffers.usedSymbols) {
+			if (cont) {
+				MacroState newSmaller;
+				MacroState newBigger;
+				bool newSmallerAccept = GatherPost(newSmaller,
+					buffers.smallerPosts[symbol], smallerFA);
+				bool newBiggerAccept = GatherPost(newBigger,
+					buffers.biggerPosts[symbol], biggerFA);
+				cont = postFunc(symbol, newSmaller, newSmallerAccept,
+					newBigger, newBiggerAccept);
+			}
+			else { // just clean the buffers
+				buffers.smallerPosts[symbol].clear();
+				buffers.biggerPosts[symbol].clear();
+			}
+			buffers.symbolUsed[symbol] = false;
+		}
+		buffers.usedSymbols.clear();
+	}
+
+	/*
+	 * Create post macrostates of the given pairs of macrostates in parallel,
+	 * every worker has its own buffers. The posts are then passed to
+	 * postFunc(index of pair, symbol, newSmaller, newSmallerAccept, newBigger,
+	 * newBiggerAccept) sequentially in the order of pairs and symbols, so
+	 * the result does not depend on the number of workers. Processing stops
+	 * when postFunc returns false.
+	 */
+	template<class MacroState, class PostFunc>
+	void CreatePostsOfMacroStatesParallel(
+			const std::vector<std::pair<const MacroState*,const MacroState*>>& pairs,
+			const FrozenFA& smallerFA, const FrozenFA& biggerFA,
+			WorkerPool& pool, PostFunc postFunc) {
+
+		struct Post {
+			SymbolType symbol;
+			MacroState smaller;
+			bool smallerAccept;
+			MacroState bigger;
+			bool biggerAccept;
+		};
+		std::vector<std::vector<Post>> posts(pairs.size());
+
+		workerBuffers_.resize(pool.size());
+		pool.run(pairs.size(), [&](size_t worker, size_t i) {
+			auto storePost = [&posts, i](const SymbolType& symbol,
+					MacroState& newSmaller, bool newSmallerAccept,
+					MacroState& newBigger, bool newBiggerAccept) -> bool {
+				Post post = {symbol, std::move(newSmaller), newSmallerAccept,
+					std::move(newBigger), newBiggerAccept};
+				posts[i].push_back(std::move(post));
+				return newSmallerAccept == newBiggerAccept;
+			};
+
+			CreatePostsOfMacroStates(*pairs[i].first, smallerFA,
+				*pairs[i].second, biggerFA, workerBuffers_[worker], storePost);
+		});
+
+		for (size_t i = 0; i < pairs.size(); ++i) {
+			for (Post& post : posts[i]) {
+				if (!postFunc(i, post.symbol, post.smaller, post.smallerAccept,
+						post.bigger, post.biggerAccept)) {
+					return;
+				}
+			}
+		}
+	}
+
 	/*
 	 * Just print a macrostate
 	 */
@@ -139,6 +300,15 @@ public: // Public inline functions
 		return !inclNotHold_;
 	}
 
+	/*
+	 * Store a word witnessing that inclusion does not hold,
+	 * it is given only by functors which keep words leading
+	 * to product states
+	 */
+	void GetCounterexample(Word& /* word */) const {
+		throw NotImplementedException(__func__);
+	}
+
 
 };
 
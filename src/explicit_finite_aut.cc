@@ -335,6 +335,19 @@ bool ExplicitFiniteAut::CheckInclusion(
 		*smaller.core_,*bigger.core_,params);
 }
 
+bool ExplicitFiniteAut::CheckInclusion(
+	const ExplicitFiniteAut&    smaller,
+	const ExplicitFiniteAut&    bigger,
+	const InclParam&            params,
+	Word&                       counterexample)
+{
+	assert(nullptr != smaller.core_);
+	assert(nullptr != bigger.core_);
+
+	return CoreAut::CheckInclusion(
+		*smaller.core_,*bigger.core_,params,&counterexample);
+}
+
 ExplicitFiniteAut ExplicitFiniteAut::Reverse(
 		AutBase::StateToStateMap* pTranslMap) const
 {
@@ -343,6 +356,30 @@ ExplicitFiniteAut ExplicitFiniteAut::Reverse(
 	return ExplicitFiniteAut(core_->Reverse(pTranslMap));
 }
 
+bool ExplicitFiniteAut::CheckEquivalence(
+	const ExplicitFiniteAut&    smaller,
+	const ExplicitFiniteAut&    bigger,
+	const VATA::EqParam&        params)
+{
+	assert(nullptr != smaller.core_);
+	assert(nullptr != bigger.core_);
+
+	return CoreAut::CheckEquivalence(*smaller.core_, *bigger.core_, params);
+}
+
+bool ExplicitFiniteAut::CheckEquivalence(
+	const ExplicitFiniteAut&    smaller,
+	const ExplicitFiniteAut&    bigger,
+	const VATA::EqParam&        params,
+	Word&                       counterexample)
+{
+	assert(nullptr != smaller.core_);
+	assert(nullptr != bigger.core_);
+
+	return CoreAut::CheckEquivalence(*smaller.core_, *bigger.core_, params,
+		&counterexample);
+}
+
 AutBase::StateDiscontBinaryRelation ExplicitFiniteAut::ComputeSimulation(
 	const SimParam&             params) const
 {
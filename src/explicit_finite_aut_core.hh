@@ -25,6 +25,7 @@
 namespace VATA
 {
 	class ExplicitFiniteAutCore;
+	class ExplicitFAFrozen;
 }
 
 /*
@@ -45,11 +46,6 @@ GCC_DIAG_ON(effc++)
 		const ExplicitFiniteAutCore &,
 		const Dict &);
 
-	friend bool CheckEquivalence(
-		const ExplicitFiniteAutCore& smaller,
-		const ExplicitFiniteAutCore& bigger,
-		const InclParam& params);
-
 	/*
 	 * Functors for inclusion checking functions
 	 */
@@ -70,7 +66,7 @@ GCC_DIAG_ON(effc++)
 	friend class ExplicitFACongrFunctorOpt;
 	template<class Rel, class ProductSet, class NormalFormRel>
 	friend class ExplicitFACongrFunctorCacheOpt;
-	template<class Rel, class ProductSet>
+	template<class Rel, class ProductSet, class NormalFormRel>
 	friend class ExplicitFACongrEquivFunctor;
 
 	template<class Rel>
@@ -82,17 +78,20 @@ GCC_DIAG_ON(effc++)
 
 	template<class Rel>
 	friend class NormalFormRelPreorder;
-	template<class Rel>
+	template<class Rel, class StateSet>
 	friend class NormalFormRelSimulation;
 
 	template<class Key, class Value>
 	friend class MapToList;
-	template<class Aut>
+
+	friend class ExplicitFAFrozen;
+	template<class Aut, class StateSet>
 	friend class MacroStateCache;
 
 public:
 	using SymbolType               = ExplicitFiniteAut::SymbolType;
 	using SymbolSet                = ExplicitFiniteAut::SymbolSet;
+	using Word                     = ExplicitFiniteAut::Word;
 	using StringSymbolType         = ExplicitFiniteAut::StringSymbolType;
 	using SymbolBackTranslStrict   = ExplicitFiniteAut::SymbolBackTranslStrict;
 
@@ -465,6 +464,12 @@ public: // Public functions
 		return (startStates_.find(state) != startStates_.end());
 	}
 
+	/*
+	 * Creates immutable copy of transitions in compressed
+	 * sparse row order for fast computation of posts.
+	 */
+	ExplicitFAFrozen Freeze() const;
+
 public: // Public setter
 
 	void SetStateStart(
@@ -597,10 +602,18 @@ public:   // methods
 		const ExplicitFiniteAutCore&        rhs,
 		AutBase::ProductTranslMap*          pTranslMap = nullptr);
 
+	// Counterexample is stored only when the pointer is given
 	static bool CheckInclusion(
 		const ExplicitFiniteAutCore&        smaller,
 		const ExplicitFiniteAutCore&        bigger,
-		const InclParam&                    params);
+		const InclParam&                    params,
+		Word*                               counterexample = nullptr);
+
+	static bool CheckEquivalence(
+		const ExplicitFiniteAutCore&        smaller,
+		const ExplicitFiniteAutCore&        bigger,
+		const EqParam&                      params,
+		Word*                               counterexample = nullptr);
 
 	// Checking inclusion
 	template<class Rel, class Functor>
@@ -620,11 +633,15 @@ public:   // methods
 	AutBase::StateDiscontBinaryRelation ComputeSimulation(
 		const SimParam&     params) const;
 
+	AutBase::StateDiscontBinaryRelation ComputeForwardSimulationOfStates(
+		size_t              threads = 1) const;
+
 	AutBase::StateBinaryRelation ComputeForwardSimulation(
 		const SimParam&     params) const;
 
 	AutBase::StateBinaryRelation ComputeForwardSimulation(
-		size_t              size) const;
+		size_t              size,
+		size_t              threads = 1) const;
 
 	template <class Index>
 	AutBase::StateBinaryRelation ComputeForwardSimulation(
@@ -19,14 +19,15 @@
 #include "explicit_finite_aut_core.hh"
 #include "explicit_finite_abstract_fctor.hh"
 #include "macrostate_cache.hh"
-#include "map_to_list.hh"
+#include "product_state_store.hh"
+#include "state_union_find.hh"
 
 namespace VATA {
-	template <class Rel, class ProductSet> class ExplicitFACongrEquivFunctor;
+	template <class Rel, class ProductSet, class NormalFormRel> class ExplicitFACongrEquivFunctor;
 }
 
 GCC_DIAG_OFF(effc++)
-template <class Rel, class ProductSet>
+template <class Rel, class ProductSet, class NormalFormRel>
 class VATA::ExplicitFACongrEquivFunctor :
 	public ExplicitFAAbstractFunctor <Rel> {
 GCC_DIAG_ON(effc++)
@@ -35,22 +36,28 @@ public : // data types
 	typedef typename VATA::ExplicitFAAbstractFunctor<Rel>
 		AbstractFunctor;
 	typedef typename AbstractFunctor::ExplicitFA ExplicitFA;
+	typedef typename AbstractFunctor::FrozenFA FrozenFA;
 
 	typedef typename AbstractFunctor::StateType StateType;
-	typedef typename AbstractFunctor::StateSet StateSet;
 	typedef typename AbstractFunctor::SymbolType SymbolType;
+	typedef typename AbstractFunctor::Word Word;
 
-	typedef typename AbstractFunctor::Antichain1Type Antichain1Type;
+	// Macrostates are given by the product states, closures of congruence
+	// are mutable sets
+	typedef typename ProductSet::MacroState StateSet;
+	typedef typename AbstractFunctor::StateSet ClosureSet;
 
-	typedef std::unordered_set<SymbolType> SymbolSet;
+	typedef typename AbstractFunctor::Antichain1Type Antichain1Type;
 
 	/*
-	 * In the both automata are explored macrostates
+	 * In the both automata are explored macrostates,
+	 * they are handed out as pointers to the cache
 	 */
-	typedef StateSet SmallerElementType;
-	typedef StateSet BiggerElementType;
+	typedef StateSet* SmallerElementType;
+	typedef StateSet* BiggerElementType;
 
-	typedef std::unordered_map<size_t,StateSet> CongrMap;
+	typedef std::unordered_map<size_t,ClosureSet> CongrMap;
+	typedef std::pair<SmallerElementType,BiggerElementType> ProductState;
 
 	/*
 	 * Product state of built automaton is pair of macrostates
@@ -76,10 +83,12 @@ public : // data types
 	typedef ProductSet ProductStateSetType;
 	typedef ProductStateSetType ProductNextType;
 
-	typedef typename VATA::MacroStateCache<ExplicitFA> MacroStateCache;
-	typedef typename VATA::MapToList<StateSet*,StateSet*> MacrostatePtrPair;
+	typedef typename VATA::MacroStateCache<ExplicitFA,StateSet> MacroStateCache;
+	typedef typename VATA::ProductStateStore<ProductState,SymbolType> ProductStateStore;
+	typedef typename ProductStateStore::IdType IdType;
 
 	typedef typename AbstractFunctor::IndexType IndexType;
+	typedef typename AbstractFunctor::WorkerPool WorkerPool;
 
 private: // Private data members
 	ProductStateSetType& relation_;
@@ -89,13 +98,34 @@ private: // Private data members
 	const ExplicitFA& smaller_;
 	const ExplicitFA& bigger_;
 
+	// Transitions of the both NFA used for computing posts
+	const FrozenFA smallerFrozen_;
+	const FrozenFA biggerFrozen_;
+
 	IndexType& index_;
 	IndexType& inv_;
 
-	Rel preorder_; // Simulation or identity
+	NormalFormRel normalFormRel_; // Simulation or identity
 
 	MacroStateCache cache;
-	MacrostatePtrPair visitedPairs;
+	ProductStateStore visitedPairs;
+
+	// Classes of single states equated by the processed relation
+	StateUnionFind singletons_;
+
+	// Product state and symbol whose post is not accepted by the both
+	// automata, no product state when the initial one is not accepted
+	IdType failedPair_;
+	SymbolType failedSymbol_;
+
+	// The first product state of the next level in breadth-first order
+	// and the number of product states in todo which are used as rules
+	IdType levelEnd_;
+	size_t nextRules_;
+
+	// Product states whose posts are created in parallel
+	std::vector<std::pair<const StateSet*,const StateSet*>> batch_;
+	std::vector<IdType> batchIds_;
 
 public:
 	ExplicitFACongrEquivFunctor(ProductStateSetType& relation, ProductStateSetType& next,
@@ -110,11 +140,20 @@ public:
 		singleAntichain_(singleAntichain),
 		smaller_(smaller),
 		bigger_(bigger),
+		smallerFrozen_(smaller.Freeze()),
+		biggerFrozen_(bigger.Freeze()),
 		index_(index),
 		inv_(inv),
-		preorder_(preorder),
+		normalFormRel_(preorder,inv),
 		cache(),
-		visitedPairs()
+		visitedPairs(),
+		singletons_(),
+		failedPair_(ProductStateStore::NO_ID),
+		failedSymbol_(),
+		levelEnd_(0),
+		nextRules_(0),
+		batch_(),
+		batchIds_()
 	{}
 
 public: // public functions
@@ -125,44 +164,111 @@ public: // public functions
 	 * of both input NFA.
 	 */
 	void Init() {
-		StateSet smallerInit;
-		StateSet biggerInit;
+		StateSet smallerInit(smaller_.startStates_.begin(),smaller_.startStates_.end());
+		StateSet biggerInit(bigger_.startStates_.begin(),bigger_.startStates_.end());
 
 		// Check whether the new macrostates are final
 		bool smallerInitFinal = false;
 		bool biggerInitFinal = false;
 
-		// Created macrostate of smaller automaton
-		size_t smallerHashNum = 0;
-		for (auto state : smaller_.startStates_) {
-			if (!smallerInit.count(state)) smallerHashNum += state;
-			smallerInit.insert(state);
+		for (auto state : smallerInit) {
 			smallerInitFinal |= smaller_.IsStateFinal(state);
 		}
 
-		size_t biggerHashNum = 0;
-		for (auto state : bigger_.startStates_) {
-			if (!biggerInit.count(state)) biggerHashNum += state;
-			biggerInit.insert(state);
+		for (auto state : biggerInit) {
 			biggerInitFinal |= bigger_.IsStateFinal(state);
 		}
 
-		StateSet& insertSmaller = cache.insert(smallerHashNum,smallerInit);
-		StateSet& insertBigger = cache.insert(biggerHashNum,biggerInit);
+		StateSet& insertSmaller = cache.insert(smallerInit);
+		StateSet& insertBigger = cache.insert(biggerInit);
 		// Add to todo set
 		next_.add(insertSmaller,insertBigger);
-		visitedPairs.add(&insertSmaller,&insertBigger);
+		visitedPairs.Insert(std::make_pair(&insertSmaller,&insertBigger));
 		this->inclNotHold_ = smallerInitFinal != biggerInitFinal;
 	};
 
 	/*
 	 * Make post of given macrostates of the both NFA
 	 */
-	void MakePost(SmallerElementType& smaller, BiggerElementType& bigger) {
-		SymbolSet usedSymbols;
+	void MakePost(SmallerElementType smaller, BiggerElementType bigger) {
+		const IdType pair = visitedPairs.Find(std::make_pair(smaller,bigger));
+		if (IsInCongruence(*smaller,*bigger,pair)) {
+			return;
+		}
+
+		MakePostForAut(*smaller,*bigger,pair);
+		if (this->inclNotHold_) {
+			return;
+		}
+
+		AddToRelation(smaller,bigger);
+	};
+
+	/*
+	 * Parallel version of MakePost for breadth-first order. Product state
+	 * is checked now but its post is created by MakeBatchPosts together
+	 * with posts of the other product states of the batch (a level).
+	 * Product states of the next level are not used as rules while
+	 * the level is checked, so the result is the same as for
+	 * the sequential version.
+	 */
+	void AddToBatch(SmallerElementType smaller, BiggerElementType bigger) {
+		const IdType pair = visitedPairs.Find(std::make_pair(smaller,bigger));
+		if (IsInCongruence(*smaller,*bigger,pair)) {
+			return;
+		}
+
+		batch_.push_back(std::make_pair(smaller,bigger));
+		batchIds_.push_back(pair);
+		AddToRelation(smaller,bigger);
+	}
+
+	/*
+	 * Create posts of product states of the batch in parallel and
+	 * add them to todo in the order of the sequential version
+	 */
+	void MakeBatchPosts(WorkerPool& pool) {
+		auto processPost = [this](size_t i, const SymbolType& symbol,
+				StateSet& newSmaller, bool newSmallerAccept,
+				StateSet& newBigger, bool newBiggerAccept) -> bool {
+			return ProcessPost(batchIds_[i],symbol,newSmaller,newSmallerAccept,
+				newBigger,newBiggerAccept);
+		};
+
+		this->CreatePostsOfMacroStatesParallel(
+			batch_,smallerFrozen_,biggerFrozen_,pool,processPost);
+		batch_.clear();
+		batchIds_.clear();
+	}
+
+	// Adds counters of the cache of macrostates to the statistics
+	void AddCacheStatistics(CacheStatistics& stats) const {
+		stats.finiteMacrostates.hits += cache.GetHits();
+		stats.finiteMacrostates.misses += cache.size();
+		stats.finiteMacrostateCollisions += cache.GetCollisions();
+	}
+
+	/*
+	 * Store the word leading to the product state whose post
+	 * is not accepted by the both automata, the word is the shortest
+	 * one when product states are processed in breadth-first order
+	 */
+	void GetCounterexample(Word& word) const {
+		visitedPairs.GetWord(failedPair_,word);
+		if (failedPair_ != ProductStateStore::NO_ID) {
+			word.push_back(failedSymbol_);
+		}
+	}
+
+private:
 
+	/*
+	 * Checks whether the macrostates are equal in the congruence closure
+	 * of the relation and the todo set
+	 */
+	bool IsInCongruence(const StateSet& s, const StateSet& b, IdType pair) {
 		// Function checks whether macrostates are equal
-		auto areEqual = [] (StateSet& lss, StateSet& rss) -> bool {
+		auto areEqual = [] (ClosureSet& lss, ClosureSet& rss) -> bool {
 			if (lss.size() != rss.size()) {
 				return false;
 			}
@@ -178,52 +284,56 @@ public: // public functions
 			return true;
 		};
 
+		// In breadth-first order, product states in todo are used as rules
+		// since their level is processed (they are at the front of todo).
+		// Product states are not pruned by deeper ones then, so
+		// the counterexample is the shortest word.
+		nextRules_ = next_.size();
+		if (ProductSet::BREADTH_FIRST) {
+			if (pair >= levelEnd_) {
+				levelEnd_ = visitedPairs.size();
+			}
+			nextRules_ = levelEnd_ - pair - 1;
+		}
 
-		auto sum = [](StateSet& set, size_t& sum) {for (auto& state : set) sum+=state;};
-		size_t smallerHashNum = 0;
-		sum(smaller,smallerHashNum);
-		size_t biggerHashNum = 0;
-		sum(bigger,biggerHashNum);
-		SmallerElementType& s = cache.insert(smallerHashNum,smaller);
-		BiggerElementType& b = cache.insert(biggerHashNum,bigger);
+		// Pairs of single states equated by processed pairs of single states
+		// are in the congruence, so the closure need not be computed
+		const bool singletons = s.size() == 1 && b.size() == 1;
+		if (singletons && singletons_.Find(*s.begin()) == singletons_.Find(*b.begin())) {
+			return true;
+		}
 
 		CongrMap congrMap;
-		auto insertNewPair = [&congrMap](size_t i, StateSet& set) -> bool {
-			congrMap.insert(std::make_pair(i,StateSet(set)));
+		auto insertNewPair = [&congrMap](size_t i, ClosureSet& set) -> bool {
+			congrMap.insert(std::make_pair(i,ClosureSet(set)));
 			return true;
 		};
-		StateSet congrSmaller(smaller);
+		const StateSet& smallerNormalForm = normalFormRel_.GetNormalForm(s);
+		ClosureSet congrSmaller(smallerNormalForm.begin(),smallerNormalForm.end());
 		GetCongrClosure(congrSmaller,insertNewPair);
 
 		// Comapring given set with the sets
 		// which has been computed in steps of computation of congr closure
-		auto isCongrClosureSetNew = [&congrMap,&areEqual](size_t i, StateSet& set) ->
+		auto isCongrClosureSetNew = [&congrMap,&areEqual](size_t i, ClosureSet& set) ->
 			bool {
 				return !areEqual(congrMap[i],set);
 		};
 
-		StateSet congrBigger(bigger);
-		if (GetCongrClosure(congrBigger,isCongrClosureSetNew) || areEqual(congrBigger,congrSmaller)) {
-			smaller.clear();
-			bigger.clear();
-			return;
-		}
+		const StateSet& biggerNormalForm = normalFormRel_.GetNormalForm(b);
+		ClosureSet congrBigger(biggerNormalForm.begin(),biggerNormalForm.end());
+		return GetCongrClosure(congrBigger,isCongrClosureSetNew) ||
+			areEqual(congrBigger,congrSmaller);
+	}
 
-		MakePostForAut(smaller_,usedSymbols,smaller,bigger,smaller);
-		if (this->inclNotHold_) {
-			return;
+	// Processed product state is added to the relation
+	void AddToRelation(SmallerElementType smaller, BiggerElementType bigger) {
+		relation_.push_back(std::make_pair(smaller,bigger));
+		if (smaller->size() == 1 && bigger->size() == 1) {
+			singletons_.Union(*smaller->begin(),*bigger->begin());
 		}
-		MakePostForAut(bigger_,usedSymbols,smaller,bigger,bigger);
-
-		relation_.push_back(std::make_pair(&s,&b));
-
-		smaller.clear();
-		bigger.clear();
-	};
-
-private:
+	}
 
-	bool MatchPair(const StateSet& closure, const StateSet& rule) {
+	bool MatchPair(const ClosureSet& closure, const StateSet& rule) {
 		if (rule.size() > closure.size()) {
 				return false;
 		}
@@ -235,27 +345,27 @@ private:
 		return true;
 	}
 
-	void AddSubSet(StateSet& mainset, StateSet& subset) {
+	void AddSubSet(ClosureSet& mainset, const StateSet& subset) {
 		mainset.insert(subset.begin(),subset.end());
 	}
 
 	template<class CongrMapManipulator>
-	bool GetCongrClosure(StateSet& set, CongrMapManipulator& congrMapManipulator) {
+	bool GetCongrClosure(ClosureSet& set, CongrMapManipulator& congrMapManipulator) {
 		std::unordered_set<int> usedRulesN;
 		std::unordered_set<int> usedRulesR;
 
 		bool appliedRule = true;
 		while (appliedRule) { // Apply all possible rules
 			appliedRule = false;
-			for (unsigned int i=0; i < next_.size(); i++) { // relation next
+			for (unsigned int i=0; i < nextRules_; i++) { // relation next
 				if (usedRulesN.count(i)) { // already used rule
 					continue;
 				}
 
 				if (MatchPair(set, *next_[i].first) ||
 						 MatchPair(set, *next_[i].second)) { // Rule matches
-					AddSubSet(set,*next_[i].first);
-					AddSubSet(set,*next_[i].second);
+					AddSubSet(set,normalFormRel_.GetNormalForm(*next_[i].first));
+					AddSubSet(set,normalFormRel_.GetNormalForm(*next_[i].second));
 					usedRulesN.insert(i);
 					appliedRule = true;
 					if (!congrMapManipulator(i,set)) {
@@ -270,8 +380,8 @@ private:
 				}
 				if (MatchPair(set, *relation_[i].first) ||
 						 MatchPair(set, *relation_[i].second)) { // Rule matches
-					AddSubSet(set,*relation_[i].first);
-					AddSubSet(set,*relation_[i].second);
+					AddSubSet(set,normalFormRel_.GetNormalForm(*relation_[i].first));
+					AddSubSet(set,normalFormRel_.GetNormalForm(*relation_[i].second));
 					usedRulesR.insert(i);
 					appliedRule = true;
 					if (!congrMapManipulator(next_.size()+i,set)) {
@@ -285,64 +395,51 @@ private:
 
 
 	/*
-	 * Create post macrostates for given macrostate (actStateSet)
-	 * for all possible symbols.
+	 * Process post macrostates of the product state for the symbol
+	 * @param pair Id of the product state
+	 * @return False if inclusion does not hold
 	 */
-	void MakePostForAut(const ExplicitFA& aut, SymbolSet& usedSymbols,
-			const SmallerElementType& smaller, const BiggerElementType& bigger,
-			const StateSet& actStateSet) {
-
-		for (auto& state : actStateSet) { // for each state in processed macrostate
-			auto transIter = aut.transitions_->find(state);
-			if (transIter == aut.transitions_->end()) {
-				continue;
-			}
-
-			// For all symbols accesible by the state
-			for (auto& symbolToSet : *transIter->second) {
-				if (usedSymbols.count(symbolToSet.first)) { // symbol already explored
-					continue;
-				}
-
-				usedSymbols.insert(symbolToSet.first);
-				SmallerElementType newSmaller;
-				BiggerElementType newBigger;
-
-				// all states accesible under given symbol for in smaller nfa
-				bool newSmallerAccept =
-					this->CreatePostOfMacroState(
-							newSmaller,smaller,symbolToSet.first,smaller_);
-
-				// all states accesible under given symbol for in bigger nfa
-				bool newBiggerAccpet =
-					this->CreatePostOfMacroState(
-							newBigger,bigger,symbolToSet.first,bigger_);
-
-				if (newSmallerAccept != newBiggerAccpet) {
-					this->inclNotHold_ = true;
-					return;
-				}
+	bool ProcessPost(IdType pair, const SymbolType& symbol,
+			StateSet& newSmaller, bool newSmallerAccept,
+			StateSet& newBigger, bool newBiggerAccept) {
+		if (newSmallerAccept != newBiggerAccept) {
+			this->inclNotHold_ = true;
+			failedPair_ = pair;
+			failedSymbol_ = symbol;
+			return false;
+		}
 
-				/*
-				 * New macrostates of product state are added to cache nad then
-				 * the produc state to todo set if it has not been already explored
-				 */
-				if (newSmaller.size() || newBigger.size()) {
-					size_t smallerHashNum = 0;
-					size_t biggerHashNum = 0;
-					auto sum = [](StateSet& set, size_t& sum) {for (auto& state : set) sum+=state;};
-					sum(newSmaller,smallerHashNum);
-					sum(newBigger,biggerHashNum);
-					StateSet& insertSmaller = cache.insert(smallerHashNum,newSmaller);
-					StateSet& insertBigger = cache.insert(biggerHashNum,newBigger);
-
-					if (!visitedPairs.contains(&insertSmaller,&insertBigger)){
-						visitedPairs.add(&insertSmaller,&insertBigger);
-						next_.add(insertSmaller,insertBigger);
-					 }
-				}
+		/*
+		 * New macrostates of product state are added to cache nad then
+		 * the produc state to todo set if it has not been already explored
+		 */
+		if (newSmaller.size() || newBigger.size()) {
+			StateSet& insertSmaller = cache.insert(newSmaller);
+			StateSet& insertBigger = cache.insert(newBigger);
+
+			if (visitedPairs.Insert(std::make_pair(&insertSmaller,&insertBigger),
+					pair,symbol).second) {
+				next_.add(insertSmaller,insertBigger);
 			}
 		}
+		return true;
+	}
+
+	/*
+	 * Create post macrostates for given macrostates
+	 * for all possible symbols.
+	 * @param pair Id of the product state of the given macrostates
+	 */
+	void MakePostForAut(const StateSet& smaller, const StateSet& bigger, IdType pair) {
+		auto processPost = [this, pair](const SymbolType& symbol,
+				StateSet& newSmaller, bool newSmallerAccept,
+				StateSet& newBigger, bool newBiggerAccept) -> bool {
+			return ProcessPost(pair,symbol,newSmaller,newSmallerAccept,
+				newBigger,newBiggerAccept);
+		};
+
+		this->CreatePostsOfMacroStates(
+			smaller,smallerFrozen_,bigger,biggerFrozen_,processPost);
 	}
 };
 #endif
@@ -17,9 +17,10 @@
 #include <vata/vata.hh>
 
 #include "antichain2c_v2.hh"
+#include "congr_rule_index.hh"
 #include "explicit_finite_abstract_fctor.hh"
-#include "map_to_list.hh"
 #include "macrostate_cache.hh"
+#include "product_state_store.hh"
 
 namespace VATA {
 	template <class Rel, class ProductSet, class NormalFormRel> class ExplicitFACongrFunctorCacheOpt;
@@ -35,23 +36,28 @@ public : // data types
 	typedef typename VATA::ExplicitFAAbstractFunctor<Rel>
 		AbstractFunctor;
 	typedef typename AbstractFunctor::ExplicitFA ExplicitFA;
+	typedef typename AbstractFunctor::FrozenFA FrozenFA;
 
 	typedef typename AbstractFunctor::StateType StateType;
-	typedef typename AbstractFunctor::StateSet StateSet;
 	typedef typename AbstractFunctor::SymbolType SymbolType;
+	typedef typename AbstractFunctor::Word Word;
 
-	typedef typename AbstractFunctor::Antichain1Type Antichain1Type;
+	// Macrostates are given by the product states, closures of congruence
+	// are mutable sets
+	typedef typename ProductSet::MacroState StateSet;
+	typedef typename AbstractFunctor::StateSet ClosureSet;
 
-	typedef std::unordered_set<SymbolType> SymbolSet;
+	typedef typename AbstractFunctor::Antichain1Type Antichain1Type;
 
 	/*
-	 * In the both automata are explored macrostates
+	 * In the both automata are explored macrostates,
+	 * they are handed out as pointers to the cache
 	 */
-	typedef StateSet SmallerElementType;
-	typedef StateSet BiggerElementType;
+	typedef StateSet* SmallerElementType;
+	typedef StateSet* BiggerElementType;
 
-	typedef std::unordered_map<size_t,StateSet> CongrMap;
-	typedef std::pair<SmallerElementType*,BiggerElementType*> ProductState;
+	typedef std::unordered_map<size_t,ClosureSet> CongrMap;
+	typedef std::pair<SmallerElementType,BiggerElementType> ProductState;
 
 	/*
 	 * Product state of built automaton is pair of macrostates
@@ -79,10 +85,13 @@ GCC_DIAG_ON(effc++)
 	// todo set is the same as the processed set of product states
 	typedef ProductStateSetType ProductNextType;
 
-	typedef typename VATA::MacroStateCache<ExplicitFA> MacroStateCache;
-	typedef typename VATA::MapToList<StateSet*,StateSet*> MacroStatePtrPair;
+	typedef typename VATA::MacroStateCache<ExplicitFA,StateSet> MacroStateCache;
+	typedef typename VATA::ProductStateStore<ProductState,SymbolType> ProductStateStore;
+	typedef typename ProductStateStore::IdType IdType;
+	typedef typename VATA::CongrRuleIndex<ClosureSet> RuleIndex;
 
 	typedef typename AbstractFunctor::IndexType IndexType;
+	typedef typename AbstractFunctor::WorkerPool WorkerPool;
 
 private: // Private data members
 	ProductStateSetType& relation_;
@@ -92,14 +101,33 @@ private: // Private data members
 	const ExplicitFA& smaller_;
 	const ExplicitFA& bigger_;
 
+	// Transitions of the both NFA used for computing posts
+	const FrozenFA smallerFrozen_;
+	const FrozenFA biggerFrozen_;
+
 	IndexType& index_;
 	IndexType& inv_;
 
 	NormalFormRel normalFormRel_;
 
 	MacroStateCache cache_;
-	MacroStatePtrPair visitedPairs_;
-	MacroStatePtrPair usedRules_;
+	ProductStateStore visitedPairs_;
+
+	// Rules given by product states in the todo and processed relation,
+	// rules are numbered by ids of product states in the store
+	RuleIndex ruleIndex_;
+
+	// Product state and symbol whose post is not accepted by the both
+	// automata, no product state when the initial one is not accepted
+	IdType failedPair_;
+	SymbolType failedSymbol_;
+
+	// The first product state of the next level in breadth-first order
+	IdType levelEnd_;
+
+	// Product states whose posts are created in parallel
+	std::vector<std::pair<const StateSet*,const StateSet*>> batch_;
+	std::vector<IdType> batchIds_;
 
 public:
 	ExplicitFACongrFunctorCacheOpt(ProductStateSetType& relation, ProductStateSetType& next,
@@ -114,12 +142,19 @@ public:
 		singleAntichain_(singleAntichain),
 		smaller_(smaller),
 		bigger_(bigger),
+		smallerFrozen_(smaller.Freeze()),
+		biggerFrozen_(bigger.Freeze()),
 		index_(index),
 		inv_(inv),
-		normalFormRel_(preorder),
+		normalFormRel_(preorder,inv),
 		cache_(),
 		visitedPairs_(),
-		usedRules_()
+		ruleIndex_(),
+		failedPair_(ProductStateStore::NO_ID),
+		failedSymbol_(),
+		levelEnd_(0),
+		batch_(),
+		batchIds_()
 	{}
 
 public: // public functions
@@ -130,46 +165,113 @@ public: // public functions
 	 * of both input NFA.
 	 */
 	void Init() {
-		StateSet smallerInit;
-		StateSet biggerInit;
+		StateSet smallerInit(smaller_.startStates_.begin(),smaller_.startStates_.end());
+		StateSet biggerInit(bigger_.startStates_.begin(),bigger_.startStates_.end());
 
 		// Check whether the new macrostates are final
 		bool smallerInitFinal = false;
 		bool biggerInitFinal = false;
 
-		// Created macrostate of smaller automaton
-		size_t smallerHashNum = 0;
-		for (auto state : smaller_.startStates_) {
-			smallerHashNum += state;
-			smallerInit.insert(state);
+		for (auto state : smallerInit) {
 			smallerInitFinal |= smaller_.IsStateFinal(state);
 		}
 
-		// Created macrostate of bigger automaton
-		size_t biggerHashNum = 0;
-		for (auto state : bigger_.startStates_) {
-			biggerHashNum += state;
-			biggerInit.insert(state);
+		for (auto state : biggerInit) {
 			biggerInitFinal |= bigger_.IsStateFinal(state);
 		}
 
 		// Add states to the cache
-		StateSet& insertSmaller = cache_.insert(smallerHashNum,smallerInit);
-		StateSet& insertBigger = cache_.insert(biggerHashNum,biggerInit);
+		StateSet& insertSmaller = cache_.insert(smallerInit);
+		StateSet& insertBigger = cache_.insert(biggerInit);
 		// Add to todo set
-		next_.push_back(std::make_pair(&insertSmaller,&insertBigger));
-		visitedPairs_.add(&insertSmaller,&insertBigger);
+		visitedPairs_.Insert(std::make_pair(&insertSmaller,&insertBigger));
+		AddToNext(insertSmaller,insertBigger);
 		this->inclNotHold_ = smallerInitFinal != biggerInitFinal;
 	};
 
 	/*
 	 * Make post of given macrostates of the both NFA
 	 */
-	void MakePost(SmallerElementType& smaller, BiggerElementType& bigger) {
-		SymbolSet usedSymbols;
+	void MakePost(SmallerElementType smaller, BiggerElementType bigger) {
+		const IdType pair = visitedPairs_.Find(std::make_pair(smaller,bigger));
+		if (IsInCongruence(*smaller,*bigger,pair)) {
+			return;
+		}
+
+		// Create post macrostates
+		MakePostForAut(*smaller,*bigger,pair);
+		if (this->inclNotHold_) {
+			return;
+		}
+
+		AddToRelation(smaller,bigger,pair);
+	};
+
+	/*
+	 * Parallel version of MakePost for breadth-first order. Product state
+	 * is checked now but its post is created by MakeBatchPosts together
+	 * with posts of the other product states of the batch (a level).
+	 * Rules of the next level are not used while the level is checked,
+	 * so the result is the same as for the sequential version.
+	 */
+	void AddToBatch(SmallerElementType smaller, BiggerElementType bigger) {
+		const IdType pair = visitedPairs_.Find(std::make_pair(smaller,bigger));
+		if (IsInCongruence(*smaller,*bigger,pair)) {
+			return;
+		}
+
+		batch_.push_back(std::make_pair(smaller,bigger));
+		batchIds_.push_back(pair);
+		AddToRelation(smaller,bigger,pair);
+	}
+
+	/*
+	 * Create posts of product states of the batch in parallel and
+	 * add them to todo in the order of the sequential version
+	 */
+	void MakeBatchPosts(WorkerPool& pool) {
+		auto processPost = [this](size_t i, const SymbolType& symbol,
+				StateSet& newSmaller, bool newSmallerAccept,
+				StateSet& newBigger, bool newBiggerAccept) -> bool {
+			return ProcessPost(batchIds_[i],symbol,newSmaller,newSmallerAccept,
+				newBigger,newBiggerAccept);
+		};
+
+		this->CreatePostsOfMacroStatesParallel(
+			batch_,smallerFrozen_,biggerFrozen_,pool,processPost);
+		batch_.clear();
+		batchIds_.clear();
+	}
+
+	// Adds counters of the cache of macrostates to the statistics
+	void AddCacheStatistics(CacheStatistics& stats) const {
+		stats.finiteMacrostates.hits += cache_.GetHits();
+		stats.finiteMacrostates.misses += cache_.size();
+		stats.finiteMacrostateCollisions += cache_.GetCollisions();
+	}
+
+	/*
+	 * Store the word leading to the product state whose post
+	 * is not accepted by the both automata, the word is the shortest
+	 * one when product states are processed in breadth-first order
+	 */
+	void GetCounterexample(Word& word) const {
+		visitedPairs_.GetWord(failedPair_,word);
+		if (failedPair_ != ProductStateStore::NO_ID) {
+			word.push_back(failedSymbol_);
+		}
+	}
 
+private:
+
+	/*
+	 * Checks whether the smaller macrostate is in the congruence closure
+	 * of the bigger one. The rule of the product state is deactivated
+	 * (it is neither in todo nor in processed relation now).
+	 */
+	bool IsInCongruence(const StateSet& s, const StateSet& b, IdType rule) {
 		// Function checks whether macrostates are equal
-		auto isSubSet = [] (StateSet& lss, StateSet& rss) -> bool {
+		auto isSubSet = [] (const StateSet& lss, const ClosureSet& rss) -> bool {
 			if (lss.size() > rss.size()) {
 				return false;
 			}
@@ -182,253 +284,103 @@ public: // public functions
 			return true;
 		};
 
-
-		auto sum = [](StateSet& set, size_t& sum) {for (auto& state : set) sum+=state;};
-		size_t smallerHashNum = 0;
-		sum(smaller,smallerHashNum);
-		size_t biggerHashNum = 0;
-		sum(bigger,biggerHashNum);
-		SmallerElementType& s = cache_.insert(smallerHashNum,smaller);
-		BiggerElementType& b = cache_.insert(biggerHashNum,bigger);
-
+		// In breadth-first order, rules of product states are used since
+		// their level is processed. Product states are not pruned by deeper
+		// ones then, so the counterexample is the shortest word.
+		if (ProductSet::BREADTH_FIRST && rule >= levelEnd_) {
+			for (IdType i = levelEnd_; i < visitedPairs_.size(); ++i) {
+				ruleIndex_.SetActive(i,true);
+			}
+			levelEnd_ = visitedPairs_.size();
+		}
+		ruleIndex_.SetActive(rule,false);
 
 		// Comapring given set with the sets
 		// which has been computed in steps of computation of congr closure
-		auto isCongrClosureSet = [&s,&isSubSet](StateSet& bigger) ->
+		auto isCongrClosureSet = [&s,&isSubSet](ClosureSet& bigger) ->
 			bool {
 				return !isSubSet(s,bigger);
 		};
 
 		// Compute congruence closure of bigger nfa
-		StateSet congrBigger(bigger);
-
-		normalFormRel_.applyRule(congrBigger);
+		const StateSet& biggerNormalForm = normalFormRel_.GetNormalForm(b);
+		ClosureSet congrBigger(biggerNormalForm.begin(),biggerNormalForm.end());
 
 		// Checks whether smaller macrostate is subset of congr. clusure of bigger
-		if (GetCongrClosure(b,congrBigger,isCongrClosureSet) ||
-			isSubSet(s,congrBigger)) {
-			smaller.clear();
-			bigger.clear();
-			return;
-		}
-
-		// Create post macrostates
-		MakePostForAut(smaller_,usedSymbols,smaller,bigger,smaller);
-		if (this->inclNotHold_) {
-			return;
-		}
-		MakePostForAut(bigger_,usedSymbols,smaller,bigger,bigger);
-
-		relation_.push_back(std::make_pair(&s,&b));
-
-		smaller.clear();
-		bigger.clear();
-	};
-
-private:
-
-	// Check if the rule is applyable
-	bool MatchPair(const StateSet& closure, const StateSet& rule) {
-		if (rule.size() > closure.size()) {
-				return false;
-		}
-		for (auto& s : rule) {
-			if (!closure.count(s)) {
-				return false;
-		 }
-		}
-		return true;
+		return ruleIndex_.GetClosure(congrBigger,isCongrClosureSet) ||
+			isSubSet(s,congrBigger);
 	}
 
-	void AddSubSet(StateSet& mainset, StateSet& subset) {
-		StateSet temp = StateSet(subset);
-		normalFormRel_.applyRule(temp);
-		mainset.insert(temp.begin(),temp.end());
-		//mainset.insert(subset.begin(),subset.end());
+	// Processed product state is added to the relation and its rule is used again
+	void AddToRelation(SmallerElementType smaller, BiggerElementType bigger, IdType rule) {
+		relation_.push_back(std::make_pair(smaller,bigger));
+		ruleIndex_.SetActive(rule,true);
 	}
 
 	/*
-	 * Apply all possible rules for given relation
-	 * when the congruence closure of the given macrostate
-	 * has not been computed.
-	 * @param origSet set for which is congr. closure computed
-	 * @param set Set where congr closure is stored
-	 * @param congrMapManipulator Checks	on the fly if the (X,Y) in c(R) does not hold
-	 * @param usedRulesNumber Used rules for given relation
-	 * @param appliedRules signify whether some rule has been applied
-	 * @param relation Relation of processed states
+	 * Add product state to the todo set and its rule
+	 * Y -> X + Y to the index of rules
 	 */
-	template<class CongrMapManipulator>
-	bool ApplyRulesForRelation(StateSet& origSet, StateSet& set,
-		ProductStateSetType& relation, CongrMapManipulator& congrMapManipulator,
-		std::unordered_set<int>& usedRulesNumbers,
-		bool& appliedRule) {
-
-	 for (unsigned int i=0; i < relation.size(); i++) { // all items in relation
-		 if (usedRulesNumbers.count(i)) { // already used rule
-			 continue;
-		 }
-		 if (MatchPair(set, *relation[i].second)) { // Rule matched
-			 AddSubSet(set,*relation[i].first);
-			 AddSubSet(set,*relation[i].second);
-			 usedRules_.add(&origSet,relation[i].second); // Stores applied rules
-			 usedRulesNumbers.insert(i);
-			 appliedRule = true;
-			 if (!congrMapManipulator(set)) {
-				 return true;
-			 }
-		 }
+	void AddToNext(StateSet& smaller, StateSet& bigger) {
+		const StateSet& smallerNormalForm = normalFormRel_.GetNormalForm(smaller);
+		ClosureSet conclusion(smallerNormalForm.begin(),smallerNormalForm.end());
+		const StateSet& biggerNormalForm = normalFormRel_.GetNormalForm(bigger);
+		conclusion.insert(biggerNormalForm.begin(),biggerNormalForm.end());
+
+		const size_t rule = ruleIndex_.AddRule(bigger,
+			typename RuleIndex::StateVector(conclusion.begin(),conclusion.end()));
+		if (ProductSet::BREADTH_FIRST) { // activated with its level
+			ruleIndex_.SetActive(rule,false);
 		}
-		return false;
+		next_.add(smaller,bigger);
 	}
 
 	/*
-	 * Apply all possible rules for given relation
-	 * when the congruence closure of the given macrostate
-	 * has been computed.
-	 * @param origSet set for which is congr. closure computed
-	 * @param set Set where congr closure is stored
-	 * @param congrMapManipulator Checks	on the fly if the (X,Y) in c(R) does not hold
-	 * @param usedRulesNumber Used rules for given relation
-	 * @param appliedRules signify whether some rule has been applied
-	 * @param relation Relation of processed states
+	 * Process post macrostates of the product state for the symbol
+	 * @param pair Id of the product state
+	 * @return False if inclusion does not hold
 	 */
-	template<class CongrMapManipulator>
-	bool ApplyRulesForRelationVisited(StateSet& origSet, StateSet& set,
-		ProductStateSetType& relation, CongrMapManipulator& congrMapManipulator,
-		std::unordered_set<int>& usedRulesNumbers,
-		bool& appliedRule) {
-
-		for (unsigned int i=0; i < relation.size(); i++) { // relation next
-			if (usedRulesNumbers.count(i)) { // already used rule
-				continue;
-		 	}
-		 	if (usedRules_.contains(&origSet,relation[i].second) ||
-				MatchPair(set, *relation[i].second)) { // Rule matches
-
-				AddSubSet(set,*relation[i].first);
-			 	AddSubSet(set,*relation[i].second);
-			 	usedRulesNumbers.insert(i);
-			 	appliedRule = true;
-			 	if (!congrMapManipulator(set)) {
-					return true;
-			 	}
-		 	}
+	bool ProcessPost(IdType pair, const SymbolType& symbol,
+			StateSet& newSmaller, bool newSmallerAccept,
+			StateSet& newBigger, bool newBiggerAccept) {
+		if (newSmallerAccept != newBiggerAccept) {
+			this->inclNotHold_ = true;
+			failedPair_ = pair;
+			failedSymbol_ = symbol;
+			return false;
 		}
-		return false;
-	}
 
-	/*
-	 * Compute congruence closure for given set
-	 * @param origSet set for which is congr. closure computed
-	 * @param set Set where congr closure is stored
-	 * @param usedRulesNumberN Used rules in todo relation
-	 * @param usedRulesNumberR Used rules in processed relation
-	 * @param congrMapManipulator Checks	on the fly if the (X,Y) in c(R) does not hold
-	 */
-	template<class CongrMapManipulator>
-	bool GetCongrClosure(StateSet& origSet,StateSet& set, CongrMapManipulator& congrMapManipulator) {
-		std::unordered_set<int> usedRulesNumbersN;
-		std::unordered_set<int> usedRulesNumbersR;
-
-		bool appliedRule = true;
-		bool visited = usedRules_.containsKey(&origSet);
-
-		if (!visited) { // congr. closure for the macrostate has been computed
-			while (appliedRule) { // Apply all possible rules
-				appliedRule = false;
-
-				if (ApplyRulesForRelation( //apply rules for next relation
-					origSet,set,next_,congrMapManipulator,
-					usedRulesNumbersN,appliedRule)) {
-					return true;
-				}
-				// apply rules for proccesed relation
-				if (ApplyRulesForRelation(origSet,set,relation_,
-						congrMapManipulator,usedRulesNumbersR,appliedRule)) {
-					return true;
-				}
+		/*
+		 * New macrostates of product state are added to cache nad then
+		 * the produc state to todo set if it has not been already explored
+		 */
+		if (newSmaller.size() || newBigger.size()) {
+			StateSet& insertSmaller = cache_.insert(newSmaller);
+			StateSet& insertBigger = cache_.insert(newBigger);
+
+			if (visitedPairs_.Insert(std::make_pair(&insertSmaller,&insertBigger),
+					pair,symbol).second) {
+				AddToNext(insertSmaller,insertBigger);
 			}
 		}
-		else { // congr. closure computed first time
-			while (appliedRule) { // Macrostate allready visited
-				appliedRule = false;
-
-				if (ApplyRulesForRelationVisited(
-					origSet,set,next_,congrMapManipulator,usedRulesNumbersN,appliedRule)){
-					return true;
-				}
-				// apply rules for proccesed relation
-				if (ApplyRulesForRelationVisited(
-					origSet,set,relation_,congrMapManipulator,usedRulesNumbersR,appliedRule)) {
-					return true;
-				}
-			}
-		}
-		return false;
+		return true;
 	}
 
-
 	/*
-	 * Create post macrostates for given macrostate (actStateSet)
+	 * Create post macrostates for given macrostates
 	 * for all possible symbols.
+	 * @param pair Id of the product state of the given macrostates
 	 */
-	void MakePostForAut(const ExplicitFA& aut, SymbolSet& usedSymbols,
-			const SmallerElementType& smaller, const BiggerElementType& bigger,
-			const StateSet& actStateSet) {
-
-		for (auto& state : actStateSet) {// for each state in processed macrostate
-			auto transIter = aut.transitions_->find(state);
-			if (transIter == aut.transitions_->end()) {
-				continue;
-			}
-
-			// For all symbols accesible by the state
-			for (auto& symbolToSet : *transIter->second) {
-				if (usedSymbols.count(symbolToSet.first)) { // symbol already explored
-					continue;
-				}
-
-				usedSymbols.insert(symbolToSet.first);
-				SmallerElementType newSmaller;
-				BiggerElementType newBigger;
-
-				// all states accesible under given symbol for in smaller nfa
-				bool newSmallerAccept =
-					this->CreatePostOfMacroState(
-							newSmaller,smaller,symbolToSet.first,smaller_);
-
-				// all states accesible under given symbol for in bigger nfa
-				bool newBiggerAccpet =
-					this->CreatePostOfMacroState(
-							newBigger,bigger,symbolToSet.first,bigger_);
-
-				if (newSmallerAccept != newBiggerAccpet) {
-					this->inclNotHold_ = true;
-					return;
-				}
+	void MakePostForAut(const StateSet& smaller, const StateSet& bigger, IdType pair) {
+		auto processPost = [this, pair](const SymbolType& symbol,
+				StateSet& newSmaller, bool newSmallerAccept,
+				StateSet& newBigger, bool newBiggerAccept) -> bool {
+			return ProcessPost(pair,symbol,newSmaller,newSmallerAccept,
+				newBigger,newBiggerAccept);
+		};
 
-				/*
-				 * New macrostates of product state are added to cache nad then
-				 * the produc state to todo set if it has not been already explored
-				 */
-				if (newSmaller.size() || newBigger.size()) {
-					size_t smallerHashNum = 0;
-					size_t biggerHashNum = 0;
-					auto sum = [](StateSet& set, size_t& sum) {for (auto& state : set) sum+=state;};
-					sum(newSmaller,smallerHashNum);
-					sum(newBigger,biggerHashNum);
-					StateSet& insertSmaller = cache_.insert(smallerHashNum,newSmaller);
-					StateSet& insertBigger = cache_.insert(biggerHashNum,newBigger);
-					if (!visitedPairs_.contains(&insertSmaller,&insertBigger)){
-						visitedPairs_.add(&insertSmaller,&insertBigger);
-						next_.add(insertSmaller,insertBigger);
-						//next_.push_back(std::make_pair(&insertSmaller,&insertBigger));
-					  //next_.insert(next_.begin(),std::make_pair(&insertSmaller,&insertBigger));
-					}
-				}
-			}
-		}
+		this->CreatePostsOfMacroStates(
+			smaller,smallerFrozen_,bigger,biggerFrozen_,processPost);
 	}
 };
 #endif
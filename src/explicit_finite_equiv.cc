@@ -0,0 +1,231 @@
+/*****************************************************************************
+ *	VATA Finite Automata Library
+ *
+ *	Copyright (c) 2013	Martin Hruska <xhrusk16@stud.fit.vutbr.cz>
+ *
+ *	Description:
+ *	Checking language equivalence for explicitly represented finite automata.
+ *
+ *****************************************************************************/
+
+// VATA headers
+#include <vata/vata.hh>
+#include <vata/equiv_param.hh>
+#include <vata/sim_param.hh>
+
+#include "explicit_finite_aut_core.hh"
+#include "explicit_finite_frozen.hh"
+#include "state_union_find.hh"
+
+// Standard library headers
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+using VATA::AutBase;
+using VATA::ExplicitFAFrozen;
+using VATA::ExplicitFiniteAutCore;
+using VATA::StateUnionFind;
+
+namespace
+{
+	typedef ExplicitFiniteAutCore::StateType StateType;
+	typedef ExplicitFiniteAutCore::SymbolType SymbolType;
+	typedef ExplicitFiniteAutCore::Word Word;
+
+	/*
+	 * Hopcroft-Karp algorithm for deterministic automata. Pairs of single
+	 * states are merged in union-find, a pair is explored only when it
+	 * merges two different classes, so the check takes almost linear time.
+	 * Missing transitions lead to the sink which is a non-final state
+	 * without transitions. Pairs are explored in breadth-first order and
+	 * every pair keeps the pair and the symbol it has been reached from,
+	 * so the counterexample is the shortest word.
+	 * @param aut Disjoint union of the both automata
+	 * @param smallerStart Start state of the first automaton or the sink
+	 * @param biggerStart Start state of the second automaton or the sink
+	 * @param sink State which is not used by the automata
+	 * @param counterexample Word accepted by one automaton only is stored
+	 * here if it is given
+	 */
+	bool CheckDeterministicEquivalence(
+		const ExplicitFAFrozen&    aut,
+		const StateType&           smallerStart,
+		const StateType&           biggerStart,
+		const StateType&           sink,
+		Word*                      counterexample)
+	{
+		struct Pair
+		{
+			StateType lhs;
+			StateType rhs;
+			size_t parent;
+			SymbolType symbol;
+		};
+
+		StateUnionFind classes;
+		std::vector<Pair> pairs;
+
+		size_t actual = 0; // the explored pair
+		auto addPair = [&classes, &pairs, &actual](const StateType& lhs,
+			const StateType& rhs, const SymbolType& symbol)
+		{
+			if (classes.Union(lhs, rhs)) {
+				Pair pair = {lhs, rhs, actual, symbol};
+				pairs.push_back(pair);
+			}
+		};
+		auto getSuccessor = [&aut](size_t entry) -> StateType {
+			return *aut.GetSuccessors(entry).begin();
+		};
+
+		addPair(smallerStart, biggerStart, SymbolType());
+
+		for ( ; actual < pairs.size(); ++actual) {
+			const StateType lhs = pairs[actual].lhs;
+			const StateType rhs = pairs[actual].rhs;
+
+			if (aut.IsStateFinal(lhs) != aut.IsStateFinal(rhs)) {
+				if (nullptr != counterexample) {
+					counterexample->clear();
+					for (size_t i = actual; 0 != i; i = pairs[i].parent) {
+						counterexample->push_back(pairs[i].symbol);
+					}
+					std::reverse(counterexample->begin(), counterexample->end());
+				}
+				return false;
+			}
+
+			// Rows are sorted by symbols, so they are merged
+			size_t lhsEntry = aut.RowBegin(lhs);
+			size_t rhsEntry = aut.RowBegin(rhs);
+			const size_t lhsEnd = aut.RowEnd(lhs);
+			const size_t rhsEnd = aut.RowEnd(rhs);
+			while (lhsEntry < lhsEnd || rhsEntry < rhsEnd) {
+				if (rhsEntry == rhsEnd || (lhsEntry < lhsEnd &&
+						aut.GetSymbol(lhsEntry) < aut.GetSymbol(rhsEntry))) {
+					addPair(getSuccessor(lhsEntry), sink, aut.GetSymbol(lhsEntry));
+					++lhsEntry;
+				}
+				else if (lhsEntry == lhsEnd ||
+						aut.GetSymbol(rhsEntry) < aut.GetSymbol(lhsEntry)) {
+					addPair(sink, getSuccessor(rhsEntry), aut.GetSymbol(rhsEntry));
+					++rhsEntry;
+				}
+				else {
+					addPair(getSuccessor(lhsEntry), getSuccessor(rhsEntry),
+						aut.GetSymbol(lhsEntry));
+					++lhsEntry;
+					++rhsEntry;
+				}
+			}
+		}
+
+		return true;
+	}
+}
+
+/*
+ * Equivalence is checked as inclusion in the both directions. The congruence
+ * algorithm works on the disjoint union of the both automata (the union
+ * accepts the union of languages, so it is included in an automaton iff
+ * the other automaton is), hence the simulation is computed only once
+ * on the union and it is used for the both directions. Deterministic
+ * automata (after removing of useless states) are checked by the
+ * Hopcroft-Karp algorithm instead of the congruence algorithm.
+ */
+bool ExplicitFiniteAutCore::CheckEquivalence(
+	const ExplicitFiniteAutCore&    smaller,
+	const ExplicitFiniteAutCore&    bigger,
+	const VATA::EqParam&            params,
+	Word*                           counterexample)
+{
+	ExplicitFiniteAutCore newSmaller = smaller;
+	ExplicitFiniteAutCore newBigger = bigger;
+
+	const StateType states = AutBase::SanitizeAutsForInclusion(newSmaller, newBigger);
+
+	InclParam inclParams;
+	switch (params.GetOptions())
+	{
+		case EqParam::ANTICHAINS_UP:
+		{
+			inclParams.SetAlgorithm(InclParam::e_algorithm::antichains);
+			break;
+		}
+		case EqParam::CONGRUENCE_UP:
+		case EqParam::CONGRUENCE_UP_SIM:
+		{
+			inclParams.SetAlgorithm(InclParam::e_algorithm::congruences);
+			inclParams.SetEquivalence(true);
+			inclParams.SetSearchOrder(
+				EqParam::e_search_order::breadth == params.GetSearchOrder() ?
+				InclParam::e_search_order::breadth : InclParam::e_search_order::depth);
+			inclParams.SetThreads(params.GetThreads());
+			break;
+		}
+		default:
+		{
+			throw NotImplementedException("Equivalence:\n" +
+				params.toString());
+		}
+	}
+
+	ExplicitFiniteAutCore unionAut = UnionDisjointStates(newSmaller, newBigger);
+
+	// When the counterexample is wanted, the inclusions are checked in the
+	// both directions and the shorter of their counterexamples is kept
+	auto checkInclusions = [&inclParams, counterexample](
+		const ExplicitFiniteAutCore& lhsSmaller, const ExplicitFiniteAutCore& lhsBigger,
+		const ExplicitFiniteAutCore& rhsSmaller, const ExplicitFiniteAutCore& rhsBigger) -> bool
+	{
+		if (nullptr == counterexample)
+		{
+			return CheckInclusion(lhsSmaller, lhsBigger, inclParams) &&
+				CheckInclusion(rhsSmaller, rhsBigger, inclParams);
+		}
+
+		Word rhsCounterexample;
+		const bool lhsRes = CheckInclusion(lhsSmaller, lhsBigger, inclParams, counterexample);
+		const bool rhsRes = CheckInclusion(rhsSmaller, rhsBigger, inclParams, &rhsCounterexample);
+		if (!rhsRes && (lhsRes || rhsCounterexample.size() < counterexample->size()))
+		{
+			counterexample->swap(rhsCounterexample);
+		}
+
+		return lhsRes && rhsRes;
+	};
+
+	// Deterministic automata do not need macrostates
+	if (inclParams.GetAlgorithm() == InclParam::e_algorithm::congruences &&
+		newSmaller.GetStartStates().size() <= 1 &&
+		newBigger.GetStartStates().size() <= 1)
+	{
+		const ExplicitFAFrozen frozen = unionAut.Freeze();
+		if (frozen.IsDeterministic())
+		{
+			auto getStart = [&states](const StateSet& startStates) -> StateType {
+				return startStates.empty() ? states : *startStates.begin();
+			};
+
+			return CheckDeterministicEquivalence(frozen,
+				getStart(newSmaller.GetStartStates()),
+				getStart(newBigger.GetStartStates()), states, counterexample);
+		}
+	}
+
+	if (!params.GetUseSimulation())
+	{
+		return checkInclusions(newSmaller, newBigger, newBigger, newSmaller);
+	}
+
+	SimParam simParams;
+	simParams.SetRelation(SimParam::e_sim_relation::FA_FORWARD);
+	simParams.SetThreads(params.GetThreads());
+	AutBase::StateDiscontBinaryRelation sim = unionAut.ComputeSimulation(simParams);
+
+	inclParams.SetUseSimulation(true);
+	inclParams.SetSimulation(&sim);
+
+	return checkInclusions(unionAut, newBigger, unionAut, newSmaller);
+}
@@ -0,0 +1,113 @@
+/*****************************************************************************
+ *	VATA Finite Automata Library
+ *
+ *	Copyright (c) 2013	Martin Hruska <xhrusk16@stud.fit.vutbr.cz>
+ *
+ *	Description:
+ *	Frozen (immutable) transition table of explicitly represented finite
+ *	automata.
+ *
+ *****************************************************************************/
+
+// VATA headers
+#include <vata/vata.hh>
+
+#include "explicit_finite_frozen.hh"
+
+// Standard library headers
+#include <algorithm>
+
+using VATA::ExplicitFAFrozen;
+using VATA::ExplicitFiniteAutCore;
+
+ExplicitFAFrozen::ExplicitFAFrozen(const ExplicitFiniteAutCore& aut) :
+	rows_(1, 0),
+	symbols_(),
+	entries_(1, 0),
+	successors_(),
+	final_()
+{
+	assert(nullptr != aut.transitions_);
+
+	// Find the biggest state, rows are indexed by states
+	bool empty = true;
+	StateType maxState = 0;
+	auto updateMax = [&empty, &maxState](const StateType& state) {
+		maxState = empty ? state : std::max(maxState, state);
+		empty = false;
+	};
+
+	for (auto& stateToCluster : *aut.transitions_) {
+		updateMax(stateToCluster.first);
+		for (auto& symbolToSet : *stateToCluster.second) {
+			for (auto& state : symbolToSet.second) {
+				updateMax(state);
+			}
+		}
+	}
+	for (auto& state : aut.finalStates_) {
+		updateMax(state);
+	}
+
+	if (empty) {
+		return;
+	}
+
+	rows_.assign(maxState + 2, 0);
+	final_.assign(maxState + 1, false);
+	for (auto& state : aut.finalStates_) {
+		final_[state] = true;
+	}
+
+	std::vector<SymbolType> symbols;
+	for (StateType state = 0; state <= maxState; ++state) {
+		rows_[state] = symbols_.size();
+
+		auto stateToCluster = aut.transitions_->find(state);
+		if (stateToCluster == aut.transitions_->end()) {
+			continue;
+		}
+		const auto& cluster = *stateToCluster->second;
+
+		// Entries of the row are sorted by symbols
+		symbols.clear();
+		for (auto& symbolToSet : cluster) {
+			symbols.push_back(symbolToSet.first);
+		}
+		std::sort(symbols.begin(), symbols.end());
+
+		for (auto& symbol : symbols) {
+			const auto& states = cluster.find(symbol)->second;
+			if (states.empty()) {
+				continue;
+			}
+
+			symbols_.push_back(symbol);
+			const size_t first = successors_.size();
+			successors_.insert(successors_.end(), states.begin(), states.end());
+			std::sort(successors_.begin() + first, successors_.end());
+			entries_.push_back(successors_.size());
+		}
+	}
+	rows_[maxState + 1] = symbols_.size();
+}
+
+ExplicitFAFrozen::Successors ExplicitFAFrozen::GetSuccessors(
+	const StateType&    state,
+	const SymbolType&   symbol) const
+{
+	const auto first = symbols_.begin() + RowBegin(state);
+	const auto last = symbols_.begin() + RowEnd(state);
+	const auto entry = std::lower_bound(first, last, symbol);
+
+	if (entry == last || *entry != symbol) {
+		Successors res = {nullptr, nullptr};
+		return res;
+	}
+	return GetSuccessors(static_cast<size_t>(entry - symbols_.begin()));
+}
+
+ExplicitFAFrozen ExplicitFiniteAutCore::Freeze() const
+{
+	return ExplicitFAFrozen(*this);
+}
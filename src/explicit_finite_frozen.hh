@@ -0,0 +1,115 @@
+/*****************************************************************************
+ *	VATA Finite Automata Library
+ *
+ *	Copyright (c) 2013	Martin Hruska <xhrusk16@stud.fit.vutbr.cz>
+ *
+ *	Description:
+ *	Header file for frozen (immutable) transition table of explicitly
+ *	represented finite automata.
+ *
+ *****************************************************************************/
+
+#ifndef _VATA_EXPLICIT_FINITE_FROZEN_HH_
+#define _VATA_EXPLICIT_FINITE_FROZEN_HH_
+
+// VATA headers
+#include <vata/vata.hh>
+
+#include "explicit_finite_aut_core.hh"
+
+// Standard library headers
+#include <vector>
+
+namespace VATA
+{
+	class ExplicitFAFrozen;
+}
+
+/*
+ * Immutable copy of transitions of an automaton stored in compressed
+ * sparse row order. Transitions of a state are stored in a contiguous
+ * row of entries sorted by symbol and every entry points to a sorted
+ * array of successors of the state under the symbol. States are used as
+ * indices of rows (states of automata are dense numbers given by
+ * translators), so finding the successors takes no hashing and computing
+ * a post does not allocate anything.
+ */
+GCC_DIAG_OFF(effc++)
+class VATA::ExplicitFAFrozen
+{
+GCC_DIAG_ON(effc++)
+public: // data types
+	typedef ExplicitFiniteAutCore::StateType StateType;
+	typedef ExplicitFiniteAutCore::SymbolType SymbolType;
+
+	/*
+	 * Range of successors of a state under a symbol
+	 */
+	struct Successors
+	{
+		const StateType* first;
+		const StateType* last;
+
+		const StateType* begin() const { return first; }
+		const StateType* end() const { return last; }
+		bool empty() const { return first == last; }
+	};
+
+private: // data members
+	std::vector<size_t> rows_; // state -> first entry of its row
+	std::vector<SymbolType> symbols_; // entry -> symbol
+	std::vector<size_t> entries_; // entry -> first successor
+	std::vector<StateType> successors_;
+	std::vector<bool> final_; // state -> is final
+
+public:
+	explicit ExplicitFAFrozen(const ExplicitFiniteAutCore& aut);
+
+	/*
+	 * Entries of the row of the given state are numbers
+	 * from RowBegin(state) to RowEnd(state)
+	 */
+	size_t RowBegin(const StateType& state) const
+	{
+		return state + 1 < rows_.size() ? rows_[state] : 0;
+	}
+
+	size_t RowEnd(const StateType& state) const
+	{
+		return state + 1 < rows_.size() ? rows_[state + 1] : 0;
+	}
+
+	const SymbolType& GetSymbol(size_t entry) const
+	{
+		return symbols_[entry];
+	}
+
+	Successors GetSuccessors(size_t entry) const
+	{
+		Successors res = {successors_.data() + entries_[entry],
+			successors_.data() + entries_[entry + 1]};
+		return res;
+	}
+
+	/*
+	 * Successors of the state under the symbol, an empty range
+	 * when there is no such transition
+	 */
+	Successors GetSuccessors(const StateType& state, const SymbolType& symbol) const;
+
+	bool IsStateFinal(const StateType& state) const
+	{
+		return state < final_.size() && final_[state];
+	}
+
+	/*
+	 * Transitions are deterministic when every state has at most one
+	 * successor under every symbol (entries are never empty)
+	 */
+	bool IsDeterministic() const
+	{
+		return successors_.size() == symbols_.size();
+	}
+};
+
+#endif
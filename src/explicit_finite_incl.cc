@@ -24,6 +24,7 @@
 #include "macrostate_cache.hh"
 #include "map_to_list.hh"
 #include "normal_form_rel.hh"
+#include "sorted_state_set.hh"
 
 namespace VATA
 {
@@ -31,12 +32,18 @@ namespace VATA
 	bool CheckFiniteAutInclusion(
 		const ExplicitFiniteAutCore&   smaller,
 		const ExplicitFiniteAutCore&   bigger,
-		const Rel&                     preorder);
+		const Rel&                     preorder,
+		ExplicitFiniteAutCore::Word*   counterexample = nullptr,
+		CacheStatistics*               cacheStatistics = nullptr);
 
-	bool CheckEquivalence(
+	template<class Rel, class Functor>
+	bool CheckFiniteAutInclusionParallel(
 		const ExplicitFiniteAutCore&   smaller,
 		const ExplicitFiniteAutCore&   bigger,
-		const InclParam&               params);
+		const Rel&                     preorder,
+		unsigned                       threads,
+		ExplicitFiniteAutCore::Word*   counterexample = nullptr,
+		CacheStatistics*               cacheStatistics = nullptr);
 
 }
 
@@ -47,8 +54,17 @@ namespace VATA
 bool VATA::ExplicitFiniteAutCore::CheckInclusion(
 	const VATA::ExplicitFiniteAutCore&    smaller,
 	const VATA::ExplicitFiniteAutCore&    bigger,
-	const VATA::InclParam&                params)
+	const VATA::InclParam&                params,
+	Word*                                 counterexample)
 {
+	// only the congruence algorithm keeps words leading to product states
+	if (nullptr != counterexample &&
+		params.GetAlgorithm() != InclParam::e_algorithm::congruences)
+	{
+		throw NotImplementedException("Counterexample of inclusion:\n" +
+			params.toString());
+	}
+
 	VATA::ExplicitFiniteAutCore newSmaller;
 	VATA::ExplicitFiniteAutCore newBigger;
 	typename AutBase::StateType states = static_cast<typename AutBase::StateType>(-1);
@@ -61,10 +77,11 @@ bool VATA::ExplicitFiniteAutCore::CheckInclusion(
 		states = VATA::AutBase::SanitizeAutsForInclusion(newSmaller, newBigger);
 	}
 
-	// if a simulation is used, a union has been already done before the simulation
+	// if a simulation is used, a union has been already done before the simulation,
+	// otherwise states of the bigger automaton are shared by the sanitized union
 	if (params.GetAlgorithm() == InclParam::e_algorithm::congruences && !params.GetUseSimulation())
 	{
-		newSmaller = UnionDisjointStates(smaller, bigger);
+		newSmaller = UnionDisjointStates(newSmaller, newBigger);
 	}
 
 	switch (params.GetOptions())
@@ -78,7 +95,8 @@ bool VATA::ExplicitFiniteAutCore::CheckInclusion(
 			typedef VATA::ExplicitFAInclusionFunctorCache<Rel,Comparator> FunctorType;
 
 			return VATA::CheckFiniteAutInclusion<Rel,FunctorType>(newSmaller,
-					newBigger, VATA::Util::Identity(states));
+					newBigger, VATA::Util::Identity(states), counterexample,
+					params.GetCacheStatistics());
 		}
 		case InclParam::ANTICHAINS_SIM:
 		{
@@ -89,69 +107,134 @@ bool VATA::ExplicitFiniteAutCore::CheckInclusion(
 			typedef VATA::ExplicitFAInclusionFunctorCache<Rel,Comparator> FunctorType;
 
 			// TODO: is it necessary to explicitly provide the template parameters?
-			return VATA::CheckFiniteAutInclusion<Rel,FunctorType>(smaller, bigger, params.GetSimulation());
+			return VATA::CheckFiniteAutInclusion<Rel,FunctorType>(smaller, bigger, params.GetSimulation(), counterexample,
+				params.GetCacheStatistics());
 		}
 		case InclParam::CONGR_BREADTH_NOSIM:
 		{
 			assert(static_cast<typename AutBase::StateType>(-1) != states);
 
 			typedef VATA::Util::Identity Rel;
-			typedef typename VATA::ExplicitFiniteAutCore::StateSet StateSet;
+			typedef VATA::SortedStateSet<StateType> StateSet;
 			typedef typename std::pair<StateSet*,StateSet*> ProductState;
 			typedef VATA::ProductStateSetBreadth<StateSet,ProductState> ProductSet;
 			typedef VATA::NormalFormRelPreorder<Rel> NormalFormRel;
 			typedef VATA::ExplicitFACongrFunctorCacheOpt<Rel,ProductSet,NormalFormRel> FunctorType;
 
-			return VATA::CheckFiniteAutInclusion<Rel,FunctorType>(newSmaller, newBigger, VATA::Util::Identity(states));
+			if (params.GetThreads() > 1)
+			{
+				return VATA::CheckFiniteAutInclusionParallel<Rel,FunctorType>(newSmaller, newBigger, VATA::Util::Identity(states),
+					params.GetThreads(), counterexample, params.GetCacheStatistics());
+			}
+			return VATA::CheckFiniteAutInclusion<Rel,FunctorType>(newSmaller, newBigger, VATA::Util::Identity(states), counterexample,
+				params.GetCacheStatistics());
 		}
 		case InclParam::CONGR_DEPTH_NOSIM:
 		{
 			assert(static_cast<typename AutBase::StateType>(-1) != states);
 
 			typedef VATA::Util::Identity Rel;
-			typedef typename VATA::ExplicitFiniteAutCore::StateSet StateSet;
+			typedef VATA::SortedStateSet<StateType> StateSet;
 			typedef typename std::pair<StateSet*,StateSet*> ProductState;
 			typedef VATA::ProductStateSetDepth<StateSet,ProductState> ProductSet;
 			typedef VATA::NormalFormRelPreorder<Rel> NormalFormRel;
 			typedef VATA::ExplicitFACongrFunctorCacheOpt<Rel,ProductSet,NormalFormRel> FunctorType;
 
-			return VATA::CheckFiniteAutInclusion<Rel,FunctorType>(newSmaller, newBigger, VATA::Util::Identity(states));
+			return VATA::CheckFiniteAutInclusion<Rel,FunctorType>(newSmaller, newBigger, VATA::Util::Identity(states), counterexample,
+				params.GetCacheStatistics());
 		}
 		case InclParam::CONGR_DEPTH_SIM:
 		{
 			typedef VATA::AutBase::StateDiscontBinaryRelation Rel;
-			typedef typename VATA::ExplicitFiniteAutCore::StateSet StateSet;
+			typedef VATA::SortedStateSet<StateType> StateSet;
 			typedef typename std::pair<StateSet*,StateSet*> ProductState;
 			typedef VATA::ProductStateSetDepth<StateSet,ProductState> ProductSet;
-			typedef VATA::NormalFormRelSimulation<Rel> NormalFormRel;
+			typedef VATA::NormalFormRelSimulation<Rel,StateSet> NormalFormRel;
+
+			typedef VATA::ExplicitFACongrFunctorCacheOpt<Rel,ProductSet,NormalFormRel> FunctorType;
+
+			return VATA::CheckFiniteAutInclusion<Rel,FunctorType>(smaller, bigger, params.GetSimulation(), counterexample,
+				params.GetCacheStatistics());
+		}
+		case InclParam::CONGR_BREADTH_SIM:
+		{
+			typedef VATA::AutBase::StateDiscontBinaryRelation Rel;
+			typedef VATA::SortedStateSet<StateType> StateSet;
+			typedef typename std::pair<StateSet*,StateSet*> ProductState;
+			typedef VATA::ProductStateSetBreadth<StateSet,ProductState> ProductSet;
+			typedef VATA::NormalFormRelSimulation<Rel,StateSet> NormalFormRel;
 
 			typedef VATA::ExplicitFACongrFunctorCacheOpt<Rel,ProductSet,NormalFormRel> FunctorType;
 
-			return VATA::CheckFiniteAutInclusion<Rel,FunctorType>(smaller, bigger, params.GetSimulation());
+			if (params.GetThreads() > 1)
+			{
+				return VATA::CheckFiniteAutInclusionParallel<Rel,FunctorType>(smaller, bigger, params.GetSimulation(),
+					params.GetThreads(), counterexample, params.GetCacheStatistics());
+			}
+			return VATA::CheckFiniteAutInclusion<Rel,FunctorType>(smaller, bigger, params.GetSimulation(), counterexample,
+				params.GetCacheStatistics());
 		}
 		case InclParam::CONGR_DEPTH_EQUIV_NOSIM:
 		{
 			assert(static_cast<typename AutBase::StateType>(-1) != states);
 
 			typedef VATA::Util::Identity Rel;
-			typedef typename VATA::ExplicitFiniteAutCore::StateSet StateSet;
+			typedef VATA::SortedStateSet<StateType> StateSet;
 			typedef typename std::pair<StateSet*,StateSet*> ProductState;
 			typedef VATA::ProductStateSetDepth<StateSet,ProductState> ProductSet;
-			typedef VATA::ExplicitFACongrEquivFunctor<Rel,ProductSet> FunctorType;
+			typedef VATA::NormalFormRelPreorder<Rel> NormalFormRel;
+			typedef VATA::ExplicitFACongrEquivFunctor<Rel,ProductSet,NormalFormRel> FunctorType;
 
-			return VATA::CheckFiniteAutInclusion<Rel,FunctorType>(newSmaller, newBigger, VATA::Util::Identity(states));
+			return VATA::CheckFiniteAutInclusion<Rel,FunctorType>(newSmaller, newBigger, VATA::Util::Identity(states), counterexample,
+				params.GetCacheStatistics());
 		}
 		case InclParam::CONGR_BREADTH_EQUIV_NOSIM:
 		{
 			assert(static_cast<typename AutBase::StateType>(-1) != states);
 
 			typedef VATA::Util::Identity Rel;
-			typedef typename VATA::ExplicitFiniteAutCore::StateSet StateSet;
+			typedef VATA::SortedStateSet<StateType> StateSet;
 			typedef typename std::pair<StateSet*,StateSet*> ProductState;
 			typedef VATA::ProductStateSetBreadth<StateSet,ProductState> ProductSet;
-			typedef VATA::ExplicitFACongrEquivFunctor<Rel,ProductSet> FunctorType;
+			typedef VATA::NormalFormRelPreorder<Rel> NormalFormRel;
+			typedef VATA::ExplicitFACongrEquivFunctor<Rel,ProductSet,NormalFormRel> FunctorType;
+
+			if (params.GetThreads() > 1)
+			{
+				return VATA::CheckFiniteAutInclusionParallel<Rel,FunctorType>(newSmaller, newBigger, VATA::Util::Identity(states),
+					params.GetThreads(), counterexample, params.GetCacheStatistics());
+			}
+			return VATA::CheckFiniteAutInclusion<Rel,FunctorType>(newSmaller, newBigger, VATA::Util::Identity(states), counterexample,
+				params.GetCacheStatistics());
+		}
+		case InclParam::CONGR_DEPTH_EQUIV_SIM:
+		{
+			typedef VATA::AutBase::StateDiscontBinaryRelation Rel;
+			typedef VATA::SortedStateSet<StateType> StateSet;
+			typedef typename std::pair<StateSet*,StateSet*> ProductState;
+			typedef VATA::ProductStateSetDepth<StateSet,ProductState> ProductSet;
+			typedef VATA::NormalFormRelSimulation<Rel,StateSet> NormalFormRel;
+			typedef VATA::ExplicitFACongrEquivFunctor<Rel,ProductSet,NormalFormRel> FunctorType;
 
-			return VATA::CheckFiniteAutInclusion<Rel,FunctorType>(newSmaller, newBigger, VATA::Util::Identity(states));
+			return VATA::CheckFiniteAutInclusion<Rel,FunctorType>(smaller, bigger, params.GetSimulation(), counterexample,
+				params.GetCacheStatistics());
+		}
+		case InclParam::CONGR_BREADTH_EQUIV_SIM:
+		{
+			typedef VATA::AutBase::StateDiscontBinaryRelation Rel;
+			typedef VATA::SortedStateSet<StateType> StateSet;
+			typedef typename std::pair<StateSet*,StateSet*> ProductState;
+			typedef VATA::ProductStateSetBreadth<StateSet,ProductState> ProductSet;
+			typedef VATA::NormalFormRelSimulation<Rel,StateSet> NormalFormRel;
+			typedef VATA::ExplicitFACongrEquivFunctor<Rel,ProductSet,NormalFormRel> FunctorType;
+
+			if (params.GetThreads() > 1)
+			{
+				return VATA::CheckFiniteAutInclusionParallel<Rel,FunctorType>(smaller, bigger, params.GetSimulation(),
+					params.GetThreads(), counterexample, params.GetCacheStatistics());
+			}
+			return VATA::CheckFiniteAutInclusion<Rel,FunctorType>(smaller, bigger, params.GetSimulation(), counterexample,
+				params.GetCacheStatistics());
 		}
 		default:
 		{
@@ -162,13 +245,17 @@ bool VATA::ExplicitFiniteAutCore::CheckInclusion(
 }
 
 /*
- * Function wrapping inclusion checking
+ * Function wrapping inclusion checking, when inclusion does not hold
+ * and the counterexample is given, the functor stores a word witnessing it,
+ * the counters of its cache of macrostates are added to the statistics
  */
 template<class Rel, class Functor>
 bool VATA::CheckFiniteAutInclusion(
 	const VATA::ExplicitFiniteAutCore&    smaller,
 	const VATA::ExplicitFiniteAutCore&    bigger,
-	const Rel&                            preorder)
+	const Rel&                            preorder,
+	VATA::ExplicitFiniteAutCore::Word*    counterexample,
+	VATA::CacheStatistics*                cacheStatistics)
 {
 	typedef Functor InclFunc;
 
@@ -196,16 +283,89 @@ bool VATA::CheckFiniteAutInclusion(
 	// Initialization of antichain sets from initial states of automata
 	inclFunc.Init();
 
-	if (!inclFunc.DoesInclusionHold()) {
-		return false;
-	}
-
-	// actually processed macro state
-	BiggerElementType procMacroState;
-	SmallerElementType procState;
+	// actually processed macro state (smaller element may be a state or
+	// a pointer to a macrostate)
+	BiggerElementType procMacroState = BiggerElementType();
+	SmallerElementType procState = SmallerElementType();
 
 	while(inclFunc.DoesInclusionHold() && next.get(procState,procMacroState)) {
 		inclFunc.MakePost(procState,procMacroState);
 	}
+
+	if (!inclFunc.DoesInclusionHold() && nullptr != counterexample) {
+		inclFunc.GetCounterexample(*counterexample);
+	}
+	if (nullptr != cacheStatistics) {
+		inclFunc.AddCacheStatistics(*cacheStatistics);
+	}
+	return inclFunc.DoesInclusionHold();
+}
+
+/*
+ * Level-synchronous version of the function above for breadth-first order.
+ * Product states of the whole level are checked sequentially (in the same
+ * order as by the sequential version), then posts of those which have not
+ * been pruned are created in parallel and merged to the todo set and to
+ * the explored product states in the sequential order again, so the result
+ * and the counterexample do not depend on the number of threads.
+ */
+template<class Rel, class Functor>
+bool VATA::CheckFiniteAutInclusionParallel(
+	const VATA::ExplicitFiniteAutCore&    smaller,
+	const VATA::ExplicitFiniteAutCore&    bigger,
+	const Rel&                            preorder,
+	unsigned                              threads,
+	VATA::ExplicitFiniteAutCore::Word*    counterexample,
+	VATA::CacheStatistics*                cacheStatistics)
+{
+	typedef Functor InclFunc;
+
+	typedef typename InclFunc::SmallerElementType SmallerElementType;
+	typedef typename InclFunc::BiggerElementType BiggerElementType;
+
+	typedef typename InclFunc::ProductStateSetType ProductStateSetType;
+	typedef typename InclFunc::ProductNextType ProductNextType;
+	typedef typename InclFunc::Antichain1Type Antichain1Type;
+
+	typedef typename InclFunc::IndexType IndexType;
+	typedef typename InclFunc::WorkerPool WorkerPool;
+
+	ProductStateSetType antichain;
+	ProductNextType next;
+	Antichain1Type singleAntichain;
+
+	IndexType index;
+	IndexType inv;
+
+	preorder.buildIndex(index,inv);
+
+	InclFunc inclFunc(antichain,next,singleAntichain,
+			smaller,bigger,index,inv,preorder);
+
+	// Initialization of antichain sets from initial states of automata
+	inclFunc.Init();
+
+	WorkerPool pool(threads);
+
+	// actually processed macro state (smaller element may be a state or
+	// a pointer to a macrostate)
+	BiggerElementType procMacroState = BiggerElementType();
+	SmallerElementType procState = SmallerElementType();
+
+	while(inclFunc.DoesInclusionHold() && next.size()) {
+		// the rest of the level stays in todo while a product state is checked
+		for (size_t levelSize = next.size(); levelSize > 0; --levelSize) {
+			next.get(procState,procMacroState);
+			inclFunc.AddToBatch(procState,procMacroState);
+		}
+		inclFunc.MakeBatchPosts(pool);
+	}
+
+	if (!inclFunc.DoesInclusionHold() && nullptr != counterexample) {
+		inclFunc.GetCounterexample(*counterexample);
+	}
+	if (nullptr != cacheStatistics) {
+		inclFunc.AddCacheStatistics(*cacheStatistics);
+	}
 	return inclFunc.DoesInclusionHold();
 }
@@ -25,6 +25,8 @@
 #include "ordered_antichain2c.hh"
 
 // standard libraries
+#include <cstdint>
+#include <unordered_map>
 #include <vector>
 #include <utility>
 
@@ -41,6 +43,7 @@ GCC_DIAG_ON(effc++)
 public : // data types
 	typedef ExplicitFAAbstractFunctor<Rel> AbstractFunctor;
 	typedef typename AbstractFunctor::ExplicitFA ExplicitFA;
+	typedef typename AbstractFunctor::FrozenFA FrozenFA;
 
 	typedef typename AbstractFunctor::StateType StateType;
 	typedef typename AbstractFunctor::StateSet StateSet;
@@ -74,6 +77,9 @@ public : // data types
 	// Key is subset of all values
 	typedef typename VATA::MapToList<const StateSet*,const StateSet*> SubSetMap;
 
+	typedef typename AntichainType::Signature Signature;
+	typedef typename AntichainType::Bits Bits;
+
 private: // data memebers
 	AntichainType& antichain_;
 	AntichainNext& next_;
@@ -82,6 +88,10 @@ private: // data memebers
 	const ExplicitFA& smaller_;
 	const ExplicitFA& bigger_;
 
+	// Transitions of the both NFA used for computing posts
+	const FrozenFA smallerFrozen_;
+	const FrozenFA biggerFrozen_;
+
 	IndexType& index_;
 	IndexType& inv_;
 
@@ -92,6 +102,10 @@ private: // data memebers
 	SubSetMap subsetMap_;
 	SubSetMap subsetNotMap_;
 
+	// Bits of states smaller than a state and signatures of cached macrostates
+	std::unordered_map<StateType,Bits> downBits_;
+	std::unordered_map<const StateSet*,Signature> signatures_;
+
 public: // constructor
 	ExplicitFAInclusionFunctorCache(AntichainType& antichain, AntichainNext& next,
 			Antichain1Type& singleAntichain,
@@ -105,14 +119,33 @@ public: // constructor
 		singleAntichain_(singleAntichain),
 		smaller_(smaller),
 		bigger_(bigger),
+		smallerFrozen_(smaller.Freeze()),
+		biggerFrozen_(bigger.Freeze()),
 		index_(index),
 		inv_(inv),
 		preorder_(preorder),
 		comparator_(preorder),
 		cache_(),
 		subsetMap_(),
-		subsetNotMap_()
-	{}
+		subsetNotMap_(),
+		downBits_(),
+		signatures_()
+	{
+		for (auto& stateToSmaller : inv_) {
+			Bits& bits = downBits_[stateToSmaller.first];
+			bits.clear();
+			for (const StateType& smallerState : stateToSmaller.second) {
+				bits.set(smallerState);
+			}
+		}
+
+		// Antichains compare just macrostates with suitable signatures
+		auto signature = [this](const BiggerElementType& set, Signature& sig) {
+			sig = GetSignature(*set);
+		};
+		antichain_.setSignature(signature);
+		next_.setSignature(signature);
+	}
 
 public: // public functions
 
@@ -121,19 +154,16 @@ public: // public functions
 		bool macroFinal=false;
 		StateSet procMacroState;
 
-		int sum = 0;
-
 		// Create macro state of initial states
 		for (StateType startState : bigger_.startStates_) {
 			procMacroState.insert(startState);
-			sum += startState;
 			macroFinal |= bigger_.IsStateFinal(startState);
 		}
 
 		// Check the initial states
 		for (StateType smallState : smaller_.startStates_) {
 			this->inclNotHold_ |= smaller_.IsStateFinal(smallState) && !macroFinal;
-			StateSet& cachedMacro = cache_.insert(sum,procMacroState);
+			StateSet& cachedMacro = cache_.insert(procMacroState);
 			this->AddNewPairToAntichain(smallState,cachedMacro);
 		}
 	}
@@ -145,27 +175,21 @@ public: // public functions
 	 */
 	void MakePost(StateType procState, BiggerElementType& procMacroState) {
 
-		auto sum = [](StateSet& set, size_t& sum) {for (auto& state : set) sum+=state;};
-
-		auto iteratorSmallerSymbolToState = smaller_.transitions_->find(procState);
-		if (iteratorSmallerSymbolToState == smaller_.transitions_->end()) {
-			return;
-		}
 		// Iterate through the all symbols in the transitions for the given state
-		for (auto& smallerSymbolToState : *(iteratorSmallerSymbolToState->second)) {
-			for (const StateType& newSmallerState : smallerSymbolToState.second) {
-				StateSet newMacroState;
+		const size_t rowEnd = smallerFrozen_.RowEnd(procState);
+		for (size_t entry = smallerFrozen_.RowBegin(procState); entry < rowEnd; ++entry) {
+			// The post macrostate is the same for all successors under the symbol
+			StateSet newMacroState;
 
-				bool IsMacroAccepting = this->CreatePostOfMacroState(
-						newMacroState,*procMacroState,smallerSymbolToState.first,
-						bigger_);
+			bool IsMacroAccepting = this->CreatePostOfMacroState(
+					newMacroState,*procMacroState,smallerFrozen_.GetSymbol(entry),
+					biggerFrozen_);
 
-				size_t macroSum = 0;
-				sum(newMacroState,macroSum);
-				// insert macrostate to cache
-				StateSet& newCachedMacro = cache_.insert(macroSum,newMacroState);
+			// insert macrostate to cache
+			StateSet& newCachedMacro = cache_.insert(newMacroState);
 
-				this->inclNotHold_ |= smaller_.IsStateFinal(newSmallerState) &&
+			for (const StateType& newSmallerState : smallerFrozen_.GetSuccessors(entry)) {
+				this->inclNotHold_ |= smallerFrozen_.IsStateFinal(newSmallerState) &&
 					!IsMacroAccepting;
 
 				if (this->inclNotHold_) {
@@ -179,7 +203,37 @@ public: // public functions
 		}
 	}
 
+	// Adds counters of the cache of macrostates to the statistics
+	void AddCacheStatistics(CacheStatistics& stats) const {
+		stats.finiteMacrostates.hits += cache_.GetHits();
+		stats.finiteMacrostates.misses += cache_.size();
+		stats.finiteMacrostateCollisions += cache_.GetCollisions();
+	}
+
 private: // private functions
+	/*
+	 * Signature of the cached macrostate, it is computed just once
+	 */
+	const Signature& GetSignature(const StateSet& set) {
+		auto res = signatures_.insert(std::make_pair(&set,Signature()));
+		Signature& sig = res.first->second;
+		if (res.second) {
+			sig.states.clear();
+			sig.down.clear();
+			for (const StateType& state : set) {
+				auto bits = downBits_.find(state);
+				sig.states.set(state);
+				if (downBits_.end() == bits) {
+					sig.down.set(state);
+				}
+				else {
+					sig.down.add(bits->second);
+				}
+			}
+		}
+		return sig;
+	}
+
 	/*
 	 * Add a new product state to the antichains sets
 	 */
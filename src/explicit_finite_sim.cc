@@ -16,24 +16,99 @@ using VATA::AutBase;
 using VATA::ExplicitFiniteAutCore;
 
 AutBase::StateDiscontBinaryRelation ExplicitFiniteAutCore::ComputeSimulation(
-	const SimParam&     /* params */) const
+	const SimParam&     params) const
 {
-	assert(false);
-	// switch (params.GetRelation())
-	// {
-	// 	case SimParam::e_sim_relation::FA_FORWARD:
-	// 	{
-	// 		return this->ComputeForwardSimulation(params);
-	// 	}
-	// 	case SimParam::e_sim_relation::FA_BACKWARD:
-	// 	{
-	// 		return this->ComputeBackwardSimulation(params);
-	// 	}
-	// 	default:
-	// 	{
-	// 		throw std::runtime_error("Unknown simulation parameters: " + params.toString());
-	// 	}
-	// }
+	switch (params.GetRelation())
+	{
+		case SimParam::e_sim_relation::FA_FORWARD:
+		{
+			return this->ComputeForwardSimulationOfStates(params.GetThreads());
+		}
+		default:
+		{
+			throw std::runtime_error("Unknown simulation parameters: " + params.toString());
+		}
+	}
+}
+
+/*
+ * Forward simulation over all states of the automaton. States are
+ * translated to a continuous range for the LTS, a final state can be
+ * simulated only by a final state, so a state simulates another one
+ * only when its language includes the language of the other one.
+ */
+AutBase::StateDiscontBinaryRelation ExplicitFiniteAutCore::ComputeForwardSimulationOfStates(
+	size_t              threads) const
+{
+	assert(nullptr != transitions_);
+
+	StateToStateMap translMap;
+	auto translate = [&translMap](const StateType& state) -> size_t {
+		return translMap.insert(std::make_pair(state, translMap.size())).first->second;
+	};
+
+	for (auto& stateClusterPair : *transitions_)
+	{
+		translate(stateClusterPair.first);
+		for (auto& symbolStateSetPair : *stateClusterPair.second)
+		{
+			for (const StateType& dstState : symbolStateSetPair.second)
+			{
+				translate(dstState);
+			}
+		}
+	}
+
+	for (const StateType& state : finalStates_)
+	{
+		translate(state);
+	}
+
+	for (const StateType& state : startStates_)
+	{
+		translate(state);
+	}
+
+	std::unordered_map<SymbolType, size_t> symbolMap;
+	VATA::ExplicitLTS lts(translMap.size());
+	for (auto& stateClusterPair : *transitions_)
+	{
+		const size_t srcState = translMap.at(stateClusterPair.first);
+		for (auto& symbolStateSetPair : *stateClusterPair.second)
+		{
+			const size_t symbol = symbolMap.insert(std::make_pair(
+				symbolStateSetPair.first, symbolMap.size())).first->second;
+			for (const StateType& dstState : symbolStateSetPair.second)
+			{
+				lts.addTransition(srcState, symbol, translMap.at(dstState));
+			}
+		}
+	}
+	lts.init();
+
+	// Final states are in the first block and the other states in the second one
+	std::vector<std::vector<size_t>> partition(2);
+	for (auto& stateIndexPair : translMap)
+	{
+		partition[this->IsStateFinal(stateIndexPair.first) ? 0 : 1].push_back(
+			stateIndexPair.second);
+	}
+
+	AutBase::StateBinaryRelation relation(2, false);
+	relation.set(0, 0, true);
+	relation.set(1, 1, true);
+	relation.set(1, 0, true); // non-final states are simulated by final states
+
+	if (partition[0].empty() || partition[1].empty())
+	{
+		partition[0].insert(partition[0].end(), partition[1].begin(), partition[1].end());
+		partition.resize(1);
+		relation = AutBase::StateBinaryRelation(1, true);
+	}
+
+	AutBase::StateBinaryRelation ltsSim = lts.computeSimulation(
+		partition, relation, translMap.size(), threads);
+	return AutBase::StateDiscontBinaryRelation(ltsSim, translMap);
 }
 
 AutBase::StateBinaryRelation ExplicitFiniteAutCore::ComputeForwardSimulation(
@@ -41,7 +116,7 @@ AutBase::StateBinaryRelation ExplicitFiniteAutCore::ComputeForwardSimulation(
 {
 	if (params.GetNumStates() != static_cast<size_t>(-1))
 	{
-		return this->ComputeForwardSimulation(params.GetNumStates());
+		return this->ComputeForwardSimulation(params.GetNumStates(), params.GetThreads());
 	}
 	else
 	{
@@ -51,9 +126,10 @@ AutBase::StateBinaryRelation ExplicitFiniteAutCore::ComputeForwardSimulation(
 
 
 AutBase::StateBinaryRelation ExplicitFiniteAutCore::ComputeForwardSimulation(
-	size_t              size) const
+	size_t              size,
+	size_t              threads) const
 {
-	return this->TranslateToLTS().computeSimulation(size);
+	return this->TranslateToLTS().computeSimulation(size, threads);
 }
 
 
@@ -18,6 +18,7 @@
 #include <memory>
 #include <unordered_set>
 #include <cstddef>
+#include <tuple>
 
 
 // VATA headers
@@ -31,6 +32,7 @@
 #include "util/shared_counter.hh"
 #include "util/shared_list.hh"
 #include "util/splitting_relation.hh"
+#include "util/worker_pool.hh"
 
 
 using VATA::Util::BinaryRelation;
@@ -39,6 +41,7 @@ using VATA::Util::SmartSet;
 using VATA::Util::CachingAllocator;
 using VATA::Util::SharedList;
 using VATA::Util::SharedCounter;
+using VATA::Util::WorkerPool;
 using VATA::Util::Convert;
 
 typedef CachingAllocator<std::vector<size_t>> VectorAllocator;
@@ -270,6 +273,29 @@ class SimulationEngine
 {
 protected:
 
+	/*
+	 * Changes of a block collected by a worker, they are applied
+	 * sequentially in the order of blocks
+	 */
+	struct BlockUpdate
+	{
+		std::vector<SplittingRelation::RowIterator> erased;
+		std::vector<std::pair<size_t, size_t>> decrements;           // (label, state)
+		std::vector<std::tuple<size_t, size_t, size_t>> counts;      // (label, state, count)
+		std::vector<std::pair<size_t, std::vector<size_t>>> removes; // (label, states)
+
+		BlockUpdate() :
+			erased(),
+			decrements(),
+			counts(),
+			removes()
+		{ }
+	};
+
+	// number of blocks processed by one parallel round (bounds the memory of
+	// collected changes)
+	static const size_t PARALLEL_CHUNK = 256;
+
 	template <class T>
 	void makeBlock(
 		const T&   states,
@@ -466,49 +492,230 @@ protected:
 			}
 		);
 
-		for (auto& b1 : preList)
+		if (!this->pool_ || (preList.size() < 2))
+		{
+			for (auto& b1 : preList)
+			{
+				SplittingRelation::Row row = this->relation_.row(b1->index_);
+
+				for (auto col = row.begin(); col != row.end(); ++col)
+				{
+					if (!removeMask[*col])
+					{
+						continue;
+					}
+
+					assert(b1->index_ != *col);
+					this->relation_.erase(col);
+
+					this->forEachDecrement(b1, this->partition_[*col],
+						[this, b1](size_t a, size_t pre){ this->decrement(b1, a, pre); }
+					);
+				}
+			}
+
+			return;
+		}
+
+		// rows of blocks are refined in parallel, changes are applied in the
+		// order of the sequential loop above
+		for (size_t first = 0; first < preList.size(); first += PARALLEL_CHUNK)
 		{
-			SplittingRelation::Row row = this->relation_.row(b1->index_);
+			const size_t count = (preList.size() - first < PARALLEL_CHUNK)
+				? (preList.size() - first) : PARALLEL_CHUNK;
 
-			for (auto col = row.begin(); col != row.end(); ++col)
+			this->pool_->run(count,
+				[this, &preList, &removeMask, first](size_t, size_t i)
+				{
+					this->collectRefinement(
+						preList[first + i], removeMask, this->updates_[i]
+					);
+				}
+			);
+
+			for (size_t i = 0; i < count; ++i)
 			{
-				if (!removeMask[*col])
+				auto b1 = preList[first + i];
+				auto& update = this->updates_[i];
+
+				for (auto& col : update.erased)
 				{
-					continue;
+					this->relation_.erase(col);
+				}
+
+				for (auto& decrement : update.decrements)
+				{
+					this->decrement(b1, decrement.first, decrement.second);
 				}
+			}
+		}
+	}
+
+	/*
+	 * Calls f(label, state) for every counter of the block b1 which is
+	 * decremented when the block b2 is removed from the row of b1
+	 */
+	template <class F>
+	void forEachDecrement(
+		Block*   b1,
+		Block*   b2,
+		F        f) const
+	{
+		for (auto a : b2->inset_)
+		{
+			if (!b1->inset_.contains(a))
+			{
+				continue;
+			}
 
-				assert(b1->index_ != *col);
-				this->relation_.erase(col);
-				auto b2 = this->partition_[*col];
+			auto elem = b2->states_;
 
-				for (auto a : b2->inset_)
+			do
+			{
+				assert(elem);
+
+				for (auto& pre : this->lts_.pre(a)[elem->index_])
 				{
-					if (!b1->inset_.contains(a))
+					f(a, pre);
+				}
+
+				elem = elem->next_;
+			} while (elem != b2->states_);
+		}
+	}
+
+	void decrement(
+		Block*   block,
+		size_t   label,
+		size_t   state)
+	{
+		if (!block->counter_.decr(label, state))
+		{
+			this->enqueueToRemove(block, label, state);
+		}
+	}
+
+	/*
+	 * Collects columns of the row of b1 to be erased and counters of b1 to be
+	 * decremented, it does not change anything, so rows of different blocks
+	 * can be processed concurrently
+	 */
+	void collectRefinement(
+		Block*                      b1,
+		const std::vector<bool>&    removeMask,
+		BlockUpdate&                update)
+	{
+		update.erased.clear();
+		update.decrements.clear();
+
+		SplittingRelation::Row row = this->relation_.row(b1->index_);
+
+		for (auto col = row.begin(); col != row.end(); ++col)
+		{
+			if (!removeMask[*col])
+			{
+				continue;
+			}
+
+			assert(b1->index_ != *col);
+			update.erased.push_back(col);
+
+			this->forEachDecrement(b1, this->partition_[*col],
+				[&update](size_t a, size_t pre){ update.decrements.push_back(std::make_pair(a, pre)); }
+			);
+		}
+	}
+
+	/*
+	 * Computes initial counters of the block b1, count(a, q, n) is called when
+	 * q has n a-successors in blocks related to b1 and remove(a, s) with the
+	 * non-empty set s of states having a-successors only outside of these
+	 * blocks; the method does not change anything
+	 */
+	template <class CountF, class RemoveF>
+	void computeCounters(
+		Block*                        b1,
+		const std::vector<SmartSet>&  delta1,
+		std::vector<bool>&            relatedBlocks,
+		SmartSet&                     s,
+		CountF                        count,
+		RemoveF                       remove)
+	{
+		auto row = this->relation_.row(b1->index_);
+
+		relatedBlocks.assign(this->partition_.size(), false);
+
+		for (auto& col : row)
+		{
+			relatedBlocks[col] = true;
+		}
+
+		for (auto& a : b1->inset())
+		{
+			for (auto q : delta1[a])
+			{
+				size_t n = 0;
+
+				for (auto r : this->lts_.post(a)[q])
+				{
+					if (relatedBlocks[this->index_[r].block_->index_])
 					{
-						continue;
+						++n;
 					}
+				}
 
-					auto elem = b2->states_;
+				if (n)
+				{
+					count(a, q, n);
+				}
+			}
 
-					do
+			s.assignFlat(delta1[a]);
+
+			for (auto& col : row)
+			{
+				auto b2 = this->partition_[col];
+				auto elem = b2->states_;
+
+				do
+				{
+					for (auto& q : this->lts_.pre(a)[elem->index_])
 					{
-						assert(elem);
+						s.remove(q);
+					}
 
-						for (auto& pre : this->lts_.pre(a)[elem->index_])
-						{
-							if (!b1->counter_.decr(a, pre))
-							{
-								this->enqueueToRemove(b1, a, pre);
-							}
-						}
+					elem = elem->next_;
+				} while (elem != b2->states_);
+			}
 
-						elem = elem->next_;
-					} while (elem != b2->states_);
-				}
+			if (!s.empty())
+			{
+				remove(a, s);
 			}
 		}
 	}
 
+	void initCounterSize(Block* b1)
+	{
+		size_t size = 0;
+
+		for (auto& a : b1->inset())
+		{
+			size = std::max(size, this->labelMap_[a].second);
+		}
+
+		b1->counter_.resize(size);
+	}
+
+	void addRemove(
+		Block*                       b1,
+		size_t                       label,
+		std::vector<size_t>*         states)
+	{
+		b1->remove_[label] = new RemoveList(states);
+		this->queue_.push_back(std::make_pair(b1, label));
+	}
+
 	static bool isPartition(
 		const std::vector<std::vector<size_t>>&    part,
 		size_t                                     states)
@@ -585,6 +792,12 @@ private:
 	std::vector<size_t> key_;
 	std::vector<std::pair<size_t, size_t>> labelMap_;
 
+	/// Workers of parallel phases (none if sequential)
+	std::unique_ptr<WorkerPool> pool_;
+
+	/// Changes collected by the actual parallel round (per task)
+	std::vector<BlockUpdate> updates_;
+
 	SimulationEngine(const SimulationEngine&);
 
 	SimulationEngine& operator=(const SimulationEngine&);
@@ -606,7 +819,8 @@ private:
 public:
 
 	SimulationEngine(
-		const VATA::ExplicitLTS& lts) :
+		const VATA::ExplicitLTS& lts,
+		size_t                   threads = 1) :
 		lts_(lts),
 		rowSize_(SimulationEngine::getRowSize(lts.states())),
 		vectorAllocator_(),
@@ -617,9 +831,17 @@ public:
 		index_(lts.states()),
 		queue_(),
 		key_(),
-		labelMap_()
+		labelMap_(),
+		pool_(),
+		updates_()
 	{
 		assert(this->index_.size());
+
+		if (threads > 1)
+		{
+			this->pool_.reset(new WorkerPool(threads));
+			this->updates_.resize(PARALLEL_CHUNK);
+		}
 	}
 
 	~SimulationEngine()
@@ -723,77 +945,83 @@ public:
 		}
 
 		// initialize counters
-		SmartSet s;
-
-		for (auto& b1 : this->partition_)
+		if (!this->pool_)
 		{
-			auto row = this->relation_.row(b1->index_);
-			std::vector<bool> relatedBlocks(this->partition_.size());
+			std::vector<bool> relatedBlocks;
+			SmartSet s;
 
-			for (auto& col : row)
+			for (auto& b1 : this->partition_)
 			{
-				relatedBlocks[col] = true;
-			}
+				this->initCounterSize(b1);
 
-			size_t size = 0;
+				this->computeCounters(b1, delta1, relatedBlocks, s,
+					[b1](size_t a, size_t q, size_t count){ b1->counter_.set(a, q, count); },
+					[this, b1](size_t a, const SmartSet& states)
+					{
+						this->addRemove(b1, a, new std::vector<size_t>(states.begin(), states.end()));
+					}
+				);
 
-			for (auto& a : b1->inset())
-			{
-				size = std::max(size, this->labelMap_[a].second);
+				b1->counter_.init();
 			}
 
-			b1->counter_.resize(size);
+			return;
+		}
+
+		// counters of blocks are computed in parallel and set in the order
+		// of blocks
+		std::vector<std::vector<bool>> relatedBlocks(this->pool_->size());
+		std::vector<SmartSet> s(this->pool_->size());
 
-			for (auto& a : b1->inset())
-			{
-				for (auto q : delta1[a])
+		for (size_t first = 0; first < this->partition_.size(); first += PARALLEL_CHUNK)
+		{
+			const size_t count = (this->partition_.size() - first < PARALLEL_CHUNK)
+				? (this->partition_.size() - first) : PARALLEL_CHUNK;
+
+			this->pool_->run(count,
+				[this, &delta1, &relatedBlocks, &s, first](size_t worker, size_t i)
 				{
-					size_t count = 0;
+					auto& update = this->updates_[i];
+					update.counts.clear();
+					update.removes.clear();
 
-					for (auto r : this->lts_.post(a)[q])
-					{
-						if (relatedBlocks[this->index_[r].block_->index_])
+					this->computeCounters(this->partition_[first + i], delta1,
+						relatedBlocks[worker], s[worker],
+						[&update](size_t a, size_t q, size_t n)
 						{
-							++count;
+							update.counts.push_back(std::make_tuple(a, q, n));
+						},
+						[&update](size_t a, const SmartSet& states)
+						{
+							update.removes.push_back(std::make_pair(
+								a, std::vector<size_t>(states.begin(), states.end())
+							));
 						}
-					}
-
-					if (count)
-					{
-						b1->counter_.set(a, q, count);
-					}
+					);
 				}
+			);
 
-				s.assignFlat(delta1[a]);
+			for (size_t i = 0; i < count; ++i)
+			{
+				auto b1 = this->partition_[first + i];
+				auto& update = this->updates_[i];
 
-				for (auto& col : row)
-				{
-					auto b2 = this->partition_[col];
-					auto elem = b2->states_;
+				this->initCounterSize(b1);
 
-					do
-					{
-						for (auto& q : this->lts_.pre(a)[elem->index_])
-						{
-							s.remove(q);
-						}
-
-						elem = elem->next_;
-					} while (elem != b2->states_);
+				for (auto& cnt : update.counts)
+				{
+					b1->counter_.set(std::get<0>(cnt), std::get<1>(cnt), std::get<2>(cnt));
 				}
 
-				if (s.empty())
+				for (auto& remove : update.removes)
 				{
-					continue;
+					this->addRemove(
+						b1, remove.first, new std::vector<size_t>(std::move(remove.second))
+					);
 				}
 
-				b1->remove_[a] = new RemoveList(new std::vector<size_t>(s.begin(), s.end()));
-				this->queue_.push_back(std::make_pair(b1, a));
-
-				assert(s.size() == b1->remove_[a]->subList()->size());
+				b1->counter_.init();
 			}
-
-			b1->counter_.init();
 		}
 	}
 
@@ -835,16 +1063,26 @@ public:
 
 		for (size_t i = 0; i < this->relation_.size(); ++i)
 		{
+			if (tmp[i].empty())
+			{
+				continue;
+			}
+
+			// states of a block have the same row, so it is filled just once
+			const size_t first = tmp[i].front();
+
 			for (auto j : const_cast<SplittingRelation*>(&this->relation_)->row(i))
 			{
-				for (auto& r : tmp[i])
+				for (auto& s : tmp[j])
 				{
-					for (auto& s : tmp[j])
-					{
-						result.set(r, s, true);
-					}
+					result.set(first, s, true);
 				}
 			}
+
+			for (size_t k = 1; k < tmp[i].size(); ++k)
+			{
+				result.unionRows(tmp[i][k], first);
+			}
 		}
 	}
 
@@ -867,17 +1105,20 @@ public:
 	}
 };
 
+const size_t SimulationEngine::PARALLEL_CHUNK;
+
 BinaryRelation VATA::ExplicitLTS::computeSimulation(
 	const std::vector<std::vector<size_t>>&   partition,
 	const BinaryRelation&                     relation,
-	size_t                                    outputSize)
+	size_t                                    outputSize,
+	size_t                                    threads)
 {
 	if (0 == outputSize)
 	{
 		return BinaryRelation();
 	}
 
-	SimulationEngine engine(*this);
+	SimulationEngine engine(*this, threads);
 
 	engine.init(partition, relation);
 	engine.run();
@@ -891,7 +1132,8 @@ BinaryRelation VATA::ExplicitLTS::computeSimulation(
 
 
 BinaryRelation VATA::ExplicitLTS::computeSimulation(
-	size_t   outputSize)
+	size_t   outputSize,
+	size_t   threads)
 {
 	std::vector<std::vector<size_t>> partition(1);
 
@@ -901,7 +1143,7 @@ BinaryRelation VATA::ExplicitLTS::computeSimulation(
 	}
 
 	return this->computeSimulation(
-		partition, Util::BinaryRelation(1, true), outputSize
+		partition, Util::BinaryRelation(1, true), outputSize, threads
 	);
 }
 
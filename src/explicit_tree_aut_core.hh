@@ -1033,7 +1033,8 @@ public:   // methods
 		const VATA::SimParam&          params) const;
 
 	StateDiscontBinaryRelation ComputeDownwardSimulation(
-		size_t                         size) const;
+		size_t                         size,
+		size_t                         threads = 1) const;
 
 	// template <class Index>
 	// AutBase::StateBinaryRelation ComputeDownwardSimulation(
@@ -1045,7 +1046,8 @@ public:   // methods
 		const VATA::SimParam&          params) const;
 
 	StateDiscontBinaryRelation ComputeUpwardSimulation(
-		size_t                         size) const;
+		size_t                         size,
+		size_t                         threads = 1) const;
 
 	// template <class Index>
 	// AutBase::StateBinaryRelation ComputeUpwardSimulation(
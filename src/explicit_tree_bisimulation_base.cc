@@ -14,138 +14,138 @@
 
 using namespace ExplicitTreeUpwardBisimulation;
 
-BisimulationBase::BisimulationBase(
+template <class StateSet>
+BisimulationBase<StateSet>::BisimulationBase(
 	const ExplicitTreeAutCore&        smaller,
-	const ExplicitTreeAutCore&        bigger)
+	const ExplicitTreeAutCore&        bigger,
+	const CheckOptions&               options)
 	: smaller(smaller), bigger(bigger),				// Input automata.
-		ranked_alphabet(), actual(),				// Init data structures.
-		todo(), done(), knownPairs(),
-		input_size(), successors(),
-		set_successors(), set_successors_iter()
+		index(smaller, bigger),						// Index of transition rules.
+		ranked_alphabet(), macrostates(), actual(),	// Init data structures.
+		todo(options.order, macrostates, smaller_final, bigger_final), knownPairs(), closure(macrostates),
+		input_size(), smaller_final(), bigger_final(),
+		partial_posts(), slot_couples(), slot_limit(),
+		sequential(), pool(), workspaces(), tasks(), results(), stop(false)
 {
-	for(auto transition : smaller)					// Calculate size of input automata (smaller).
+	for(size_t symbol = 0; symbol < index.getSymbolCount(); symbol++)
 	{
-		ranked_alphabet.insert(std::make_pair(transition.GetSymbol(), transition.GetChildrenSize()));
-		if(transition.GetSymbol() > input_size.alphabet)
-			input_size.alphabet = transition.GetSymbol();
-		if(transition.GetChildrenSize() > input_size.arity)
-			input_size.arity = transition.GetChildrenSize();
-		if(transition.GetParent() > input_size.states)
-			input_size.states = transition.GetParent();
-		for(auto state : transition.GetChildren())
-			if(state > input_size.states)
-				input_size.states = state;
+		ranked_alphabet.insert(std::make_pair(symbol, index.getArity(symbol)));
 	}
-	for(auto transition : bigger)					// Calculate size of input automata (bigger).
-	{
-		ranked_alphabet.insert(std::make_pair(transition.GetSymbol(), transition.GetChildrenSize()));
-		if(transition.GetSymbol() > input_size.alphabet)
-			input_size.alphabet = transition.GetSymbol();
-		if(transition.GetChildrenSize() > input_size.arity)
-			input_size.arity = transition.GetChildrenSize();
-		if(transition.GetParent() > input_size.states)
-			input_size.states = transition.GetParent();
-		for(auto state : transition.GetChildren())
-			if(state > input_size.states)
-				input_size.states = state;
-	}
-	input_size.alphabet++;			// Size adjustment.
-	input_size.states++;
-
-	// Create array to hold matrix representation of transition rules (of appropriate size).
-	successors = new StateSet **[input_size.alphabet]();
-    for (size_t i = 0; i < input_size.alphabet; i++)
-    {
-        successors[i] = new StateSet *[input_size.arity]();
-        for (size_t j = 0; j < input_size.arity; j++)
-            successors[i][j] = new StateSet [input_size.states]();
-    }
-	
-	// Create maps for holding successors of macrostates (for specific symbol)
-	set_successors = new std::unordered_map<StateSet, StateSet, StateSetHash> *[input_size.alphabet]();
-    for (size_t i = 0; i < input_size.alphabet; i++)
-    {
-		// Create maps for holding successors of macrostates (for specific position)
-        set_successors[i] = new std::unordered_map<StateSet, StateSet, StateSetHash>[input_size.arity]();
-    }
-
-	// Fill in matrix representation of transition rules (smaller).
-	for(auto transition : smaller)
+
+	// Size of input automata.
+	input_size.alphabet = index.getSymbolCount();
+	input_size.arity = index.getMaxArity();
+	input_size.states = index.getStateCount();
+
+	for(auto state : smaller.GetFinalStates())		// Final states in macrostate representation.
+		smaller_final.insert(state);
+	for(auto state : bigger.GetFinalStates())
+		bigger_final.insert(state);
+
+	// Create maps for holding partial posts of macrostates (for specific symbol and position).
+	partial_posts.resize(index.getSlotCount());
+	slot_couples.resize(index.getSlotCount());
+	slot_limit.resize(index.getSlotCount());
+
+	// Buffers of sequential computation and of workers.
+	sequential.contexts.resize(index.getMaxArity());
+	if(options.threads > 1)
 	{
-		if (transition.GetChildrenSize() == 0)
-		{
-			successors[transition.GetSymbol()][0][0].insert(transition.GetParent());
-		}
-		for(size_t pos = 0; pos < transition.GetChildrenSize(); pos++)
+		pool.reset(new WorkerPool(options.threads));
+		workspaces.resize(options.threads);
+		for(auto &workspace : workspaces)
 		{
-			successors[transition.GetSymbol()][pos][transition.GetChildren()[pos]].insert(transition.GetParent());
+			workspace.contexts.resize(index.getMaxArity());
 		}
 	}
-	// Fill in matrix representation of transition rules (bigger).
-	for(auto transition : bigger)
+
+	if(options.simulation)
+	{
+		addSimulation();
+	}
+}
+
+
+template <class StateSet>
+BisimulationBase<StateSet>::~BisimulationBase()
+{
+}
+
+// Remove 0-arity symbols from alphabet.
+template <class StateSet>
+void BisimulationBase<StateSet>::pruneRankedAlphabet()
+{
+	for(auto iter = ranked_alphabet.begin(); iter != ranked_alphabet.end(); )
 	{
-		if (transition.GetChildrenSize() == 0)
+		if(iter->second == 0)
 		{
-			successors[transition.GetSymbol()][0][1].insert(transition.GetParent());
+			iter = ranked_alphabet.erase(iter);
 		}
-		for(size_t pos = 0; pos < transition.GetChildrenSize(); pos++)
+		else
 		{
-			successors[transition.GetSymbol()][pos][transition.GetChildren()[pos]].insert(transition.GetParent());
+			iter++;
 		}
 	}
 }
 
-
-BisimulationBase::~BisimulationBase()
+/*
+ * Upward simulation implies inclusion of languages of contexts of states, so
+ * a macrostate can be saturated by states simulated by its states without
+ * changing its language. Simulation is computed on union of input automata
+ * (their states are disjoint).
+ */
+template <class StateSet>
+void BisimulationBase<StateSet>::addSimulation()
 {
-	// Free data structures.
-	for (size_t i = 0; i < input_size.alphabet; i++)
+	if(input_size.states == 0)
 	{
-		for (size_t j = 0; j < input_size.arity; j++)
-			delete[] successors[i][j];
-		delete[] successors[i];
+		return;
 	}
-	delete[] successors;
 
+	AutBase::StateDiscontBinaryRelation simulation =
+		ExplicitTreeAutCore::UnionDisjointStates(smaller, bigger).ComputeUpwardSimulation(
+			input_size.states, pool ? pool->size() : 1);
 
-	for (size_t i = 0; i < input_size.alphabet; i++)
+	AutBase::StateDiscontBinaryRelation::IndexType upper, lower;
+	simulation.buildIndex(upper, lower);
+	for(const auto &simulating : lower)
 	{
-		delete[] set_successors[i];
-	}
-	delete[] set_successors;
-}
-
-// Remove 0-arity symbols from alphabet.
-void BisimulationBase::pruneRankedAlphabet()
-{
-	for(auto symbol : ranked_alphabet)
-	{
-		if(symbol.second == 0)
+		for(auto state : simulating.second)
 		{
-			ranked_alphabet.erase(symbol);
+			closure.addSimulation(state, simulating.first);
 		}
 	}
 }
 
 // Calculate macrostate pairs reachable using leaf rules.
-void BisimulationBase::getLeafCouples()
+template <class StateSet>
+void BisimulationBase<StateSet>::getLeafCouples()
 {
 	for(auto symbol : ranked_alphabet){
 		if(symbol.second == 0)
 		{
-			todo.insert(std::make_pair(successors[symbol.first][0][0], successors[symbol.first][0][1]));
-			done.insert(std::make_pair(successors[symbol.first][0][0], successors[symbol.first][0][1]));
-			knownPairs.insert(std::make_pair(successors[symbol.first][0][0], successors[symbol.first][0][1]));
+			SuccessorIndex::StateRange smaller_leaves = index.getLeaves(symbol.first, false);
+			SuccessorIndex::StateRange bigger_leaves = index.getLeaves(symbol.first, true);
+			StateSet first, second;
+			first.insert(smaller_leaves.first, smaller_leaves.second);
+			second.insert(bigger_leaves.first, bigger_leaves.second);
+			IdCouple leaf(macrostates.intern(std::move(first)), macrostates.intern(std::move(second)));
+			if(knownPairs.insert(leaf))
+			{
+				todo.push(leaf);
+				closure.addPending(leaf);
+			}
 		}
 	}
 }
 
 // Check if leaf pairs are equivalent
-bool BisimulationBase::areLeavesEquivalent()
+template <class StateSet>
+bool BisimulationBase<StateSet>::areLeavesEquivalent()
 {
-	for(auto couple : todo)
+	for(const auto &entry : todo)
 	{
-		if(!isCoupleFinalStateEquivalent(couple))
+		if(!isCoupleFinalStateEquivalent(entry.couple))
 		{
 			return false;
 		}
@@ -153,151 +153,323 @@ bool BisimulationBase::areLeavesEquivalent()
 	return true;
 }
 
-bool BisimulationBase::getPost(RankedSymbol &symbol)
+/*
+ * Successors of actual are contexts f(P1, ..., Pn) with actual at some
+ * position and processed pairs at the others. Partial post of a macrostate at
+ * a position is the set of transitions with some of its states there.
+ * Transitions of the partial post of actual are filtered position by position
+ * by the macrostates of combined pairs and the successor of a context is the
+ * set of parents of the remaining transitions. Only processed pairs with
+ * non-empty partial post at a position are combined, since others give empty
+ * contexts. Positions before actual use only pairs processed before it, so
+ * each context is created once.
+ */
+template <class StateSet>
+bool BisimulationBase<StateSet>::getPost(const RankedSymbol &symbol)
 {
-	StateSetCouple next;
-	// Calculate successors for 1-arity symbols.
-	if(symbol.second == 1)
+	indexActual(symbol);
+
+	// Actual at each position.
+	for(size_t pos = 0; pos < symbol.second; pos++)
 	{
-		getPostAtFixedPos(next, actual, symbol.first, 0);
-		if(!todoInsert(next))
+		size_t slot = index.getSlot(symbol.first, pos);
+		if(slot_limit[slot] == slot_couples[slot].size())
+			continue;
+		if(!combineContext(symbol, pos, 0,
+			getPartialPost(actual.first, symbol.first, pos),
+			getPartialPost(actual.second, symbol.first, pos), sequential))
 			return false;
 	}
-	// Calculate successors for 2-arity symbols.
-	else if (symbol.second == 2)
-	{
-		StateSet empty;
-		// Actual at the first position.
-		getPostAtFixedPos(next, actual, symbol.first, 0);
-		if(!next.first.empty() || !next.second.empty())
-			for(auto pair : done)
-			{
-				StateSetCouple context;
-				// Context at second position.
-				getPostAtFixedPos(context, pair, symbol.first, 1);
-				context.first = intersection(context.first, next.first);
-				context.second = intersection(context.second, next.second);
-				if(!todoInsert(context))
-					return false;
-			}
+	return true;
+}
 
-		next.first.clear();
-		next.second.clear();
-		// Actual at second position.
-		getPostAtFixedPos(next, actual, symbol.first, 1);
-		if(!next.first.empty() || !next.second.empty())
-			for(auto pair : done)
-			{
-				StateSetCouple context;
-				// Context at the first position.
-				getPostAtFixedPos(context, pair, symbol.first, 0);
-				context.first = intersection(context.first, next.first);
-				context.second = intersection(context.second, next.second);
-				if(!todoInsert(context))
-					return false;
-			}
+// Calculate successors of actual for all symbols.
+template <class StateSet>
+bool BisimulationBase<StateSet>::getPosts()
+{
+	if(pool)
+	{
+		return getParallelPosts();
 	}
-	// Calculate successors for 3+-arity symbols.
-	else
+	for(const auto &symbol : ranked_alphabet)
 	{
-		// Currently not supported.
-		throw NotImplementedException(__func__);
-	}	
+		if(!getPost(symbol))
+			return false;
+	}
 	return true;
 }
 
-// Calculate possible successors for given pair at given position.
-void BisimulationBase::getPostAtFixedPos(StateSetCouple &next, StateSetCouple &pair, size_t symbol, size_t pos)
+// Index partial posts of actual (the last processed pair).
+template <class StateSet>
+void BisimulationBase<StateSet>::indexActual(const RankedSymbol &symbol)
 {
-	// Check if successor for this macrostate at this position was already calculated (in smaller).
-	set_successors_iter = set_successors[symbol][pos].find(pair.first);
-	if(set_successors_iter != set_successors[symbol][pos].end())
+	for(size_t pos = 0; pos < symbol.second; pos++)
 	{
-		// Use found successor.
-		for(auto parent : set_successors_iter->second)
-			next.first.insert(parent);
+		size_t slot = index.getSlot(symbol.first, pos);
+		slot_limit[slot] = slot_couples[slot].size();
+		if(!getPartialPost(actual.first, symbol.first, pos).empty() ||
+			!getPartialPost(actual.second, symbol.first, pos).empty())
+			slot_couples[slot].push_back(actual);
 	}
-	else
+}
+
+/*
+ * Parallel computation of successors of actual. Contexts of all symbols are
+ * split into tasks by the symbol, position of actual and a range of processed
+ * pairs at the first other position, in the order of sequential computation.
+ * Partial posts of actual are computed beforehand, so during a round workers
+ * only read the shared structures (index, partial posts, interned
+ * macrostates and known pairs) and no locking is needed. Workers drop
+ * successors already known and check final states of new ones; the first
+ * counterexample stops all workers. Successors of tasks are then interned and
+ * inserted into todo in order of tasks, so pairs are explored exactly as in
+ * sequential computation regardless of the number of threads.
+ */
+template <class StateSet>
+bool BisimulationBase<StateSet>::getParallelPosts()
+{
+	tasks.clear();
+	size_t work = 0;
+	for(const auto &symbol : ranked_alphabet)
 	{
-		// Compute successor and store it for later use.
-		auto iter = set_successors[symbol][pos].emplace(std::make_pair(pair.first, StateSet()));
-		for(auto state : pair.first)
+		indexActual(symbol);
+		for(size_t fixed = 0; fixed < symbol.second; fixed++)
 		{
-			for(auto parent : successors[symbol][pos][state])
+			size_t slot = index.getSlot(symbol.first, fixed);
+			if(slot_limit[slot] == slot_couples[slot].size())
+				continue;
+
+			PostTask task(symbol, fixed,
+				&getPartialPost(actual.first, symbol.first, fixed),
+				&getPartialPost(actual.second, symbol.first, fixed));
+			size_t size = task.first->size() + task.second->size();
+
+			// Unary symbol has a single context.
+			size_t pos = fixed == 0 ? 1 : 0;
+			if(pos == symbol.second)
+			{
+				tasks.push_back(task);
+				work += size;
+				continue;
+			}
+
+			size_t other = index.getSlot(symbol.first, pos);
+			size_t count = pos < fixed ? slot_limit[other] : slot_couples[other].size();
+			for(size_t begin = 0; begin < count; begin += TASK_COUPLES)
 			{
-				next.first.insert(parent);
-				iter.first->second.insert(parent);
+				task.begin = begin;
+				task.end = std::min(begin + TASK_COUPLES, count);
+				tasks.push_back(task);
+				work += size * (task.end - task.begin);
 			}
 		}
 	}
 
-	// Check if successor for this macrostate at this position was already calculated (in bigger).
-	set_successors_iter = set_successors[symbol][pos].find(pair.second);
-	if(set_successors_iter != set_successors[symbol][pos].end())
+	results.resize(std::max(results.size(), tasks.size()));
+	for(size_t i = 0; i < tasks.size(); i++)
 	{
-		// Use found successor.
-		for(auto parent : set_successors_iter->second)
-			next.second.insert(parent);
+		results[i].clear();
+	}
+
+	if(tasks.size() < 2 || work < PARALLEL_WORK_LIMIT)
+	{
+		// Small rounds are not worth waking up workers.
+		for(size_t i = 0; i < tasks.size(); i++)
+		{
+			workspaces[0].output = &results[i];
+			if(!runTask(tasks[i], workspaces[0]))
+				return false;
+		}
 	}
 	else
 	{
-		// Compute successor and store it for later use.
-		auto iter = set_successors[symbol][pos].emplace(std::make_pair(pair.second, StateSet()));
-		for(auto state : pair.second)
+		pool->run(tasks.size(), [this](size_t worker, size_t i)
 		{
-			for(auto parent : successors[symbol][pos][state])
-			{
-				next.second.insert(parent);
-				iter.first->second.insert(parent);
-			}
+			if(stop.load(std::memory_order_relaxed))
+				return;
+			workspaces[worker].output = &results[i];
+			runTask(tasks[i], workspaces[worker]);
+		});
+		if(stop.load())
+			return false;
+	}
+
+	// Merge successors in order of tasks.
+	for(size_t i = 0; i < tasks.size(); i++)
+	{
+		for(auto &context : results[i])
+		{
+			IdCouple next(macrostates.intern(std::move(context.first)), macrostates.intern(std::move(context.second)));
+			if(!todoInsert(next))
+				return false;
 		}
 	}
+	return true;
+}
+
+// Compute contexts of one task of parallel computation.
+template <class StateSet>
+bool BisimulationBase<StateSet>::runTask(const PostTask &task, Workspace &workspace)
+{
+	size_t pos = task.fixed == 0 ? 1 : 0;
+	if(pos == task.symbol.second)
+	{
+		return emitContext(*task.first, *task.second, workspace);
+	}
+	return combineCouples(task.symbol, task.fixed, pos, task.begin, task.end,
+		*task.first, *task.second, workspace);
+}
+
+// Combine partial posts of processed pairs at positions from pos on.
+template <class StateSet>
+bool BisimulationBase<StateSet>::combineContext(const RankedSymbol &symbol, size_t fixed, size_t pos,
+	const TransitionSet &first, const TransitionSet &second, Workspace &workspace)
+{
+	if(pos == fixed)
+	{
+		return combineContext(symbol, fixed, pos + 1, first, second, workspace);
+	}
+	if(pos == symbol.second)
+	{
+		return emitContext(first, second, workspace);
+	}
+
+	size_t slot = index.getSlot(symbol.first, pos);
+	size_t count = pos < fixed ? slot_limit[slot] : slot_couples[slot].size();
+	return combineCouples(symbol, fixed, pos, 0, count, first, second, workspace);
+}
+
+// Combine partial posts with given range of processed pairs at position pos.
+template <class StateSet>
+bool BisimulationBase<StateSet>::combineCouples(const RankedSymbol &symbol, size_t fixed, size_t pos,
+	size_t begin, size_t end, const TransitionSet &first, const TransitionSet &second, Workspace &workspace)
+{
+	const std::vector<IdCouple> &couples = slot_couples[index.getSlot(symbol.first, pos)];
+	std::pair<TransitionSet, TransitionSet> &context = workspace.contexts[pos];
+	for(size_t i = begin; i < end; i++)
+	{
+		if(workspace.output != nullptr && stop.load(std::memory_order_relaxed))
+			return false;
+		filterTransitions(first, pos, couples[i].first, context.first);
+		filterTransitions(second, pos, couples[i].second, context.second);
+		// Empty context stays empty.
+		if(context.first.empty() && context.second.empty())
+			continue;
+		if(!combineContext(symbol, fixed, pos + 1, context.first, context.second, workspace))
+			return false;
+	}
+	return true;
+}
+
+// Get successor of complete context and insert it into todo (or output of parallel task).
+template <class StateSet>
+bool BisimulationBase<StateSet>::emitContext(const TransitionSet &first, const TransitionSet &second,
+	Workspace &workspace)
+{
+	StateSet next_first, next_second;
+	getParents(first, next_first, workspace);
+	getParents(second, next_second, workspace);
+	if(workspace.output == nullptr)
+	{
+		IdCouple next(macrostates.intern(std::move(next_first)), macrostates.intern(std::move(next_second)));
+		return todoInsert(next);
+	}
+
+	// Known pairs were checked already.
+	MacrostateId first_id = macrostates.find(next_first);
+	MacrostateId second_id = macrostates.find(next_second);
+	if(first_id != MacrostateTable<StateSet>::NO_ID && second_id != MacrostateTable<StateSet>::NO_ID &&
+		knownPairs.contains(IdCouple(first_id, second_id)))
+		return true;
+
+	if(!areFinalStateEquivalent(next_first, next_second))
+	{
+		stop.store(true);
+		return false;
+	}
+	workspace.output->emplace_back(std::move(next_first), std::move(next_second));
+	return true;
+}
+
+// Get partial post of macrostate at given position (computed once and stored for later use).
+template <class StateSet>
+const TransitionSet& BisimulationBase<StateSet>::getPartialPost(MacrostateId set, size_t symbol, size_t pos)
+{
+	PartialPostMap &known = partial_posts[index.getSlot(symbol, pos)];
+	auto iter = known.find(set);
+	if(iter != known.end())
+	{
+		return iter->second;
+	}
+
+	std::vector<StateType> &buffer = sequential.buffer;
+	buffer.clear();
+	for(auto state : macrostates.get(set))
+	{
+		SuccessorIndex::TransitionRange transitions = index.getTransitions(symbol, pos, state);
+		buffer.insert(buffer.end(), transitions.first, transitions.second);
+	}
+	TransitionSet post;
+	post.insert(buffer.begin(), buffer.end());
+	return known.emplace(set, std::move(post)).first->second;
+}
+
+// Get transitions with child at given position from macrostate.
+template <class StateSet>
+void BisimulationBase<StateSet>::filterTransitions(const TransitionSet &transitions, size_t pos,
+	MacrostateId set_id, TransitionSet &result)
+{
+	const StateSet &set = macrostates.get(set_id);
+	result.clear();
+	for(auto transition : transitions)
+	{
+		if(set.contains(index.getChild(transition, pos)))
+			result.insert(transition);
+	}
+}
+
+// Get parents of given transitions.
+template <class StateSet>
+void BisimulationBase<StateSet>::getParents(const TransitionSet &transitions, StateSet &parents,
+	Workspace &workspace)
+{
+	std::vector<StateType> &buffer = workspace.buffer;
+	buffer.clear();
+	for(auto transition : transitions)
+	{
+		buffer.push_back(index.getParent(transition));
+	}
+	parents.insert(buffer.begin(), buffer.end());
+}
+
+// Check if pair is equivalent.
+template <class StateSet>
+bool BisimulationBase<StateSet>::isCoupleFinalStateEquivalent(const IdCouple &couple)
+{
+	return areFinalStateEquivalent(macrostates.get(couple.first), macrostates.get(couple.second));
 }
 
 // Insert successor into Todo.
-bool BisimulationBase::todoInsert(StateSetCouple &next)
+template <class StateSet>
+bool BisimulationBase<StateSet>::todoInsert(const IdCouple &next)
 {
-	// Check for duplicates.
-	if(knownPairs.find(next) == knownPairs.end())
+	// Check for duplicates and add to KnownPairs.
+	if(knownPairs.insert(next))
 	{
-		// Add to KnownPairs.
-		knownPairs.emplace(next);
 		// Check equivalence.
 		if(!isCoupleFinalStateEquivalent(next))
 		{
 			return false;
 		}
 		// Add to Todo.
-		todo.emplace(next);
+		todo.push(next);
+		closure.addPending(next);
 	}
 	return true;
 }
 
-// Check if expandee can be expanded by expander.
-Expandable BisimulationBase::isExpandableBy(StateSet &expandee, StateSetCouple &expander)
-{
-	// If a macrostate is a subset of other macrostate it can be expanded.
-	bool first_subset = isSubset(expander.first, expandee);
-	bool second_subset = isSubset(expander.second, expandee);
-	if (first_subset && second_subset)
-		return Both;
-	if (first_subset)
-		return Second;
-	if (second_subset)
-		return First;
-	return None;
-}
+template <class StateSet> const size_t BisimulationBase<StateSet>::TASK_COUPLES;
+template <class StateSet> const size_t BisimulationBase<StateSet>::PARALLEL_WORK_LIMIT;
 
-// Check if expandee can be expanded by expander.
-Expandable BisimulationBase::isExpandableBy(StateSet &expandee, StateSetCoupleIter expander)
-{
-	bool first_subset = isSubset(expander->first, expandee);
-	bool second_subset = isSubset(expander->second, expandee);
-	if (first_subset && second_subset)
-		return Both;
-	if (first_subset)
-		return Second;
-	if (second_subset)
-		return First;
-	return None;
-}
+template class ExplicitTreeUpwardBisimulation::BisimulationBase<DenseStateSet>;
+template class ExplicitTreeUpwardBisimulation::BisimulationBase<SparseStateSet>;
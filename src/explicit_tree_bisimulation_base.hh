@@ -14,123 +14,112 @@
 
 
 #include "explicit_tree_aut_core.hh"
+#include "explicit_tree_bisimulation_macrostate.hh"
+#include "explicit_tree_bisimulation_closure.hh"
+#include "explicit_tree_bisimulation_successors.hh"
+#include "explicit_tree_bisimulation_todo.hh"
+#include "util/worker_pool.hh"
 #include <vata/explicit_tree_aut.hh>
 
-namespace ExplicitTreeUpwardBisimulation{ 
-	using namespace VATA;
-
-	struct TodoComparator;										// Defines order of pairs stored in TodoSet.
-
-	using StateType      = ExplicitTreeAutCore::StateType;
-	using SymbolType     = ExplicitTreeAutCore::SymbolType;
-	using Transition	 = ExplicitTreeAut::Transition;
-
-	typedef std::set <StateType> StateSet;						// Macrostate.
-	typedef std::pair <StateSet, StateSet> StateSetCouple;		// Macrostate pair.
-	typedef std::set <StateSetCouple> StateSetCoupleSet;		// Set of macrostate pairs.
-	typedef std::set <StateSetCouple, TodoComparator> TodoSet;	// Ordered set of macrostate pairs.
-
-	typedef StateSetCoupleSet::iterator StateSetCoupleIter;
+#include <atomic>
 
+namespace ExplicitTreeUpwardBisimulation{ 
 	typedef std::vector<bool> Bitmap;
 
-	typedef std::pair<SymbolType, size_t> RankedSymbol;			// Symbol + arity.
-	typedef std::set<RankedSymbol> RankedAlphabet;				// Set of ranked symbols.
-
 	struct InputSize {											// Automaton size description.
 		size_t alphabet;
 		size_t arity;
 		size_t states;
 	};
 
-	struct TodoComparator {										// Ordering on macrostate pairs.
-		bool operator() (const StateSetCouple& lhs, const StateSetCouple& rhs) const {
-			if (lhs.first.size() + lhs.second.size() < rhs.first.size() + rhs.second.size())
-				return true;
-			if (lhs.first.size() + lhs.second.size() > rhs.first.size() + rhs.second.size())
-				return false;
-			return lhs < rhs;
-		}
-	};
+	struct CheckOptions {										// Options of inclusion/equivalence check.
+		size_t threads;											// Number of worker threads (1 is sequential).
+		TodoOrder order;										// Order of processing pairs.
+		bool simulation;										// Use upward simulation in congruence closure.
 
-	struct StateSetHash											// Macrostate hashing function.
-	{
-		std::size_t operator () (const StateSet &p) const
-		{
-			size_t hash = 0;
-			for(auto item : p)
-			{
-				boost::hash_combine(hash, item);
-			}
-			return hash;
-		}
+		CheckOptions() : threads(1), order(TodoOrder::size), simulation(false) {}
 	};
 
-	enum Expandable {											// Expandability for fixpoint calculation, used in congruence closure calculation.
-		None,													// Neither macrostate from given pair can be expanded.
-		First,													// First macrostate can be expanded.
-		Second,													// Second macrostate can be expanded.
-		Both													// Both can be expanded.
-	};
-	
-	template <typename type> bool isMember(type item, std::set<type> &set)		// Membership checking function.
-	{
-		return set.find(item) != set.end();
-	}
+GCC_DIAG_OFF(effc++)
+	template <class StateSet>
+	class BisimulationBase{	
+GCC_DIAG_ON(effc++)
+		public:
+			typedef TodoScheduler<StateSet> TodoSet;	// Scheduled macrostate pairs.
+			typedef VATA::Util::WorkerPool WorkerPool;	// Workers of parallel rounds.
+			typedef std::unordered_map<MacrostateId, TransitionSet> PartialPostMap;	// Partial posts of macrostates.
+			typedef std::vector<std::pair<StateSet, StateSet>> ContextList;		// Successors found by a task.
 
-	template <typename type> std::set<type> intersection(std::set<type> &left, std::set<type> &right)
-	{																			// Compute set intersection.
-		std::set<type> intersect;
-		set_intersection(
-			left.begin(),
-			left.end(),
-			right.begin(),
-			right.end(),
-			std::inserter(intersect, intersect.begin())
-		);
-		return intersect;
-	}
+GCC_DIAG_OFF(effc++)
+			struct Workspace{							// Buffers of thread computing contexts.
+GCC_DIAG_ON(effc++)
+				std::vector<StateType> buffer;			// States or transitions collected for a new set.
+				std::vector<std::pair<TransitionSet, TransitionSet>> contexts;	// Partial contexts (per position).
+				ContextList *output;					// Successors of parallel task, null inserts them directly.
 
-	template <typename type> bool isSubset(const std::set<type> &left, const std::set<type> &right)
-	{																			// Inclusion checking function.
-		auto r = right.begin();
-		auto re = right.end();
-		for(auto l = left.begin(); l != left.end(); l++)
-		{
-			while(r != re && *r < *l){
-				r++;
-			}
-			if(r == re || *r > *l)
-			{
-				return false;
-			}	
-		}	
-		return true;
-	}
+				Workspace() : buffer(), contexts(), output(nullptr) {}
+			};
 
 GCC_DIAG_OFF(effc++)
-	class BisimulationBase{	
+			struct PostTask{							// Contexts of symbol with actual at fixed position.
 GCC_DIAG_ON(effc++)
+				RankedSymbol symbol;
+				size_t fixed;
+				size_t begin, end;						// Range of processed pairs at first other position.
+				const TransitionSet *first, *second;	// Partial posts of actual at fixed position.
+
+				PostTask(const RankedSymbol &symbol, size_t fixed, const TransitionSet *first, const TransitionSet *second)
+					: symbol(symbol), fixed(fixed), begin(0), end(0), first(first), second(second) {}
+			};
+
+			static const size_t TASK_COUPLES = 16;		// Processed pairs combined by one task.
+			static const size_t PARALLEL_WORK_LIMIT = 4096;	// Least work of a round run in parallel.
+
 		protected:
 			ExplicitTreeAutCore smaller;				// Input automata.
 			ExplicitTreeAutCore bigger;
 
-			RankedAlphabet ranked_alphabet;				// Alphabet of input automata.
+			SuccessorIndex index;						// Transitions of input automata.
+			RankedAlphabet ranked_alphabet;				// Alphabet of input automata (dense symbols).
 
-			StateSetCouple actual;						// Currently processed pair.
+			MacrostateTable<StateSet> macrostates;		// Interned macrostates.
+			IdCouple actual;							// Currently processed pair.
 
 			TodoSet todo;								// Set uf pairs to be processed.
-			StateSetCoupleSet done, knownPairs;			// Expanded and visited pairs.
+			CoupleSet knownPairs;						// Visited pairs.
+			CongruenceClosure<StateSet> closure;		// Rewriting rules of visited pairs.
 
 			InputSize input_size;						// Automata size.
-			StateSet*** successors;						// Array holding matrix representation of transition rules.
-			std::unordered_map<StateSet, StateSet, StateSetHash>** set_successors;		// Map holding successors of known macrostates.
-			std::unordered_map<StateSet, StateSet, StateSetHash>::iterator set_successors_iter;
+			StateSet smaller_final, bigger_final;		// Final states of input automata.
+			std::vector<PartialPostMap> partial_posts;	// Partial posts of known macrostates (per slot).
+			std::vector<std::vector<IdCouple>> slot_couples;	// Processed pairs with non-empty partial post (per slot).
+			std::vector<size_t> slot_limit;				// Number of slot couples processed before actual.
+
+			Workspace sequential;						// Buffers of sequential computation.
+			std::unique_ptr<WorkerPool> pool;			// Workers of parallel computation (none if sequential).
+			std::vector<Workspace> workspaces;			// Buffers of workers.
+			std::vector<PostTask> tasks;				// Tasks of actual round.
+			std::vector<ContextList> results;			// Successors found by tasks of actual round.
+			std::atomic<bool> stop;						// Counterexample found by some worker.
+
+			const TransitionSet& getPartialPost(MacrostateId set, size_t symbol, size_t pos);	// Transitions with macrostate at position.
+			void getParents(const TransitionSet &transitions, StateSet &parents, Workspace &workspace);	// Parents of transitions.
+			void filterTransitions(const TransitionSet &transitions, size_t pos,
+				MacrostateId set, TransitionSet &result);						// Transitions with child from macrostate.
+			void indexActual(const RankedSymbol &symbol);						// Add actual to processed pairs of symbol.
+			bool combineContext(const RankedSymbol &symbol, size_t fixed, size_t pos,
+				const TransitionSet &first, const TransitionSet &second, Workspace &workspace);	// Combine partial posts of processed pairs.
+			bool combineCouples(const RankedSymbol &symbol, size_t fixed, size_t pos, size_t begin, size_t end,
+				const TransitionSet &first, const TransitionSet &second, Workspace &workspace);	// Combine range of processed pairs at position.
+			bool emitContext(const TransitionSet &first, const TransitionSet &second, Workspace &workspace);	// Successor of complete context.
+			bool runTask(const PostTask &task, Workspace &workspace);			// Contexts of one task.
+			bool getParallelPosts();											// Calculate successors of actual using workers.
 
 		public:
 			BisimulationBase(
 				const ExplicitTreeAutCore&        smaller,
-				const ExplicitTreeAutCore&        bigger
+				const ExplicitTreeAutCore&        bigger,
+				const CheckOptions&               options = CheckOptions()
 			);
 			
 			virtual ~BisimulationBase();
@@ -138,20 +127,37 @@ GCC_DIAG_ON(effc++)
 			virtual bool check() = 0;			// Inclusion/equivalence check function.
 
 			void pruneRankedAlphabet();			// Removal of 0-arity symbols from alphabet.
+			void addSimulation();				// Add upward simulation of input automata to congruence closure.
 
 			void getLeafCouples();				// Create macrostate pairs from leaf rules.
 			bool areLeavesEquivalent();			// Check if pairs from leaf rules are equal.
-			virtual bool isCoupleFinalStateEquivalent(StateSetCouple &couple) = 0;		// Check if pair is equivalent.
+			bool isCoupleFinalStateEquivalent(const IdCouple &couple);		// Check if pair is equivalent.
+			virtual bool areFinalStateEquivalent(const StateSet &first, const StateSet &second) const = 0;	// Check if macrostates are equivalent.
 
-			bool getPost(RankedSymbol &symbol);	// Calculate successors for currently proccessed pair.
-			void getPostAtFixedPos(StateSetCouple &next, StateSetCouple &pair, size_t symbol, size_t pos);
+			bool getPost(const RankedSymbol &symbol);	// Calculate successors for currently proccessed pair.
+			bool getPosts();					// Calculate successors of actual for all symbols.
 
-			bool todoInsert(StateSetCouple &next);	// Insert successors into Todo.
+			bool todoInsert(const IdCouple &next);	// Insert successors into Todo.
 
-			virtual bool isCongruenceClosureMember(StateSetCouple item) = 0;		// Check if pair is in congruence closure of Done.
-			Expandable isExpandableBy(StateSet &expandee, StateSetCouple &expander);		// Check if pair can be expanded by expandee.
-			Expandable isExpandableBy(StateSet &expandee, StateSetCoupleIter expander);
+			virtual bool isCongruenceClosureMember(const IdCouple &item) = 0;		// Check if pair is in congruence closure of Done.
 
 	};
+
+	// Run check with macrostate representation suitable for given number of states.
+	template <template <class> class Check>
+	bool runCheck(
+		const ExplicitTreeAutCore&        smaller,
+		const ExplicitTreeAutCore&        bigger,
+		size_t                            states,
+		const CheckOptions&               options = CheckOptions())
+	{
+		if(states <= DENSE_STATES_LIMIT)
+		{
+			Check<DenseStateSet> check(smaller, bigger, options);
+			return check.check();
+		}
+		Check<SparseStateSet> check(smaller, bigger, options);
+		return check.check();
+	}
 }
-#endif
\ No newline at end of file
+#endif
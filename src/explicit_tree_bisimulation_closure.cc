@@ -0,0 +1,228 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Ondrej Vales <xvales03@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Incremental congruence closure for upward bisimulation up to
+ *    congruence.
+ *
+ *****************************************************************************/
+
+#include "explicit_tree_bisimulation_closure.hh"
+
+using namespace ExplicitTreeUpwardBisimulation;
+
+template <class StateSet> const size_t CongruenceClosure<StateSet>::NO_RULE;
+
+template <class StateSet>
+CongruenceClosure<StateSet>::CongruenceClosure(const MacrostateTable<StateSet> &macrostates)
+	: macrostates(macrostates), rule_index(), rule_lhs(), rule_parent(), rule_class(),
+		rule_pending(), empty_rule(NO_RULE), pending(), pending_index(),
+		occurrences(), simulated(), generation(0), rule_stamp(), rule_counter(),
+		class_stamp(), state_stamp(), reference_stamp(), worklist()
+{
+}
+
+// Get rule with given left-hand side, create new one if there is none.
+template <class StateSet>
+size_t CongruenceClosure<StateSet>::getRule(MacrostateId id)
+{
+	if(id < rule_index.size() && rule_index[id] != NO_RULE)
+	{
+		return rule_index[id];
+	}
+
+	size_t rule = rule_lhs.size();
+	if(id >= rule_index.size())
+		rule_index.resize(id + 1, NO_RULE);
+	rule_index[id] = rule;
+	const StateSet &lhs = macrostates.get(id);
+	rule_lhs.push_back(&lhs);
+	rule_parent.push_back(rule);
+	rule_class.push_back(StateSet());
+	rule_pending.push_back(std::vector<size_t>());
+	rule_stamp.push_back(0);
+	rule_counter.push_back(0);
+	class_stamp.push_back(0);
+
+	if(lhs.empty())
+	{
+		empty_rule = rule;
+	}
+	// Index rule by states of its left-hand side.
+	for(auto state : lhs)
+	{
+		if(state >= occurrences.size())
+			occurrences.resize(state + 1);
+		occurrences[state].push_back(rule);
+	}
+	return rule;
+}
+
+// Find representative of rule class (with path halving).
+template <class StateSet>
+size_t CongruenceClosure<StateSet>::findClass(size_t rule)
+{
+	while(rule_parent[rule] != rule)
+	{
+		rule_parent[rule] = rule_parent[rule_parent[rule]];
+		rule = rule_parent[rule];
+	}
+	return rule;
+}
+
+// Merge classes of given rules, the smaller union is moved to the bigger one.
+template <class StateSet>
+void CongruenceClosure<StateSet>::mergeClasses(size_t left, size_t right)
+{
+	left = findClass(left);
+	right = findClass(right);
+	if(left == right)
+	{
+		return;
+	}
+
+	// Union of a class which was never merged is just its left-hand side.
+	if(rule_class[left].empty())
+		rule_class[left] = *rule_lhs[left];
+	if(rule_class[right].empty())
+		rule_class[right] = *rule_lhs[right];
+
+	if(rule_class[left].size() < rule_class[right].size())
+	{
+		std::swap(left, right);
+	}
+	rule_parent[right] = left;
+	unite(rule_class[left], rule_class[right]);
+	rule_class[right] = StateSet();
+}
+
+// Add rules of pair (X, Y) inserted into Todo.
+template <class StateSet>
+void CongruenceClosure<StateSet>::addPending(const IdCouple &couple)
+{
+	size_t first = getRule(couple.first);
+	size_t second = getRule(couple.second);
+	if(pending_index.find(std::make_pair(first, second)) != pending_index.end())
+	{
+		return;
+	}
+
+	size_t id = pending.size();
+	pending.push_back(PendingCouple{first, second, true});
+	pending_index.emplace(std::make_pair(first, second), id);
+	rule_pending[first].push_back(id);
+	if(second != first)
+	{
+		rule_pending[second].push_back(id);
+	}
+}
+
+// Remove rules of pair (X, Y) popped from Todo.
+template <class StateSet>
+void CongruenceClosure<StateSet>::removePending(const IdCouple &couple)
+{
+	if(couple.first >= rule_index.size() || couple.second >= rule_index.size())
+	{
+		return;
+	}
+
+	auto iter = pending_index.find(std::make_pair(rule_index[couple.first], rule_index[couple.second]));
+	if(iter == pending_index.end())
+	{
+		return;
+	}
+	pending[iter->second].alive = false;
+	pending_index.erase(iter);
+}
+
+// Add rules X -> X + Y and Y -> X + Y of pair (X, Y) permanently.
+template <class StateSet>
+void CongruenceClosure<StateSet>::insert(const IdCouple &couple)
+{
+	mergeClasses(getRule(couple.first), getRule(couple.second));
+}
+
+// Add rule upper -> upper + lower of simulation.
+template <class StateSet>
+void CongruenceClosure<StateSet>::addSimulation(StateType lower, StateType upper)
+{
+	if(lower == upper)
+	{
+		return;
+	}
+	if(upper >= simulated.size())
+		simulated.resize(upper + 1);
+	simulated[upper].push_back(lower);
+}
+
+// Mark state as a member of reference macrostate.
+template <class StateSet>
+void CongruenceClosure<StateSet>::markReference(StateType state, size_t reference)
+{
+	if(state >= reference_stamp.size())
+		reference_stamp.resize(state + 1, 0);
+	reference_stamp[state] = reference;
+}
+
+// Check if normal forms of both macrostates are equal.
+template <class StateSet>
+bool CongruenceClosure<StateSet>::areEquivalent(MacrostateId left_id, MacrostateId right_id)
+{
+	if(left_id == right_id)
+	{
+		return true;
+	}
+	const StateSet &left = macrostates.get(left_id);
+	const StateSet &right = macrostates.get(right_id);
+
+	// Compute normal form of the left macrostate and use it as a reference.
+	size_t reference = ++generation;
+	size_t reference_size = 0;
+	saturate(left, [this, reference, &reference_size](StateType state) {
+		markReference(state, reference);
+		++reference_size;
+		return true;
+	});
+
+	// Compute normal form of the right macrostate, stop on the first state outside the reference.
+	size_t found = 0;
+	bool finished = saturate(right, [this, reference, &found](StateType state) {
+		if(state >= reference_stamp.size() || reference_stamp[state] != reference)
+			return false;
+		++found;
+		return true;
+	});
+	return finished && found == reference_size;
+}
+
+// Check if left macrostate is subset of the normal form of the right one.
+template <class StateSet>
+bool CongruenceClosure<StateSet>::isIncluded(MacrostateId left_id, MacrostateId right_id)
+{
+	const StateSet &left = macrostates.get(left_id);
+	const StateSet &right = macrostates.get(right_id);
+	if(isSubset(left, right))
+	{
+		return true;
+	}
+
+	size_t reference = ++generation;
+	for(auto state : left)
+	{
+		markReference(state, reference);
+	}
+
+	// Compute normal form of the right macrostate, stop once all states of left are present.
+	size_t missing = left.size();
+	saturate(right, [this, reference, &missing](StateType state) {
+		if(state < reference_stamp.size() && reference_stamp[state] == reference)
+			return --missing != 0;
+		return true;
+	});
+	return missing == 0;
+}
+
+template class ExplicitTreeUpwardBisimulation::CongruenceClosure<DenseStateSet>;
+template class ExplicitTreeUpwardBisimulation::CongruenceClosure<SparseStateSet>;
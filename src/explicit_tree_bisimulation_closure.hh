@@ -0,0 +1,174 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Ondrej Vales <xvales03@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Incremental congruence closure used by upward bisimulation up to
+ *    congruence for explicitly represented tree automata.
+ *
+ *****************************************************************************/
+
+#ifndef _EXPLICIT_TREE_UPWARD_BISIMULATION_EXPLICIT_TREE_BISIMULATION_CLOSURE_HH_
+#define	_EXPLICIT_TREE_UPWARD_BISIMULATION_EXPLICIT_TREE_BISIMULATION_CLOSURE_HH_
+
+
+#include "explicit_tree_bisimulation_table.hh"
+
+namespace ExplicitTreeUpwardBisimulation{
+
+	/*
+	 * Every visited pair (X, Y) gives rewriting rules X -> X + Y and
+	 * Y -> X + Y. Rules are kept normalized: each distinct left-hand side
+	 * (interned) macrostate is stored once and is indexed by its states, so a rule fires
+	 * exactly when the last state of its left-hand side is added. Macrostates
+	 * equated by processed pairs are merged into one class (union-find), firing
+	 * any of them adds the union of the whole class. Pairs still waiting in Todo
+	 * are kept as pending rules, so that a popped pair can be removed before it
+	 * is checked against the others. With a simulation, every state q gives
+	 * also the rule q -> q + {r | r is simulated by q}.
+	 */
+GCC_DIAG_OFF(effc++)
+	template <class StateSet>
+	class CongruenceClosure{
+GCC_DIAG_ON(effc++)
+		private:
+			static const size_t NO_RULE = static_cast<size_t>(-1);
+
+			typedef std::pair<size_t, size_t> RuleCouple;
+			typedef std::unordered_map<RuleCouple, size_t, boost::hash<RuleCouple>> PendingIndex;
+
+			struct PendingCouple {										// Rules of a pair waiting in Todo.
+				size_t first;
+				size_t second;
+				bool alive;
+			};
+
+			const MacrostateTable<StateSet> &macrostates;	// Interned macrostates.
+			std::vector<size_t> rule_index;					// Left-hand side macrostate -> rule.
+			std::vector<const StateSet*> rule_lhs;			// Left-hand side of rule.
+			std::vector<size_t> rule_parent;				// Union-find over rules.
+			std::vector<StateSet> rule_class;				// Union of merged class (kept by representative).
+			std::vector<std::vector<size_t>> rule_pending;	// Pending pairs the rule is part of.
+			size_t empty_rule;								// Rule with empty left-hand side (if any).
+
+			std::vector<PendingCouple> pending;				// Pairs waiting in Todo.
+			PendingIndex pending_index;						// Rules of pending pair -> pending pair.
+
+			std::vector<std::vector<size_t>> occurrences;	// State -> rules with the state on left-hand side.
+			std::vector<std::vector<StateType>> simulated;	// State -> states simulated by it.
+
+			size_t generation;								// Stamp of actual normal form computation.
+			std::vector<size_t> rule_stamp;					// Stamp of last touch of the rule counter.
+			std::vector<size_t> rule_counter;				// Number of left-hand side states not yet present.
+			std::vector<size_t> class_stamp;				// Stamp of last firing of the class.
+			std::vector<size_t> state_stamp;				// Stamp of presence of state in normal form.
+			std::vector<size_t> reference_stamp;			// Stamp of presence of state in reference macrostate.
+			std::vector<StateType> worklist;				// States of normal form whose rules were not processed yet.
+
+			size_t getRule(MacrostateId lhs);				// Get (or create) rule with given left-hand side.
+			size_t findClass(size_t rule);					// Find representative of rule class.
+			void mergeClasses(size_t left, size_t right);	// Merge classes of both rules.
+			void markReference(StateType state, size_t reference);	// Mark state of reference macrostate.
+
+			template <class Callback> bool insertState(StateType state, Callback &onInsert)
+			{																			// Add state to normal form.
+				if(state >= state_stamp.size())
+					state_stamp.resize(state + 1, 0);
+				if(state_stamp[state] == generation)
+					return true;
+				state_stamp[state] = generation;
+				worklist.push_back(state);
+				return onInsert(state);
+			}
+
+			template <class Callback> bool insertSet(const StateSet &set, Callback &onInsert)
+			{																			// Add macrostate to normal form.
+				for(auto state : set)
+				{
+					if(!insertState(state, onInsert))
+						return false;
+				}
+				return true;
+			}
+
+			template <class Callback> bool fireRule(size_t rule, Callback &onInsert)
+			{																			// Add right-hand sides of rule to normal form.
+				size_t root = findClass(rule);
+				if(class_stamp[root] != generation)
+				{
+					class_stamp[root] = generation;
+					if(!insertSet(rule_class[root], onInsert))
+						return false;
+				}
+
+				std::vector<size_t> &couples = rule_pending[rule];
+				for(size_t i = 0; i < couples.size(); )
+				{
+					PendingCouple &couple = pending[couples[i]];
+					if(!couple.alive)
+					{
+						// Drop pairs which already left Todo.
+						couples[i] = couples.back();
+						couples.pop_back();
+						continue;
+					}
+					if(!insertSet(*rule_lhs[couple.first == rule ? couple.second : couple.first], onInsert))
+						return false;
+					i++;
+				}
+				return true;
+			}
+
+			template <class Callback> bool saturate(const StateSet &set, Callback onInsert)
+			{																			// Compute normal form of macrostate, stop if callback returns false.
+				++generation;
+				worklist.clear();
+				if(!insertSet(set, onInsert))
+					return false;
+
+				if(empty_rule != NO_RULE && !fireRule(empty_rule, onInsert))
+					return false;
+
+				while(!worklist.empty())
+				{
+					StateType state = worklist.back();
+					worklist.pop_back();
+					if(state < simulated.size())
+					{
+						for(auto lower : simulated[state])
+						{
+							if(!insertState(lower, onInsert))
+								return false;
+						}
+					}
+					if(state >= occurrences.size())
+						continue;
+					for(auto rule : occurrences[state])
+					{
+						if(rule_stamp[rule] != generation)
+						{
+							rule_stamp[rule] = generation;
+							rule_counter[rule] = rule_lhs[rule]->size();
+						}
+						// Fire rule once all states of its left-hand side are present.
+						if(--rule_counter[rule] == 0 && !fireRule(rule, onInsert))
+							return false;
+					}
+				}
+				return true;
+			}
+
+		public:
+			CongruenceClosure(const MacrostateTable<StateSet> &macrostates);
+
+			void addPending(const IdCouple &couple);								// Add rules of pair inserted into Todo.
+			void removePending(const IdCouple &couple);								// Remove rules of pair popped from Todo.
+			void insert(const IdCouple &couple);									// Add rules of processed pair permanently.
+			void addSimulation(StateType lower, StateType upper);					// Add rule of simulation (upper simulates lower).
+
+			bool areEquivalent(MacrostateId left, MacrostateId right);				// Check if macrostates have the same normal form.
+			bool isIncluded(MacrostateId left, MacrostateId right);					// Check if left is subset of normal form of right.
+	};
+}
+#endif
@@ -18,16 +18,31 @@
 #include <vata/explicit_tree_aut.hh>
 
 namespace ExplicitTreeUpwardBisimulation{ 
-	class BisimulationEquivalence : public BisimulationBase {
+	template <class StateSet>
+	class BisimulationEquivalence : public BisimulationBase<StateSet> {
+		private:
+			typedef BisimulationBase<StateSet> Base;
+
+			using Base::smaller_final;
+			using Base::bigger_final;
+			using Base::actual;
+			using Base::todo;
+			using Base::closure;
+			using Base::getLeafCouples;
+			using Base::pruneRankedAlphabet;
+			using Base::areLeavesEquivalent;
+			using Base::getPosts;
+
 		public:
 			BisimulationEquivalence(
 				const ExplicitTreeAutCore&        smaller,
-				const ExplicitTreeAutCore&        bigger
+				const ExplicitTreeAutCore&        bigger,
+				const CheckOptions&               options = CheckOptions()
 			);
 			
 			bool check();												// Perform equivalence check.		
-			bool isCoupleFinalStateEquivalent(StateSetCouple &couple);	// Check if both or neither of macrostates contain final states.
-			bool isCongruenceClosureMember(StateSetCouple item);		// Check if pair is in congruence closure.
+			bool areFinalStateEquivalent(const StateSet &first, const StateSet &second) const;	// Check if both or neither of macrostates contain final states.
+			bool isCongruenceClosureMember(const IdCouple &item);		// Check if pair is in congruence closure.
 	};
 }
 #endif
\ No newline at end of file
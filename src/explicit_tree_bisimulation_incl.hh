@@ -18,18 +18,31 @@
 #include <vata/explicit_tree_aut.hh>
 
 namespace ExplicitTreeUpwardBisimulation{ 
-	class BisimulationInclusion : public BisimulationBase {
+	template <class StateSet>
+	class BisimulationInclusion : public BisimulationBase<StateSet> {
 		private:
+			typedef BisimulationBase<StateSet> Base;
+
+			using Base::smaller_final;
+			using Base::bigger_final;
+			using Base::actual;
+			using Base::todo;
+			using Base::closure;
+			using Base::getLeafCouples;
+			using Base::pruneRankedAlphabet;
+			using Base::areLeavesEquivalent;
+			using Base::getPosts;
 
 		public:
 			BisimulationInclusion(
 				const ExplicitTreeAutCore&        smaller,
-				const ExplicitTreeAutCore&        bigger
+				const ExplicitTreeAutCore&        bigger,
+				const CheckOptions&               options = CheckOptions()
 			);
 			
 			bool check();												 // Perform inclusion check.		
-			bool isCoupleFinalStateEquivalent(StateSetCouple &couple);	 // Check if first macrostate is not accepting or second is accepting.
-			bool isCongruenceClosureMember(StateSetCouple item);		 // Check if pair is in congruence closure.
+			bool areFinalStateEquivalent(const StateSet &first, const StateSet &second) const;	 // Check if first macrostate is not accepting or second is accepting.
+			bool isCongruenceClosureMember(const IdCouple &item);		 // Check if pair is in congruence closure.
 	};
 
 }
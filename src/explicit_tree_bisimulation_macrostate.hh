@@ -0,0 +1,363 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Ondrej Vales <xvales03@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Macrostates for upward bisimulation up to congruence for explicitly
+ *    represented tree automata.
+ *
+ *****************************************************************************/
+
+#ifndef _EXPLICIT_TREE_UPWARD_BISIMULATION_EXPLICIT_TREE_BISIMULATION_MACROSTATE_HH_
+#define	_EXPLICIT_TREE_UPWARD_BISIMULATION_EXPLICIT_TREE_BISIMULATION_MACROSTATE_HH_
+
+
+#include "explicit_tree_aut_core.hh"
+#include <vata/explicit_tree_aut.hh>
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+namespace ExplicitTreeUpwardBisimulation{
+	using namespace VATA;
+
+	using StateType      = ExplicitTreeAutCore::StateType;
+	using SymbolType     = ExplicitTreeAutCore::SymbolType;
+	using Transition	 = ExplicitTreeAut::Transition;
+
+	/*
+	 * Both macrostate representations provide the same interface: set-like
+	 * insertion, membership and iteration in ascending order of states, ordering equal to
+	 * the lexicographic ordering of the state sequences (as of std::set), hash
+	 * and the isSubset, intersection, haveIntersection and unite kernels
+	 * (intersection can reuse storage of the result).
+	 * Checks select the representation according to the number of states of
+	 * input automata (see DENSE_STATES_LIMIT).
+	 */
+
+	const size_t DENSE_STATES_LIMIT = 2048;		// Biggest automata with bitset macrostates.
+
+	inline uint64_t mixHash(uint64_t hash, uint64_t value)	// Add value to hash.
+	{
+		hash ^= value;
+		hash *= 0x9E3779B97F4A7C15ULL;
+		return hash ^ (hash >> 29);
+	}
+
+GCC_DIAG_OFF(effc++)
+	class DenseStateSet{										// Macrostate stored as word-packed bitset.
+GCC_DIAG_ON(effc++)
+		public:
+			typedef uint64_t Word;
+			static const size_t WORD_BITS = 64;
+
+			class const_iterator{								// Iterator over states of bitset.
+				private:
+					const Word* words;
+					size_t length;
+					size_t index;								// Actual word.
+					Word current;								// Bits of actual word not visited yet.
+
+				public:
+					typedef std::forward_iterator_tag iterator_category;
+					typedef StateType value_type;
+					typedef std::ptrdiff_t difference_type;
+					typedef const StateType* pointer;
+					typedef StateType reference;
+
+					const_iterator(const Word* data, size_t size, size_t start)
+						: words(data), length(size), index(start),
+							current(start < size ? data[start] : 0)
+					{
+						while(current == 0 && index < length && ++index < length)
+							current = words[index];
+					}
+
+					StateType operator*() const
+					{
+						return static_cast<StateType>(index * WORD_BITS + __builtin_ctzll(current));
+					}
+
+					const_iterator& operator++()
+					{
+						current &= current - 1;
+						while(current == 0 && ++index < length)
+							current = words[index];
+						return *this;
+					}
+
+					bool operator==(const const_iterator &rhs) const
+					{
+						return index == rhs.index && current == rhs.current;
+					}
+
+					bool operator!=(const const_iterator &rhs) const
+					{
+						return !(*this == rhs);
+					}
+			};
+
+			typedef const_iterator iterator;
+
+		private:
+			std::vector<Word> words;		// Bits of states, last word is never zero.
+			size_t count;					// Number of states.
+
+			void trim()						// Remove trailing zero words.
+			{
+				while(!words.empty() && words.back() == 0)
+					words.pop_back();
+			}
+
+			void recount()					// Recompute number of states.
+			{
+				count = 0;
+				for(auto word : words)
+					count += __builtin_popcountll(word);
+			}
+
+		public:
+			DenseStateSet() : words(), count(0)
+			{
+			}
+
+			bool insert(StateType state)
+			{
+				size_t index = state / WORD_BITS;
+				Word bit = Word(1) << (state % WORD_BITS);
+				if(index >= words.size())
+					words.resize(index + 1, 0);
+				if(words[index] & bit)
+					return false;
+				words[index] |= bit;
+				++count;
+				return true;
+			}
+
+			template <class Iterator> void insert(Iterator first, Iterator last)
+			{
+				for(; first != last; ++first)
+					insert(*first);
+			}
+
+			bool contains(StateType state) const
+			{
+				size_t index = state / WORD_BITS;
+				return index < words.size() && (words[index] & (Word(1) << (state % WORD_BITS)));
+			}
+
+			void clear()
+			{
+				words.clear();
+				count = 0;
+			}
+
+			size_t size() const { return count; }
+			bool empty() const { return count == 0; }
+
+			const_iterator begin() const { return const_iterator(words.data(), words.size(), 0); }
+			const_iterator end() const { return const_iterator(words.data(), words.size(), words.size()); }
+
+			size_t hash() const
+			{
+				uint64_t hash = count;
+				for(auto word : words)
+					hash = mixHash(hash, word);
+				return static_cast<size_t>(hash);
+			}
+
+			bool operator==(const DenseStateSet &rhs) const
+			{
+				return count == rhs.count && words == rhs.words;
+			}
+
+			bool operator<(const DenseStateSet &rhs) const
+			{
+				size_t common = std::min(words.size(), rhs.words.size());
+				for(size_t i = 0; i < common; i++)
+				{
+					if(words[i] == rhs.words[i])
+						continue;
+					// Sequences differ first in the lowest differing state.
+					Word low = (words[i] ^ rhs.words[i]) & (~(words[i] ^ rhs.words[i]) + 1);
+					Word above = ~(low | (low - 1));
+					if(words[i] & low)
+						return (rhs.words[i] & above) != 0 || i + 1 < rhs.words.size();
+					return (words[i] & above) == 0 && i + 1 == words.size();
+				}
+				return words.size() < rhs.words.size();
+			}
+
+			friend bool isSubset(const DenseStateSet &left, const DenseStateSet &right)
+			{
+				if(left.count > right.count || left.words.size() > right.words.size())
+					return false;
+				Word missing = 0;
+				for(size_t i = 0; i < left.words.size(); i++)
+					missing |= left.words[i] & ~right.words[i];
+				return missing == 0;
+			}
+
+			friend void intersection(const DenseStateSet &left, const DenseStateSet &right, DenseStateSet &result)
+			{
+				size_t common = std::min(left.words.size(), right.words.size());
+				result.words.resize(common);
+				for(size_t i = 0; i < common; i++)
+					result.words[i] = left.words[i] & right.words[i];
+				result.trim();
+				result.recount();
+			}
+
+			friend DenseStateSet intersection(const DenseStateSet &left, const DenseStateSet &right)
+			{
+				DenseStateSet result;
+				intersection(left, right, result);
+				return result;
+			}
+
+			friend bool haveIntersection(const DenseStateSet &left, const DenseStateSet &right)
+			{
+				size_t common = std::min(left.words.size(), right.words.size());
+				Word shared = 0;
+				for(size_t i = 0; i < common; i++)
+					shared |= left.words[i] & right.words[i];
+				return shared != 0;
+			}
+
+			friend void unite(DenseStateSet &left, const DenseStateSet &right)
+			{
+				if(right.words.size() > left.words.size())
+					left.words.resize(right.words.size(), 0);
+				for(size_t i = 0; i < right.words.size(); i++)
+					left.words[i] |= right.words[i];
+				left.recount();
+			}
+	};
+
+GCC_DIAG_OFF(effc++)
+	class SparseStateSet{										// Macrostate stored as sorted vector.
+GCC_DIAG_ON(effc++)
+		public:
+			typedef std::vector<StateType>::const_iterator const_iterator;
+			typedef const_iterator iterator;
+
+		private:
+			std::vector<StateType> states;	// Sorted states.
+
+		public:
+			SparseStateSet() : states()
+			{
+			}
+
+			bool insert(StateType state)
+			{
+				if(states.empty() || states.back() < state)
+				{
+					states.push_back(state);
+					return true;
+				}
+				auto iter = std::lower_bound(states.begin(), states.end(), state);
+				if(*iter == state)
+					return false;
+				states.insert(iter, state);
+				return true;
+			}
+
+			template <class Iterator> void insert(Iterator first, Iterator last)
+			{
+				states.insert(states.end(), first, last);
+				std::sort(states.begin(), states.end());
+				states.erase(std::unique(states.begin(), states.end()), states.end());
+			}
+
+			bool contains(StateType state) const
+			{
+				return std::binary_search(states.begin(), states.end(), state);
+			}
+
+			void clear() { states.clear(); }
+
+			size_t size() const { return states.size(); }
+			bool empty() const { return states.empty(); }
+
+			const_iterator begin() const { return states.begin(); }
+			const_iterator end() const { return states.end(); }
+
+			size_t hash() const
+			{
+				uint64_t hash = states.size();
+				for(auto state : states)
+					hash = mixHash(hash, state);
+				return static_cast<size_t>(hash);
+			}
+
+			bool operator==(const SparseStateSet &rhs) const { return states == rhs.states; }
+			bool operator<(const SparseStateSet &rhs) const { return states < rhs.states; }
+
+			friend bool isSubset(const SparseStateSet &left, const SparseStateSet &right)
+			{
+				if(left.states.size() > right.states.size())
+					return false;
+				return std::includes(right.states.begin(), right.states.end(),
+					left.states.begin(), left.states.end());
+			}
+
+			friend void intersection(const SparseStateSet &left, const SparseStateSet &right, SparseStateSet &result)
+			{
+				result.states.clear();
+				std::set_intersection(left.states.begin(), left.states.end(),
+					right.states.begin(), right.states.end(),
+					std::back_inserter(result.states));
+			}
+
+			friend SparseStateSet intersection(const SparseStateSet &left, const SparseStateSet &right)
+			{
+				SparseStateSet result;
+				intersection(left, right, result);
+				return result;
+			}
+
+			friend bool haveIntersection(const SparseStateSet &left, const SparseStateSet &right)
+			{
+				auto l = left.states.begin();
+				auto r = right.states.begin();
+				while(l != left.states.end() && r != right.states.end())
+				{
+					if(*l < *r)
+						++l;
+					else if(*r < *l)
+						++r;
+					else
+						return true;
+				}
+				return false;
+			}
+
+			friend void unite(SparseStateSet &left, const SparseStateSet &right)
+			{
+				if(right.states.empty())
+					return;
+				if(left.states.empty() || left.states.back() < right.states.front())
+				{
+					// Disjoint ranges can be appended.
+					left.states.insert(left.states.end(), right.states.begin(), right.states.end());
+					return;
+				}
+				std::vector<StateType> merged;
+				merged.reserve(left.states.size() + right.states.size());
+				std::set_union(left.states.begin(), left.states.end(),
+					right.states.begin(), right.states.end(),
+					std::back_inserter(merged));
+				left.states.swap(merged);
+			}
+	};
+
+	struct StateSetHash											// Macrostate hashing function.
+	{
+		std::size_t operator () (const DenseStateSet &p) const { return p.hash(); }
+		std::size_t operator () (const SparseStateSet &p) const { return p.hash(); }
+	};
+}
+#endif
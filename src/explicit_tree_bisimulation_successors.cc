@@ -0,0 +1,133 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Ondrej Vales <xvales03@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Successor index for upward bisimulation up to congruence.
+ *
+ *****************************************************************************/
+
+#include "explicit_tree_bisimulation_successors.hh"
+
+#include <tuple>
+
+using namespace ExplicitTreeUpwardBisimulation;
+
+SuccessorIndex::SuccessorIndex(
+	const ExplicitTreeAutCore&        smaller,
+	const ExplicitTreeAutCore&        bigger)
+	: symbols(), slot_begin(), row_begin(), entry_slot(), entry_transition(),
+		transition_parent(), transition_begin(), transition_child(), leaf_begin(), leaf_parent(), states(0), arity(0)
+{
+	typedef std::tuple<StateType, size_t, TransitionType> Entry;	// Child state, slot, transition.
+	typedef std::pair<size_t, StateType> Leaf;					// Dense symbol and automaton, parent.
+
+	std::unordered_map<RankedSymbol, size_t, boost::hash<RankedSymbol>> symbol_index;
+	std::vector<Entry> entries;
+	std::vector<Leaf> leaves;
+
+	auto addTransitions = [&](const ExplicitTreeAutCore &aut, size_t side)
+	{
+		for(auto transition : aut)
+		{
+			const auto &children = transition.GetChildren();
+			RankedSymbol ranked = std::make_pair(transition.GetSymbol(), children.size());
+
+			// Remap ranked symbol to dense id.
+			auto iter = symbol_index.find(ranked);
+			if(iter == symbol_index.end())
+			{
+				iter = symbol_index.emplace(ranked, symbols.size()).first;
+				slot_begin.push_back(getSlotCount());
+				symbols.push_back(ranked);
+			}
+			size_t symbol = iter->second;
+
+			if(transition.GetParent() >= states)
+				states = transition.GetParent() + 1;
+			if(children.size() > arity)
+				arity = children.size();
+
+			if(children.empty())
+			{
+				leaves.push_back(std::make_pair(2 * symbol + side, transition.GetParent()));
+				continue;
+			}
+			TransitionType id = transition_parent.size();
+			transition_parent.push_back(transition.GetParent());
+			transition_begin.push_back(transition_child.size());
+			transition_child.insert(transition_child.end(), children.begin(), children.end());
+			for(size_t pos = 0; pos < children.size(); pos++)
+			{
+				if(children[pos] >= states)
+					states = children[pos] + 1;
+				entries.push_back(std::make_tuple(children[pos], slot_begin[symbol] + pos, id));
+			}
+		}
+	};
+	addTransitions(smaller, 0);
+	addTransitions(bigger, 1);
+
+	// Rows of child states, entries are ordered by slot and transition.
+	std::sort(entries.begin(), entries.end());
+
+	row_begin.assign(states + 1, 0);
+	entry_slot.reserve(entries.size());
+	entry_transition.reserve(entries.size());
+	for(const auto &entry : entries)
+	{
+		++row_begin[std::get<0>(entry) + 1];
+		entry_slot.push_back(std::get<1>(entry));
+		entry_transition.push_back(std::get<2>(entry));
+	}
+	for(size_t state = 0; state < states; state++)
+	{
+		row_begin[state + 1] += row_begin[state];
+	}
+
+	// Parents of leaf rules.
+	std::sort(leaves.begin(), leaves.end());
+	leaves.erase(std::unique(leaves.begin(), leaves.end()), leaves.end());
+
+	leaf_begin.assign(2 * symbols.size() + 1, 0);
+	leaf_parent.reserve(leaves.size());
+	for(const auto &leaf : leaves)
+	{
+		++leaf_begin[leaf.first + 1];
+		leaf_parent.push_back(leaf.second);
+	}
+	for(size_t i = 0; i < 2 * symbols.size(); i++)
+	{
+		leaf_begin[i + 1] += leaf_begin[i];
+	}
+}
+
+// Get transitions of symbol with given state at given position.
+SuccessorIndex::TransitionRange SuccessorIndex::getTransitions(size_t symbol, size_t pos, StateType state) const
+{
+	if(state >= states)
+	{
+		return TransitionRange(nullptr, nullptr);
+	}
+
+	auto range = std::equal_range(
+		entry_slot.begin() + row_begin[state],
+		entry_slot.begin() + row_begin[state + 1],
+		getSlot(symbol, pos)
+	);
+	return TransitionRange(
+		entry_transition.data() + (range.first - entry_slot.begin()),
+		entry_transition.data() + (range.second - entry_slot.begin())
+	);
+}
+
+// Get parents of leaf rules of symbol in one of the automata.
+SuccessorIndex::StateRange SuccessorIndex::getLeaves(size_t symbol, bool inBigger) const
+{
+	size_t key = 2 * symbol + (inBigger ? 1 : 0);
+	return StateRange(
+		leaf_parent.data() + leaf_begin[key],
+		leaf_parent.data() + leaf_begin[key + 1]
+	);
+}
@@ -0,0 +1,77 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Ondrej Vales <xvales03@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Successor index used by upward bisimulation up to congruence for
+ *    explicitly represented tree automata.
+ *
+ *****************************************************************************/
+
+#ifndef _EXPLICIT_TREE_UPWARD_BISIMULATION_EXPLICIT_TREE_BISIMULATION_SUCCESSORS_HH_
+#define	_EXPLICIT_TREE_UPWARD_BISIMULATION_EXPLICIT_TREE_BISIMULATION_SUCCESSORS_HH_
+
+
+#include "explicit_tree_bisimulation_macrostate.hh"
+
+namespace ExplicitTreeUpwardBisimulation{
+	typedef std::pair<SymbolType, size_t> RankedSymbol;			// Symbol + arity.
+	typedef std::set<RankedSymbol> RankedAlphabet;				// Set of ranked symbols.
+
+	typedef StateType TransitionType;							// Transition id.
+	typedef SparseStateSet TransitionSet;						// Set of transition ids.
+
+	/*
+	 * Read-only index of transitions of both input automata (their states are
+	 * disjoint). Ranked symbols used by the automata are remapped to dense ids
+	 * and every (symbol, position) gets a slot. Non-leaf transitions get dense
+	 * ids, their children are kept in a flat array and the ids are also stored
+	 * in compressed rows by the child state: the row of a state holds its
+	 * entries sorted by slot, so transitions with the state at a given position
+	 * form a contiguous range. Parents of leaf rules are kept per symbol and
+	 * automaton. Memory is linear in the size of transitions.
+	 */
+GCC_DIAG_OFF(effc++)
+	class SuccessorIndex{
+GCC_DIAG_ON(effc++)
+		public:
+			typedef std::pair<const StateType*, const StateType*> StateRange;	// Contiguous range of states.
+			typedef std::pair<const TransitionType*, const TransitionType*> TransitionRange;	// Contiguous range of transitions.
+
+		private:
+			std::vector<RankedSymbol> symbols;			// Dense symbol -> ranked symbol.
+			std::vector<size_t> slot_begin;				// Dense symbol -> slot of its first position.
+			std::vector<size_t> row_begin;				// Child state -> first entry of its row.
+			std::vector<size_t> entry_slot;				// Slot of entry.
+			std::vector<TransitionType> entry_transition;	// Transition of entry.
+			std::vector<StateType> transition_parent;	// Transition -> its parent.
+			std::vector<size_t> transition_begin;		// Transition -> its first child.
+			std::vector<StateType> transition_child;	// Children of transitions.
+			std::vector<size_t> leaf_begin;				// Dense symbol and automaton -> first leaf parent.
+			std::vector<StateType> leaf_parent;			// Parents of leaf rules.
+			size_t states;								// Number of states.
+			size_t arity;								// Maximal arity.
+
+		public:
+			SuccessorIndex(
+				const ExplicitTreeAutCore&        smaller,
+				const ExplicitTreeAutCore&        bigger
+			);
+
+			size_t getSymbolCount() const { return symbols.size(); }
+			size_t getSlotCount() const { return slot_begin.empty() ? 0 : slot_begin.back() + symbols.back().second; }
+			size_t getStateCount() const { return states; }
+			size_t getMaxArity() const { return arity; }
+
+			size_t getArity(size_t symbol) const { return symbols[symbol].second; }
+			size_t getSlot(size_t symbol, size_t pos) const { return slot_begin[symbol] + pos; }
+
+			StateType getParent(TransitionType transition) const { return transition_parent[transition]; }
+			StateType getChild(TransitionType transition, size_t pos) const { return transition_child[transition_begin[transition] + pos]; }
+
+			TransitionRange getTransitions(size_t symbol, size_t pos, StateType state) const;	// Transitions with state at given position.
+			StateRange getLeaves(size_t symbol, bool inBigger) const;					// Parents of leaf rules of symbol.
+	};
+}
+#endif
@@ -0,0 +1,175 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Ondrej Vales <xvales03@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Interned macrostates and sets of macrostate pairs for upward
+ *    bisimulation up to congruence for explicitly represented tree automata.
+ *
+ *****************************************************************************/
+
+#ifndef _EXPLICIT_TREE_UPWARD_BISIMULATION_EXPLICIT_TREE_BISIMULATION_TABLE_HH_
+#define	_EXPLICIT_TREE_UPWARD_BISIMULATION_EXPLICIT_TREE_BISIMULATION_TABLE_HH_
+
+
+#include "explicit_tree_bisimulation_macrostate.hh"
+
+#include <deque>
+#include <stdexcept>
+
+namespace ExplicitTreeUpwardBisimulation{
+	typedef uint32_t MacrostateId;								// Interned macrostate.
+	typedef std::pair<MacrostateId, MacrostateId> IdCouple;		// Interned macrostate pair.
+
+	struct IdCoupleHash											// Interned macrostate pair hashing function.
+	{
+		std::size_t operator () (const IdCouple &p) const
+		{
+			return static_cast<size_t>(mixHash(p.first, p.second));
+		}
+	};
+
+	/*
+	 * Every distinct macrostate is stored once and gets dense id in order of
+	 * its first occurrence. Macrostates are kept in an arena with stable
+	 * addresses and are found by their hash in an open addressing table of ids
+	 * (linear probing, at most half full).
+	 */
+GCC_DIAG_OFF(effc++)
+	template <class StateSet>
+	class MacrostateTable{
+GCC_DIAG_ON(effc++)
+		public:
+			static const MacrostateId NO_ID = static_cast<MacrostateId>(-1);
+
+		private:
+			std::deque<StateSet> sets;					// Id -> macrostate.
+			std::vector<size_t> hashes;					// Id -> hash of macrostate.
+			std::vector<MacrostateId> slots;			// Open addressing table of ids.
+
+			size_t findSlot(const StateSet &set, size_t hash) const	// Slot of macrostate or first empty one.
+			{
+				size_t mask = slots.size() - 1;
+				size_t slot = hash & mask;
+				while(slots[slot] != NO_ID &&
+					(hashes[slots[slot]] != hash || !(sets[slots[slot]] == set)))
+				{
+					slot = (slot + 1) & mask;
+				}
+				return slot;
+			}
+
+			void grow()									// Double size of table.
+			{
+				std::vector<MacrostateId> old(2 * slots.size(), NO_ID);
+				old.swap(slots);
+				size_t mask = slots.size() - 1;
+				for(auto id : old)
+				{
+					if(id == NO_ID)
+						continue;
+					size_t slot = hashes[id] & mask;
+					while(slots[slot] != NO_ID)
+						slot = (slot + 1) & mask;
+					slots[slot] = id;
+				}
+			}
+
+		public:
+			MacrostateTable() : sets(), hashes(), slots(16, NO_ID)
+			{
+			}
+
+			template <class Set> MacrostateId intern(Set &&set)	// Get id of macrostate, add it if it is new.
+			{
+				size_t hash = set.hash();
+				size_t slot = findSlot(set, hash);
+				if(slots[slot] != NO_ID)
+					return slots[slot];
+
+				if(sets.size() >= NO_ID)
+					throw std::overflow_error("Too many macrostates");
+				MacrostateId id = static_cast<MacrostateId>(sets.size());
+				sets.push_back(std::forward<Set>(set));
+				hashes.push_back(hash);
+				slots[slot] = id;
+				if(2 * sets.size() > slots.size())
+					grow();
+				return id;
+			}
+
+			MacrostateId find(const StateSet &set) const	// Get id of macrostate, NO_ID if it is not known.
+			{
+				return slots[findSlot(set, set.hash())];
+			}
+
+			const StateSet& get(MacrostateId id) const { return sets[id]; }
+			size_t size() const { return sets.size(); }
+	};
+
+	template <class StateSet> const MacrostateId MacrostateTable<StateSet>::NO_ID;
+
+	/*
+	 * Flat open addressing set of interned macrostate pairs (linear probing,
+	 * at most half full).
+	 */
+GCC_DIAG_OFF(effc++)
+	class CoupleSet{
+GCC_DIAG_ON(effc++)
+		private:
+			std::vector<uint64_t> slots;				// Pairs packed into a single word.
+			size_t count;								// Number of pairs.
+
+			static uint64_t emptyKey() { return static_cast<uint64_t>(-1); }	// Key of empty slot.
+
+			static uint64_t pack(const IdCouple &couple)
+			{
+				return (static_cast<uint64_t>(couple.first) << 32) | couple.second;
+			}
+
+			size_t findSlot(uint64_t key) const			// Slot of pair or first empty one.
+			{
+				size_t mask = slots.size() - 1;
+				size_t slot = mixHash(0, key) & mask;
+				while(slots[slot] != emptyKey() && slots[slot] != key)
+					slot = (slot + 1) & mask;
+				return slot;
+			}
+
+		public:
+			CoupleSet() : slots(16, emptyKey()), count(0)
+			{
+			}
+
+			bool insert(const IdCouple &couple)			// Insert pair, return false if it is already present.
+			{
+				uint64_t key = pack(couple);
+				size_t slot = findSlot(key);
+				if(slots[slot] == key)
+					return false;
+				slots[slot] = key;
+				if(2 * ++count > slots.size())
+				{
+					std::vector<uint64_t> old(2 * slots.size(), emptyKey());
+					old.swap(slots);
+					for(auto item : old)
+					{
+						if(item != emptyKey())
+							slots[findSlot(item)] = item;
+					}
+				}
+				return true;
+			}
+
+			bool contains(const IdCouple &couple) const
+			{
+				uint64_t key = pack(couple);
+				return slots[findSlot(key)] == key;
+			}
+
+			size_t size() const { return count; }
+			bool empty() const { return count == 0; }
+	};
+}
+#endif
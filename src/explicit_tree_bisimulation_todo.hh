@@ -0,0 +1,141 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Ondrej Vales <xvales03@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Scheduling of macrostate pairs to be processed by upward bisimulation
+ *    up to congruence for explicitly represented tree automata.
+ *
+ *****************************************************************************/
+
+#ifndef _EXPLICIT_TREE_UPWARD_BISIMULATION_EXPLICIT_TREE_BISIMULATION_TODO_HH_
+#define	_EXPLICIT_TREE_UPWARD_BISIMULATION_EXPLICIT_TREE_BISIMULATION_TODO_HH_
+
+
+#include "explicit_tree_bisimulation_table.hh"
+
+#include <deque>
+#include <limits>
+
+namespace ExplicitTreeUpwardBisimulation{
+	enum class TodoOrder{										// Order of processing pairs.
+		size,													// Smallest pairs first (sum of macrostate sizes).
+		breadth,												// First in, first out.
+		depth,													// Last in, first out.
+		final													// Pairs with most final states first.
+	};
+
+	template <class SearchOrder>
+	TodoOrder getTodoOrder(SearchOrder order)					// Order of search order of parameters.
+	{
+		switch(order)
+		{
+			case SearchOrder::breadth: return TodoOrder::breadth;
+			case SearchOrder::depth:   return TodoOrder::depth;
+			case SearchOrder::final:   return TodoOrder::final;
+			default:                   return TodoOrder::size;
+		}
+	}
+
+	/*
+	 * Pairs waiting for processing. Breadth and depth orders use the deque as
+	 * a queue and a stack. Size and final orders keep it as a binary heap of
+	 * priorities computed once on insertion; ties are broken by the order of
+	 * insertion, so the order of processing is deterministic.
+	 */
+GCC_DIAG_OFF(effc++)
+	template <class StateSet>
+	class TodoScheduler{
+GCC_DIAG_ON(effc++)
+		public:
+			struct Entry{										// Scheduled pair.
+				uint64_t priority;								// Lower is processed first (heap orders).
+				uint64_t sequence;								// Order of insertion.
+				IdCouple couple;
+			};
+
+			typedef typename std::deque<Entry>::const_iterator const_iterator;
+
+		private:
+			struct EntryGreater{								// Heap ordering (smallest entry on top).
+				bool operator() (const Entry &lhs, const Entry &rhs) const
+				{
+					if(lhs.priority != rhs.priority)
+						return lhs.priority > rhs.priority;
+					return lhs.sequence > rhs.sequence;
+				}
+			};
+
+			TodoOrder order;
+			const MacrostateTable<StateSet> &macrostates;
+			const StateSet &smaller_final;
+			const StateSet &bigger_final;
+			std::deque<Entry> entries;
+			uint64_t sequence;									// Number of inserted pairs.
+
+			uint64_t getPriority(const IdCouple &couple) const	// Priority of pair for heap orders.
+			{
+				const StateSet &first = macrostates.get(couple.first);
+				const StateSet &second = macrostates.get(couple.second);
+				uint64_t size = first.size() + second.size();
+				if(order == TodoOrder::size)
+					return size;
+
+				// More final states first, smaller pairs first among them.
+				uint64_t finals = intersection(first, smaller_final).size() + intersection(second, bigger_final).size();
+				uint64_t limit = std::numeric_limits<uint32_t>::max();
+				return ((limit - std::min(finals, limit)) << 32) | std::min(size, limit);
+			}
+
+		public:
+			TodoScheduler(TodoOrder order, const MacrostateTable<StateSet> &macrostates,
+				const StateSet &smaller_final, const StateSet &bigger_final)
+				: order(order), macrostates(macrostates), smaller_final(smaller_final),
+					bigger_final(bigger_final), entries(), sequence(0)
+			{
+			}
+
+			void push(const IdCouple &couple)
+			{
+				Entry entry = {0, sequence++, couple};
+				if(order == TodoOrder::breadth || order == TodoOrder::depth)
+				{
+					entries.push_back(entry);
+					return;
+				}
+				entry.priority = getPriority(couple);
+				entries.push_back(entry);
+				std::push_heap(entries.begin(), entries.end(), EntryGreater());
+			}
+
+			IdCouple pop()										// Remove next pair and return it.
+			{
+				IdCouple couple;
+				switch(order)
+				{
+					case TodoOrder::breadth:
+						couple = entries.front().couple;
+						entries.pop_front();
+						break;
+					case TodoOrder::depth:
+						couple = entries.back().couple;
+						entries.pop_back();
+						break;
+					default:
+						std::pop_heap(entries.begin(), entries.end(), EntryGreater());
+						couple = entries.back().couple;
+						entries.pop_back();
+						break;
+				}
+				return couple;
+			}
+
+			bool empty() const { return entries.empty(); }
+			size_t size() const { return entries.size(); }
+
+			const_iterator begin() const { return entries.begin(); }	// Pairs in no particular order.
+			const_iterator end() const { return entries.end(); }
+	};
+}
+#endif
@@ -46,9 +46,9 @@ bool ExplicitTreeAutCore::CheckEquivalence(
 		{
 			assert(static_cast<typename AutBase::StateType>(-1) != states);
 			return ExplicitUpwardInclusion::Check(newSmaller, newBigger,
-				Util::Identity(states)) &&
+				Util::Identity(states), params.GetThreads()) &&
                 ExplicitUpwardInclusion::Check(newBigger, newSmaller,
-				Util::Identity(states));
+				Util::Identity(states), params.GetThreads());
 			// duplicate for algo with simulation
 		}
 
@@ -56,15 +56,21 @@ bool ExplicitTreeAutCore::CheckEquivalence(
 		{
 			assert(static_cast<typename AutBase::StateType>(-1) != states);
 			return ExplicitUpwardInclusion::Check(newBigger, newSmaller,
-				Util::Identity(states)) &&
+				Util::Identity(states), params.GetThreads()) &&
                 ExplicitUpwardInclusion::Check(newSmaller, newBigger,
-				Util::Identity(states));
+				Util::Identity(states), params.GetThreads());
 		}
 
 		case EqParam::CONGRUENCE_UP:
+		case EqParam::CONGRUENCE_UP_SIM:
 		{
-			ExplicitTreeUpwardBisimulation::BisimulationEquivalence equivalence(newSmaller, newBigger);
-			return equivalence.check();
+			ExplicitTreeUpwardBisimulation::CheckOptions options;
+			options.threads = params.GetThreads();
+			options.order = ExplicitTreeUpwardBisimulation::getTodoOrder(params.GetSearchOrder());
+			options.simulation = params.GetUseSimulation();
+
+			return ExplicitTreeUpwardBisimulation::runCheck<
+				ExplicitTreeUpwardBisimulation::BisimulationEquivalence>(newSmaller, newBigger, states, options);
 		}
 
 		default:
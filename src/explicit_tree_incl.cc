@@ -14,9 +14,6 @@
 #include "explicit_tree_aut_core.hh"
 #include "explicit_tree_incl_up.hh"
 #include "explicit_tree_incl_down.hh"
-#include "tree_incl_down.hh"
-#include "down_tree_incl_fctor.hh"
-#include "down_tree_opt_incl_fctor.hh"
 #include "explicit_tree_bisimulation_incl.hh"
 
 using VATA::ExplicitTreeAutCore;
@@ -46,7 +43,7 @@ bool ExplicitTreeAutCore::CheckInclusion(
 			assert(static_cast<typename AutBase::StateType>(-1) != states);
 
 			return ExplicitUpwardInclusion::Check(newSmaller, newBigger,
-				Util::Identity(states));
+				Util::Identity(states), params.GetThreads());
 		}
 
 		case InclParam::ANTICHAINS_UP_SIM:
@@ -54,69 +51,52 @@ bool ExplicitTreeAutCore::CheckInclusion(
 			assert(static_cast<typename AutBase::StateType>(-1) == states);
 
 			return ExplicitUpwardInclusion::Check(smaller, bigger,
-				params.GetSimulation());
+				params.GetSimulation(), params.GetThreads());
 		}
 
+		// the recursive algorithm is replaced by the non-recursive one, which
+		// provides the optimised cache of implications too
 		case InclParam::ANTICHAINS_DOWN_NONREC_NOSIM:
-		{
-			assert(static_cast<typename AutBase::StateType>(-1) != states);
-
-			return ExplicitDownwardInclusion::Check(newSmaller, newBigger,
-				Util::Identity(states));
-		}
-
-		case InclParam::ANTICHAINS_DOWN_NONREC_SIM:
-		{
-			assert(static_cast<typename AutBase::StateType>(-1) == states);
-
-			return ExplicitDownwardInclusion::Check(smaller, bigger,
-				params.GetSimulation());
-		}
-
+		case InclParam::ANTICHAINS_DOWN_NONREC_OPT_NOSIM:
 		case InclParam::ANTICHAINS_DOWN_REC_NOSIM:
-		{
-			assert(static_cast<typename AutBase::StateType>(-1) != states);
-
-			return CheckDownwardTreeInclusion<ExplicitTreeAutCore,
-				VATA::DownwardInclusionFunctor>(newSmaller, newBigger,
-					Util::Identity(states));
-		}
-
 		case InclParam::ANTICHAINS_DOWN_REC_OPT_NOSIM:
 		{
 			assert(static_cast<typename AutBase::StateType>(-1) != states);
 
-			return CheckDownwardTreeInclusion<ExplicitTreeAutCore,
-				VATA::OptDownwardInclusionFunctor>(newSmaller, newBigger,
-					Util::Identity(states));
+			return ExplicitDownwardInclusion::Check(newSmaller, newBigger,
+				Util::Identity(states), params.GetUseDownwardCacheImpl(),
+				params.GetCacheMemory(), params.GetCacheStatistics());
 		}
 
+		case InclParam::ANTICHAINS_DOWN_NONREC_SIM:
+		case InclParam::ANTICHAINS_DOWN_NONREC_OPT_SIM:
 		case InclParam::ANTICHAINS_DOWN_REC_SIM:
-		{
-			assert(static_cast<typename AutBase::StateType>(-1) == states);
-
-			return CheckDownwardTreeInclusion<ExplicitTreeAutCore,
-				VATA::DownwardInclusionFunctor>(smaller, bigger,
-					params.GetSimulation());
-		}
-
 		case InclParam::ANTICHAINS_DOWN_REC_OPT_SIM:
 		{
 			assert(static_cast<typename AutBase::StateType>(-1) == states);
 
-			return CheckDownwardTreeInclusion<ExplicitTreeAutCore,
-				VATA::OptDownwardInclusionFunctor>(smaller, bigger,
-					params.GetSimulation());
+			return ExplicitDownwardInclusion::Check(smaller, bigger,
+				params.GetSimulation(), params.GetUseDownwardCacheImpl(),
+				params.GetCacheMemory(), params.GetCacheStatistics());
 		}
 
 		case InclParam::CONGR_DEPTH_NOSIM:
+		case InclParam::CONGR_BREADTH_NOSIM:
+		case InclParam::CONGR_DEPTH_SIM:
+		case InclParam::CONGR_BREADTH_SIM:
 		{
+			// the simulation is computed on the sanitized automata
 			newSmaller = smaller;
 			newBigger = bigger;
 			states = AutBase::SanitizeAutsForInclusion(newSmaller, newBigger);
 
-			ExplicitTreeUpwardBisimulation::BisimulationInclusion inclusion(newSmaller, newBigger);
-			return inclusion.check();
+			ExplicitTreeUpwardBisimulation::CheckOptions options;
+			options.threads = params.GetThreads();
+			options.order = ExplicitTreeUpwardBisimulation::getTodoOrder(params.GetSearchOrder());
+			options.simulation = params.GetUseSimulation();
+
+			return ExplicitTreeUpwardBisimulation::runCheck<
+				ExplicitTreeUpwardBisimulation::BisimulationInclusion>(newSmaller, newBigger, states, options);
 		}
 
 		default:
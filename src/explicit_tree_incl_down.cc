@@ -11,6 +11,8 @@
 // Standard library headers
 #include <set>
 #include <algorithm>
+#include <unordered_map>
+#include <vector>
 
 // VATA headers
 #include <vata/vata.hh>
@@ -22,6 +24,7 @@
 #include "util/cache.hh"
 #include "util/cached_binary_op.hh"
 #include "util/caching_allocator.hh"
+#include "util/macrostate_budget.hh"
 
 // TODO: a lot in common with src/explicit_tree_incl_up.cc
 
@@ -65,6 +68,7 @@ typedef size_t SymbolType;
 typedef typename VATA::Util::Cache<StateSet> BiggerTypeCache;
 
 typedef typename BiggerTypeCache::TPtr BiggerType;
+typedef typename VATA::Util::MacrostateBudget<BiggerTypeCache> MacrostateBudget;
 
 typedef typename VATA::Util::Antichain1C<SmallerType> Antichain1C;
 typedef typename VATA::Util::Antichain2Cv2<SmallerType, BiggerType> Antichain2C;
@@ -153,6 +157,9 @@ public:
 	}
 };
 
+// the result of a frame does not depend on any pair in the workset
+const size_t NO_DEPENDENCY = static_cast<size_t>(-1);
+
 struct ExpandStackFrame
 {
 	ExpandStackFrame* parent;
@@ -168,6 +175,8 @@ struct ExpandStackFrame
 	std::vector<const StateTuple*> W;
 	ChoiceFunction choiceFunction;
 	Antichain2C childrenCache;
+	size_t depth;      // the depth of the frame in the stack
+	size_t lowlink;    // the lowest depth of a frame the result depends on
 
 	ExpandStackFrame() :
 		parent(),
@@ -182,7 +191,9 @@ struct ExpandStackFrame
 		worksetIter(),
 		W(),
 		choiceFunction(),
-		childrenCache()
+		childrenCache(),
+		depth(0),
+		lowlink(NO_DEPENDENCY)
 	{ }
 
 private:
@@ -214,6 +225,8 @@ public:
 		newFrame->i = top.i;
 		newFrame->sIter = top.sIter;
 		newFrame->worksetIter = top.worksetIter;
+		newFrame->depth = top.depth;
+		newFrame->lowlink = top.lowlink;
 
 		std::swap(newFrame->W, top.W);
 		std::swap(newFrame->choiceFunction, top.choiceFunction);
@@ -233,6 +246,8 @@ public:
 		top.i = ptr_->i;
 		top.sIter = ptr_->sIter;
 		top.worksetIter = ptr_->worksetIter;
+		top.depth = ptr_->depth;
+		top.lowlink = ptr_->lowlink;
 
 		std::swap(top.W, ptr_->W);
 		std::swap(top.choiceFunction, ptr_->choiceFunction);
@@ -262,7 +277,10 @@ private:
 	top.p_S = r_i;\
 	top.P_B = S;\
 	top.retAddr = retAddr;\
-	top.worksetIter = workset.insert(r_i, S);
+	top.worksetIter = workset.insert(r_i, S);\
+	++top.depth;\
+	top.lowlink = NO_DEPENDENCY;\
+	worksetDepths[S.get()].push_back(top.depth);
 
 #define EXPAND_RETURN\
 	switch (retAddr) {\
@@ -273,10 +291,12 @@ private:
 
 #define EXPAND_POP_RETURN\
 	workset.remove(top.p_S, top.worksetIter);\
+	dependency = finishFrame(top, found);\
 	retAddr = top.retAddr;\
 	S = top.P_B;\
 	r_i = top.p_S;\
 	callEmulator.pop(top);\
+	top.lowlink = std::min(top.lowlink, dependency);\
 	EXPAND_RETURN
 
 inline bool expand(
@@ -284,6 +304,10 @@ inline bool expand(
 	VATA::Util::CachedBinaryOp<const StateSet*,
 		const StateSet*, bool>&                       lteCache,
 	Antichain2C&                                    nonincluded,
+	Antichain2C&                                    included,
+	bool                                            cacheInclusion,
+	MacrostateBudget&                               budget,
+	VATA::CacheStatistics&                          stats,
 	const SmallerType&                              p_S,
 	const BiggerType&                               P_B,
 	const DoubleIndexedTupleList&                   smallerIndex,
@@ -310,7 +334,8 @@ inline bool expand(
 	{
 		assert(x); assert(y);
 
-		return (x.get() == y.get())?(true):(lteCache.lookup(x.get(), y.get(), noncachedLte));
+		return (x.get() == y.get())?(true):
+			(lteCache.lookup(x.get(), y.get(), noncachedLte, x->size() * y->size()));
 	};
 
 	auto gte = [&lte](const BiggerType& x, const BiggerType& y) { return lte(y, x); };
@@ -336,6 +361,55 @@ inline bool expand(
 	size_t retAddr = 0;
 
 	bool found = false; // return value of simulated calls
+
+	// depths of frames of pairs in the workset (by their macrostates)
+	std::unordered_map<const StateSet*, std::vector<size_t>> worksetDepths;
+
+	// the lowest depth of a frame the returned result depends on
+	size_t dependency = NO_DEPENDENCY;
+
+	// the macrostate of the pair in the workset which implied the last query
+	const StateSet* implying = nullptr;
+
+	auto lteWorkset = [&lte, &implying](const BiggerType& x, const BiggerType& y) -> bool
+	{
+		if (!lte(x, y))
+			return false;
+
+		implying = x.get();
+
+		return true;
+	};
+
+	// removes the frame from the workset and returns the lowest depth of a frame
+	// its result depends on; a positive result which depends only on the frame
+	// itself and its descendants holds globally and is cached (if desired)
+	auto finishFrame = [&worksetDepths, &included, &lte, &gte, &ind, &inv, cacheInclusion](
+		const ExpandStackFrame& frame, bool res) -> size_t
+	{
+		auto iter = worksetDepths.find(frame.P_B.get());
+
+		assert(worksetDepths.end() != iter);
+
+		iter->second.pop_back();
+
+		if (iter->second.empty())
+			worksetDepths.erase(iter);
+
+		if (!res)
+			return NO_DEPENDENCY;
+
+		if (frame.lowlink < frame.depth)
+			return frame.lowlink;
+
+		if (cacheInclusion && !included.contains(ind.at(frame.p_S), frame.P_B, lte))
+		{
+			included.refine(inv.at(frame.p_S), frame.P_B, gte);
+			included.insert(frame.p_S, frame.P_B);
+		}
+
+		return NO_DEPENDENCY;
+	};
 _call:
 	if (smallerIndex.size() <= r_i)
 	{
@@ -353,8 +427,21 @@ _call:
 
 	assert(r_i < ind.size());
 
-	if (workset.contains(ind.at(r_i), S, lte))
+	if (cacheInclusion && included.contains(ind.at(r_i), S, lte))
+	{
+		++stats.antichains.hits;
+
+		found = true;
+
+		EXPAND_RETURN
+	}
+
+	if (workset.contains(ind.at(r_i), S, lteWorkset))
 	{
+		// the result depends on the pair in the workset
+		assert(nullptr != implying);
+		top.lowlink = std::min(top.lowlink, worksetDepths.at(implying).front());
+
 		found = true;
 
 		EXPAND_RETURN
@@ -364,11 +451,15 @@ _call:
 
 	if (nonincluded.contains(inv.at(r_i), S, gte))
 	{
+		++stats.antichains.hits;
+
 		found = false;
 
 		EXPAND_RETURN
 	}
 
+	++stats.antichains.misses;
+
 	EXPAND_PUSH
 
 	assert(r_i < smallerIndex.size());
@@ -497,7 +588,11 @@ _simret:
 					S = biggerTypeCache.lookup(tmp);
 
 					if (top.childrenCache.contains(ind.at(r_i), S, lte))
+					{
+						++stats.antichains.hits;
+
 						goto _nextchoice;
+					}
 
 					EXPAND_CALL(1)
 _stdret:
@@ -514,6 +609,9 @@ _stdret:
 						nonincluded.refine(ind.at(r_i), S, lte);
 						nonincluded.insert(r_i, S);
 					}
+
+					// answers of frames below the top stay
+					budget.enforce({&nonincluded, &included, &top.childrenCache});
 				}
 
 				EXPAND_POP_RETURN
@@ -544,9 +642,22 @@ bool VATA::ExplicitDownwardInclusion::checkInternal(
 	const DoubleIndexedTupleList&                 biggerIndex,
 	const ExplicitTreeAutCore::FinalStateSet&     biggerFinalStates,
 	const StateDiscontBinaryRelation::IndexType&  ind,
-	const StateDiscontBinaryRelation::IndexType&  inv)
+	const StateDiscontBinaryRelation::IndexType&  inv,
+	bool                                          cacheInclusion,
+	size_t                                        cacheMemory,
+	CacheStatistics*                              cacheStatistics)
 {
-	Util::CachedBinaryOp<const StateSet*, const StateSet*, bool> lteCache;
+	typedef Util::CachedBinaryOp<const StateSet*, const StateSet*, bool> LteCache;
+
+	LteCache lteCache;
+
+	if (cacheMemory)
+	{	// half of the budget is for the comparisons, half for the macrostates
+		lteCache.setCapacity(std::max<size_t>(1,
+			cacheMemory / 2 / LteCache::ENTRY_MEMORY));
+	}
+
+	CacheStatistics stats;
 
 	BiggerTypeCache biggerTypeCache(
 		[&lteCache](const StateSet* v)
@@ -557,6 +668,7 @@ bool VATA::ExplicitDownwardInclusion::checkInternal(
 	);
 
 	Antichain2C nonincluded;
+	Antichain2C included;
 
 	std::vector<size_t> v(biggerFinalStates.begin(), biggerFinalStates.end());
 
@@ -564,11 +676,35 @@ bool VATA::ExplicitDownwardInclusion::checkInternal(
 
 	auto biggerF = biggerTypeCache.lookup(v);
 
+	MacrostateBudget budget(biggerTypeCache,
+		cacheMemory ? std::max<size_t>(1, cacheMemory / 2) : 0);
+
+	bool result = true;
+
 	for (auto& f : smallerFinalStates)
 	{
-		if (!expand(biggerTypeCache, lteCache, nonincluded, f, biggerF, smallerIndex, biggerIndex, ind, inv))
-			return false;
+		if (!expand(biggerTypeCache, lteCache, nonincluded, included, cacheInclusion,
+			budget, stats, f, biggerF, smallerIndex, biggerIndex, ind, inv))
+		{
+			result = false;
+			break;
+		}
+	}
+
+	if (nullptr != cacheStatistics)
+	{
+		stats.lte.hits = lteCache.hits();
+		stats.lte.misses = lteCache.misses();
+		stats.lte.evictions = lteCache.evictions();
+
+		stats.macrostates.hits = biggerTypeCache.hits();
+		stats.macrostates.misses = biggerTypeCache.misses();
+		stats.macrostates.evictions = budget.evictedMacrostates();
+
+		stats.antichains.evictions = budget.evictedEntries();
+
+		*cacheStatistics = stats;
 	}
 
-	return true;
+	return result;
 }
@@ -16,6 +16,17 @@
 namespace VATA { class ExplicitDownwardInclusion; }
 
 
+/**
+ * @brief  Downward inclusion checking of explicit tree automata
+ *
+ * The expansion of pairs is driven by an explicit stack of heap-allocated
+ * frames instead of recursion, so the depth of the automata is not limited by
+ * the native stack. Pairs known not to be included are cached. If @p
+ * cacheInclusion is set, positive results of finished frames which do not
+ * depend on an assumption about a pair of an unfinished frame above them are
+ * cached too (the optimised cache of implications).
+ */
+
 class VATA::ExplicitDownwardInclusion
 {
 public:
@@ -80,7 +91,10 @@ public:
 	static bool Check(
 		const Aut&            smaller,
 		const Aut&            bigger,
-		const Rel&            preorder)
+		const Rel&            preorder,
+		bool                  cacheInclusion = false,
+		size_t                cacheMemory = 0,
+		CacheStatistics*      cacheStatistics = nullptr)
 	{
 		DoubleIndexedTupleList smallerIndex, biggerIndex;
 
@@ -100,7 +114,8 @@ public:
 		preorder.buildIndex(ind, inv);
 
 		return ExplicitDownwardInclusion::checkInternal(
-			smallerIndex, smaller.GetFinalStates(), biggerIndex, bigger.GetFinalStates(), ind, inv
+			smallerIndex, smaller.GetFinalStates(), biggerIndex, bigger.GetFinalStates(), ind, inv,
+			cacheInclusion, cacheMemory, cacheStatistics
 		);
 	}
 
@@ -153,7 +168,10 @@ private:
 		const DoubleIndexedTupleList&                  biggerIndex,
 		const ExplicitTreeAutCore::FinalStateSet&      biggerFinalStates,
 		const StateDiscontBinaryRelation::IndexType&   ind,
-		const StateDiscontBinaryRelation::IndexType&   inv
+		const StateDiscontBinaryRelation::IndexType&   inv,
+		bool                                           cacheInclusion,
+		size_t                                         cacheMemory,
+		CacheStatistics*                               cacheStatistics
 	);
 
 /*
@@ -9,8 +9,12 @@
  *****************************************************************************/
 
 // Standard library headers
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <set>
 #include <algorithm>
+#include <unordered_map>
 
 // VATA headers
 #include <vata/vata.hh>
@@ -21,6 +25,7 @@
 #include "explicit_tree_incl_up.hh"
 #include "util/cache.hh"
 #include "util/cached_binary_op.hh"
+#include "util/worker_pool.hh"
 
 unsigned long pair_cnt2, true_cnt2;
 
@@ -206,6 +211,70 @@ public:
 		return state_.size();
 	}
 };
+
+
+/*
+ * Computes the post of the bigger sets chosen for the children of a transition
+ * under the symbol (an antichain of states w.r.t. the simulation) and returns
+ * whether some of its states is final.
+ */
+template <class EvalTransitions, class Index>
+bool computePost(
+	const SymbolType&                                 symbol,
+	const ChoiceVector&                               choiceVector,
+	EvalTransitions&                                  evalTransitions,
+	const VATA::ExplicitTreeAutCore::FinalStateSet&   biggerFinalStates,
+	const Index&                                      ind,
+	const Index&                                      inv,
+	Antichain1C&                                      post)
+{
+	post.clear();
+	bool isAccepting = false;
+
+	assert(choiceVector(0));
+
+	auto firstSet = evalTransitions(symbol, 0, choiceVector(0).get());
+
+	assert(firstSet);
+
+	std::list<const VATA::BUIndexTransition*> biggerTransitions(
+		firstSet->begin(), firstSet->end()
+	);
+
+	for (size_t k = 1; k < choiceVector.size(); ++k)
+	{
+		assert(choiceVector(k));
+
+		auto transitions = evalTransitions(
+			symbol, k, choiceVector(k).get()
+		);
+
+		assert(transitions);
+
+		intersectionByLookup(biggerTransitions, *transitions);
+	}
+
+	for (auto& biggerTransition : biggerTransitions)
+	{
+		assert(biggerTransition);
+		assert(biggerTransition->state() < ind.size());
+
+		if (post.contains(ind.at(biggerTransition->state())))
+		{
+			continue;
+		}
+
+		assert(biggerTransition->state() < inv.size());
+
+		post.refine(inv.at(biggerTransition->state()));
+		post.insert(biggerTransition->state());
+
+		isAccepting = isAccepting ||
+			biggerFinalStates.count(biggerTransition->state());
+	}
+
+	return isAccepting;
+}
 } // namespace
 
 
@@ -217,7 +286,8 @@ bool VATA::ExplicitUpwardInclusion::checkInternal(
 	const SymbolToDoubleIndexedTransitionListMap&     biggerIndex,
 	const ExplicitTreeAutCore::FinalStateSet&         biggerFinalStates,
 	const StateDiscontBinaryRelation::IndexType&      ind,
-	const StateDiscontBinaryRelation::IndexType&      inv)
+	const StateDiscontBinaryRelation::IndexType&      inv,
+	size_t                                            threads)
 {
 	auto noncachedLte = [&ind](const StateSet* x, const StateSet* y) -> bool
 	{
@@ -303,12 +373,84 @@ bool VATA::ExplicitUpwardInclusion::checkInternal(
 		);
 	};
 
+	// bits of states smaller than a state, for signatures of bigger sets
+	std::unordered_map<SmallerType, Antichain2C::Bits> downBits;
+	for (auto& stateToSmaller : inv)
+	{
+		Antichain2C::Bits& bits = downBits[stateToSmaller.first];
+		bits.clear();
+		for (auto& smallerState : stateToSmaller.second)
+		{
+			bits.set(smallerState);
+		}
+	}
+
+	std::unordered_map<const StateSet*, Antichain2C::Signature> signatures;
+
+	auto signature = [&downBits, &signatures](const BiggerType& x, Antichain2C::Signature& sig)
+	{
+		assert(x);
+
+		auto res = signatures.insert(std::make_pair(x.get(), Antichain2C::Signature()));
+		if (res.second)
+		{
+			Antichain2C::Signature& newSig = res.first->second;
+			newSig.states.clear();
+			newSig.down.clear();
+
+			for (auto& state : *x)
+			{
+				auto bits = downBits.find(state);
+
+				newSig.states.set(state);
+				if (downBits.end() == bits)
+				{
+					newSig.down.set(state);
+				}
+				else
+				{
+					newSig.down.add(bits->second);
+				}
+			}
+		}
+
+		sig = res.first->second;
+	};
+
+	// workers of the parallel version have their own caches of transitions
+	GCC_DIAG_OFF(effc++)
+	struct Workspace
+	{
+	GCC_DIAG_ON(effc++)
+		Util::CachedBinaryOp<
+			std::pair<SymbolType, size_t>, const StateSet*, TransitionSetPtr
+		> evalTransitionsCache;
+		Antichain1C post;
+	};
+
+	typedef Util::WorkerPool WorkerPool;
+
+	std::unique_ptr<WorkerPool> pool;
+	std::vector<Workspace> workspaces;
+
+	if (threads > 1)
+	{
+		pool.reset(new WorkerPool(threads));
+		workspaces.resize(pool->size());
+	}
+
 	BiggerTypeCache biggerTypeCache(
-		[&lteCache, &evalTransitionsCache](const StateSet* v)
+		[&lteCache, &evalTransitionsCache, &signatures, &workspaces](const StateSet* v)
 		{
 			lteCache.invalidateFirst(v);
 			lteCache.invalidateSecond(v);
 			evalTransitionsCache.invalidateSecond(v);
+			signatures.erase(v);
+
+			for (auto& workspace : workspaces)
+			{
+				workspace.evalTransitionsCache.invalidateSecond(v);
+			}
 		}
 	);
 
@@ -316,6 +458,9 @@ bool VATA::ExplicitUpwardInclusion::checkInternal(
 
 	Antichain2C temporary, processed;
 
+	// the processed antichain grows big, its elements are filtered by signatures
+	processed.setSignature(signature);
+
 	OrderedType next;
 
 	bool isAccepting;
@@ -400,6 +545,169 @@ bool VATA::ExplicitUpwardInclusion::checkInternal(
 
 	ChoiceVector choiceVector(processed, fixedList);
 
+	/*
+	 * Parallel version of the post of processed below. The antichain of
+	 * processed pairs is only read while workers enumerate choices of bigger
+	 * sets for transitions of the smaller state (one task per transition and position of q
+	 * among its children), compute posts and filter them by subsumption.
+	 * Results of the tasks are then inserted to processed in the order of
+	 * tasks. Returns false when inclusion does not hold.
+	 */
+	auto parallelPost = [&](const SmallerType& smaller) -> bool
+	{
+		struct Task
+		{
+			SymbolType symbol;
+			size_t index;
+			const Transition* transition;
+		};
+
+		std::vector<Task> tasks;
+
+		for (const auto& symbolToIndexedTrans : smallerIndex.at(smaller))
+		{
+			size_t j = 0;
+
+			for (auto& smallerTransitions : symbolToIndexedTrans.second)
+			{
+				for (auto& smallerTransition : smallerTransitions)
+				{
+					assert(smallerTransition);
+
+					Task task = {symbolToIndexedTrans.first, j, smallerTransition.get()};
+					tasks.push_back(task);
+				}
+
+				++j;
+			}
+		}
+
+		auto localLte = [&noncachedLte](const BiggerType& x, const BiggerType& y) -> bool
+		{
+			assert(x); assert(y);
+
+			return (x.get() == y.get()) || noncachedLte(x.get(), y.get());
+		};
+
+		auto localGte = [&localLte](const BiggerType& x, const BiggerType& y) { return localLte(y, x); };
+
+		std::vector<std::vector<std::pair<SmallerType, BiggerType>>> results(tasks.size());
+		std::atomic<bool> fails(false);
+
+		auto runTask = [&](size_t worker, size_t i)
+		{
+			const Task& task = tasks[i];
+			Workspace& workspace = workspaces[worker];
+
+			auto localEvalTransitions = [&noncachedEvalTransitions, &workspace](
+				const SymbolType& symbol, size_t k, const StateSet* states)
+				-> TransitionSetPtr
+			{
+				assert(states);
+
+				return workspace.evalTransitionsCache.lookup(
+					std::make_pair(symbol, k), states, noncachedEvalTransitions
+				);
+			};
+
+			ChoiceVector choices(processed, fixedList);
+
+			if (!choices.build(task.transition->children(), task.index))
+			{
+				return;
+			}
+
+			const SmallerType& state = task.transition->state();
+
+			assert(state < ind.size());
+			assert(state < inv.size());
+
+			Antichain2C local;
+
+			do
+			{
+				if (fails)
+				{
+					return;
+				}
+
+				const bool accepting = computePost(task.symbol, choices,
+					localEvalTransitions, biggerFinalStates, ind, inv, workspace.post);
+
+				if (workspace.post.data().empty() ||
+					(!accepting && smallerFinalStates.count(state)))
+				{
+					fails = true;
+					return;
+				}
+
+				StateSet tmp(workspace.post.data().begin(), workspace.post.data().end());
+
+				std::sort(tmp.begin(), tmp.end());
+
+				if (checkIntersection(ind.at(state), tmp))
+				{
+					continue;
+				}
+
+				auto ptr = std::make_shared<StateSet>(std::move(tmp));
+
+				if (local.contains(ind.at(state), ptr, localLte))
+				{
+					continue;
+				}
+
+				local.refine(inv.at(state), ptr, localGte);
+				local.insert(state, ptr);
+
+			} while (choices.next());
+
+			for (auto& smallerBiggerListPair : local.data())
+			{
+				for (auto& bigger : smallerBiggerListPair.second)
+				{
+					results[i].push_back(std::make_pair(smallerBiggerListPair.first, bigger));
+				}
+			}
+		};
+
+		if (tasks.size() > 1)
+		{
+			pool->run(tasks.size(), runTask);
+		}
+		else if (!tasks.empty())
+		{	// waking the workers is not worth it
+			runTask(0, 0);
+		}
+
+		if (fails)
+		{
+			return false;
+		}
+
+		for (auto& result : results)
+		{
+			for (auto& smallerBiggerPair : result)
+			{
+				const SmallerType& state = smallerBiggerPair.first;
+				auto ptr = biggerTypeCache.lookup(*smallerBiggerPair.second);
+
+				if (processed.contains(ind.at(state), ptr, lte))
+				{
+					continue;
+				}
+
+				processed.refine(inv.at(state), ptr, gte, Eraser(next));
+
+				Antichain2C::TList::iterator iter = processed.insert(state, ptr);
+
+				next.insert(std::make_pair(state, iter));
+			}
+		}
+
+		return true;
+	};
+
 	while (!next.empty())
 	{
 		// pair_cnt2++;
@@ -420,6 +728,16 @@ bool VATA::ExplicitUpwardInclusion::checkInternal(
 		}
 		auto& smallerTransitionIndex = smallerIndex.at(q);
 
+		if (pool)
+		{	// posts for transitions are computed in parallel
+			if (!parallelPost(q))
+			{
+				return false;
+			}
+
+			continue;
+		}
+
 		for (const auto& symbolToIndexedTrans : smallerTransitionIndex)
 		{
 			const size_t symbol = symbolToIndexedTrans.first;
@@ -438,50 +756,8 @@ bool VATA::ExplicitUpwardInclusion::checkInternal(
 
 					do
 					{
-						post.clear();
-						isAccepting = false;
-
-						assert(choiceVector(0));
-
-						auto firstSet = evalTransitions(symbol, 0, choiceVector(0).get());
-
-						assert(firstSet);
-
-						std::list<const Transition*> biggerTransitions(
-							firstSet->begin(), firstSet->end()
-						);
-
-						for (size_t k = 1; k < choiceVector.size(); ++k)
-						{
-							assert(choiceVector(k));
-
-							auto transitions = evalTransitions(
-								symbol, k, choiceVector(k).get()
-							);
-
-							assert(transitions);
-
-							intersectionByLookup(biggerTransitions, *transitions);
-						}
-
-						for (auto& biggerTransition : biggerTransitions)
-						{
-							assert(biggerTransition);
-							assert(biggerTransition->state() < ind.size());
-
-							if (post.contains(ind.at(biggerTransition->state())))
-							{
-								continue;
-							}
-
-							assert(biggerTransition->state() < inv.size());
-
-							post.refine(inv.at(biggerTransition->state()));
-							post.insert(biggerTransition->state());
-
-							isAccepting = isAccepting ||
-								biggerFinalStates.count(biggerTransition->state());
-						}
+						isAccepting = computePost(symbol, choiceVector, evalTransitions,
+							biggerFinalStates, ind, inv, post);
 
 						if (post.data().empty())
 						{
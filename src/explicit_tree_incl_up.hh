@@ -26,13 +26,15 @@ class VATA::ExplicitUpwardInclusion
 
 public:
 
+	// with more threads, posts of a processed pair are computed in parallel
 	template <
 		class Aut,
 		class Rel>
 	static bool Check(
 		const Aut&        smaller,
 		const Aut&        bigger,
-		const Rel&        preorder)
+		const Rel&        preorder,
+		size_t            threads = 1)
 	{
 		IndexedSymbolToIndexedTransitionListMap smallerIndex;
 		SymbolToDoubleIndexedTransitionListMap biggerIndex;
@@ -67,7 +69,8 @@ public:
 			biggerIndex,
 			bigger.GetFinalStates(),
 			ind,
-			inv
+			inv,
+			threads
 		);
 	}
 
@@ -81,7 +84,8 @@ private:
 		const SymbolToDoubleIndexedTransitionListMap&     biggerIndex,
 		const ExplicitTreeAutCore::FinalStateSet&         biggerFinalStates,
 		const StateDiscontBinaryRelation::IndexType&      ind,
-		const StateDiscontBinaryRelation::IndexType&      inv
+		const StateDiscontBinaryRelation::IndexType&      inv,
+		size_t                                            threads
 	);
 };
 
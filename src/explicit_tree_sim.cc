@@ -49,7 +49,7 @@ StateDiscontBinaryRelation ExplicitTreeAutCore::ComputeUpwardSimulation(
 	assert(SimParam::e_sim_relation::TA_UPWARD == params.GetRelation());
 	if (params.GetNumStates() != static_cast<size_t>(-1))
 	{
-		return this->ComputeUpwardSimulation(params.GetNumStates());
+		return this->ComputeUpwardSimulation(params.GetNumStates(), params.GetThreads());
 	}
 	else
 	{
@@ -59,7 +59,8 @@ StateDiscontBinaryRelation ExplicitTreeAutCore::ComputeUpwardSimulation(
 
 
 StateDiscontBinaryRelation ExplicitTreeAutCore::ComputeUpwardSimulation(
-	size_t                                 size) const
+	size_t                                 size,
+	size_t                                 threads) const
 {
 	std::vector<std::vector<size_t>> partition;
 
@@ -71,7 +72,7 @@ StateDiscontBinaryRelation ExplicitTreeAutCore::ComputeUpwardSimulation(
 		{return stateCnt++;});
 
 	ExplicitLTS lts = this->TranslateUpward(partition, relation, VATA::Util::Identity(size), transl);
-	StateBinaryRelation ltsSim = lts.computeSimulation(partition, relation, size);
+	StateBinaryRelation ltsSim = lts.computeSimulation(partition, relation, size, threads);
 	return StateDiscontBinaryRelation(ltsSim, translMap);
 }
 
@@ -82,7 +83,7 @@ StateDiscontBinaryRelation ExplicitTreeAutCore::ComputeDownwardSimulation(
 	assert(SimParam::e_sim_relation::TA_DOWNWARD == params.GetRelation());
 	if (params.GetNumStates() != static_cast<size_t>(-1))
 	{
-		return this->ComputeDownwardSimulation(params.GetNumStates());
+		return this->ComputeDownwardSimulation(params.GetNumStates(), params.GetThreads());
 	}
 	else
 	{
@@ -93,7 +94,8 @@ StateDiscontBinaryRelation ExplicitTreeAutCore::ComputeDownwardSimulation(
 
 
 StateDiscontBinaryRelation ExplicitTreeAutCore::ComputeDownwardSimulation(
-	size_t                                 size) const
+	size_t                                 size,
+	size_t                                 threads) const
 {
 	StateToStateMap translMap;
 	size_t stateCnt = 0;
@@ -101,6 +103,6 @@ StateDiscontBinaryRelation ExplicitTreeAutCore::ComputeDownwardSimulation(
 		{return stateCnt++;});
 
 	ExplicitLTS lts = this->TranslateDownward(size, transl);
-	StateBinaryRelation ltsSim = lts.computeSimulation(size);
+	StateBinaryRelation ltsSim = lts.computeSimulation(size, threads);
 	return StateDiscontBinaryRelation(ltsSim, translMap);
 }
@@ -46,5 +46,25 @@ std::string VATA::InclParam::toString() const
 	result += "Use simulation: ";
 	result += Convert::ToString(this->GetUseSimulation()) + "\n";
 
+	result += "Equivalence checking: ";
+	result += Convert::ToString(this->GetEquivalence()) + "\n";
+
+	result += "Search order: ";
+	switch (this->GetSearchOrder())
+	{
+		case e_search_order::breadth: result += "Breadth"; break;
+		case e_search_order::depth:   result += "Depth";   break;
+		case e_search_order::size:    result += "Size";    break;
+		case e_search_order::final:   result += "Final";   break;
+		default: assert(false);
+	}
+	result += "\n";
+
+	result += "Threads: ";
+	result += Convert::ToString(this->GetThreads()) + "\n";
+
+	result += "Cache memory: ";
+	result += Convert::ToString(this->GetCacheMemory()) + "\n";
+
 	return result;
 }
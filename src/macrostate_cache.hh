@@ -15,64 +15,157 @@
 // VATA headers
 #include <vata/vata.hh>
 
+#include "sorted_state_set.hh"
+
 // Standard library headers
-#include <list>
-#include <unordered_map>
+#include <cstdint>
+#include <deque>
+#include <stdexcept>
+#include <vector>
 
 namespace VATA {
-	template<class Aut> class MacroStateCache;
+	template<class Aut, class StateSet = typename Aut::StateSet> class MacroStateCache;
 }
 
 /*
- * Cache for caching macro state
+ * Cache for caching macro state. Every distinct macrostate is stored
+ * only once in an arena with stable addresses and it gets an id given
+ * by the order of its first insertion. Macrostates are found by their
+ * hash in an open addressing table of ids (linear probing, the table
+ * is at most half full).
  */
-template<class Aut>
+GCC_DIAG_OFF(effc++)
+template<class Aut, class StateSet>
 class VATA::MacroStateCache {
+GCC_DIAG_ON(effc++)
+public:
+	typedef uint32_t IdType;
+
+	static const IdType NO_ID = static_cast<IdType>(-1);
+
 private:
-	typedef typename Aut::StateSet StateSet;
-	typedef std::list<StateSet> SetList;
-	typedef std::unordered_map<size_t,SetList> CacheMap;
+	std::deque<StateSet> sets_; // id -> macrostate
+	std::vector<size_t> hashes_; // id -> hash of macrostate
+	std::vector<IdType> slots_; // open addressing table of ids
+
+	size_t hits_; // insertions of already cached macrostates
+	size_t collisions_; // probed slots with a different macrostate
+
+	// Mixing of a single state, the sum of mixed states does not depend
+	// on the order of states and it can be updated incrementally
+	static uint64_t MixState(uint64_t state) {
+		state += 0x9E3779B97F4A7C15ULL;
+		state = (state ^ (state >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		state = (state ^ (state >> 27)) * 0x94D049BB133111EBULL;
+		return state ^ (state >> 31);
+	}
+
+	// Sorted sets keep their hash
+	template<class State>
+	static size_t ComputeHash(const SortedStateSet<State>& set) {
+		return set.GetHash();
+	}
+
+	template<class Set>
+	static size_t ComputeHash(const Set& set) {
+		uint64_t hash = set.size();
+		for (auto& state : set) {
+			hash += MixState(state);
+		}
+		return static_cast<size_t>(MixState(hash));
+	}
+
+	// Returns slot of the macrostate or the first empty slot
+	size_t FindSlot(const StateSet& set, size_t hash, size_t& collisions) const {
+		const size_t mask = slots_.size() - 1;
+		size_t slot = hash & mask;
+		while (slots_[slot] != NO_ID) {
+			const IdType id = slots_[slot];
+			if (hashes_[id] == hash && sets_[id].size() == set.size() &&
+					sets_[id] == set) {
+				break;
+			}
+			++collisions;
+			slot = (slot + 1) & mask;
+		}
+		return slot;
+	}
+
+	// Doubles the size of the table of ids
+	void Grow() {
+		std::vector<IdType> old(2 * slots_.size(), NO_ID);
+		old.swap(slots_);
+		const size_t mask = slots_.size() - 1;
+		for (IdType id : old) {
+			if (id == NO_ID) {
+				continue;
+			}
+			size_t slot = hashes_[id] & mask;
+			while (slots_[slot] != NO_ID) {
+				slot = (slot + 1) & mask;
+			}
+			slots_[slot] = id;
+		}
+	}
 
-	CacheMap cacheMap;
 public:
-	MacroStateCache() : cacheMap(){}
+	MacroStateCache() :
+		sets_(),
+		hashes_(),
+		slots_(16, NO_ID),
+		hits_(0),
+		collisions_(0)
+	{}
+
+	// Function computes hash of the macrostate
+	static size_t Hash(const StateSet& set) {
+		return ComputeHash(set);
+	}
 
 	// Function inserts a new element to macrostate cache, when
-	// the element is already presented it will return pointer to it
-	StateSet& insert(size_t key, StateSet& value) {
-		auto areEqual = [] (StateSet& lss, StateSet& rss) -> bool {
-		 if (lss.size() != rss.size()) {
-			 return false;
-		 }
-		 if (!lss.size() || !rss.size()) {
-			 return false;
-		 }
-		 for (auto& ls : lss) {
-			 if (!rss.count(ls)) {
-				 return false;
-			 }
-		 }
-
-			return true;
-	 };
-
-		auto iter = cacheMap.find(key);
-		if (iter == cacheMap.end()) { // new value
-			auto& list = cacheMap.insert(std::make_pair(key,SetList())).first->second;
-			list.push_back(StateSet(value));
-			return list.back();
+	// the element is already presented it will return its id
+	IdType InsertId(const StateSet& value) {
+		const size_t hash = Hash(value);
+		const size_t slot = FindSlot(value, hash, collisions_);
+		if (slots_[slot] != NO_ID) {
+			++hits_;
+			return slots_[slot];
 		}
-		else {
-			for (auto& set : iter->second) { // set already cached
-				if (areEqual(set,value)) {
-					return set;
-				}
-			}
-			iter->second.push_back(StateSet(value));
-			return iter->second.back();
+
+		if (sets_.size() >= NO_ID) {
+			throw std::overflow_error("Too many macrostates in cache");
 		}
+		const IdType id = static_cast<IdType>(sets_.size());
+		sets_.push_back(value);
+		hashes_.push_back(hash);
+		slots_[slot] = id;
+		if (2 * sets_.size() > slots_.size()) {
+			Grow();
+		}
+		return id;
+	}
+
+	// Function inserts a new element to macrostate cache, when
+	// the element is already presented it will return reference to it
+	StateSet& insert(const StateSet& value) {
+		return sets_[InsertId(value)];
 	}
 
+	// Returns id of the cached macrostate or NO_ID
+	IdType Find(const StateSet& value) const {
+		size_t collisions = 0;
+		return slots_[FindSlot(value, Hash(value), collisions)];
+	}
+
+	const StateSet& Get(IdType id) const { return sets_[id]; }
+
+	size_t size() const { return sets_.size(); }
+	size_t GetHits() const { return hits_; }
+	size_t GetCollisions() const { return collisions_; }
 };
 
+template<class Aut, class StateSet>
+const typename VATA::MacroStateCache<Aut,StateSet>::IdType
+	VATA::MacroStateCache<Aut,StateSet>::NO_ID;
+
 #endif
@@ -12,9 +12,18 @@
 #ifndef _VATA_UTIL_NORMAL_FOR_REL_HH__
 #define _VATA_UTIL_NORMAL_FOR_REL_HH__
 
+// Standard library headers
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "sorted_state_set.hh"
+
 namespace VATA {
 	template <class Rel> class NormalFormRelPreorder;
-	template <class Rel> class NormalFormRelSimulation;
+	template <class Rel, class StateSet = ExplicitFiniteAut::StateSet>
+		class NormalFormRelSimulation;
 }
 
 /*
@@ -26,62 +35,150 @@ template <class Rel>
 class VATA::NormalFormRelPreorder {
 
 private: // private data types
-	typedef ExplicitFiniteAut ExplicitFA;
-	typedef typename ExplicitFA::StateSet StateSet;
-	typedef typename ExplicitFA::StateType StateType;
-
-private: // private data members;
-	Rel preorder_;
+	typedef typename Rel::IndexType IndexType;
 
 public: // public functions
 
-	NormalFormRelPreorder(Rel preorder) : preorder_(preorder) {}
+	NormalFormRelPreorder(const Rel& /*preorder*/, const IndexType& /*inv*/) {}
 
 	/*
 	 * It is not possible to apply any additional rules so
-	 * the function does nothing
+	 * the normal form is the macrostate itself
 	 */
-	void applyRule(StateSet& /*normalForm*/)
+	template <class StateSet>
+	const StateSet& GetNormalForm(const StateSet& macroState)
 	{
-		return;
+		return macroState;
 	}
 };
 
 /*
  * Class is used for application of a rule for computation
  * of a normal form based on simulation preorder.
+ * The preorder is compiled to rows of bits, the row of a state
+ * contains all states simulated by it, so the normal form of
+ * a macrostate is an union of rows of its states. Normal forms
+ * are cached for macrostates which addresses are stable (the ones
+ * stored in a cache of macrostates).
  */
-template <class Rel>
+GCC_DIAG_OFF(effc++)
+template <class Rel, class StateSet>
 class VATA::NormalFormRelSimulation {
+GCC_DIAG_ON(effc++)
 
 private: // private data types
 	typedef ExplicitFiniteAut ExplicitFA;
-	typedef typename ExplicitFA::StateSet StateSet;
 	typedef typename ExplicitFA::StateType StateType;
+	typedef typename Rel::IndexType IndexType;
+
+	typedef uint64_t WordType;
+	static const size_t WORD_BITS = 64;
 
 private: // private data members;
-	Rel preorder_;
+	size_t rowCount_; // number of states with a row
+	size_t rowWords_; // number of words of a row
+	std::vector<WordType> rows_; // state -> states simulated by it
+	std::vector<WordType> words_; // union of rows of a macrostate
+	std::vector<StateType> states_; // states of a normal form
 
-public: // public functions
+	std::unordered_map<const StateSet*, StateSet> normalForms_;
+
+	/*
+	 * Computes the union of rows of states of the macrostate.
+	 * States without a row are simulated just by themselves.
+	 */
+	void Saturate(const StateSet& macroState, StateSet& normalForm)
+	{
+		std::fill(words_.begin(), words_.end(), 0);
+		states_.clear();
+		for (auto& state : macroState)
+		{
+			if (state >= rowCount_)
+			{
+				states_.push_back(state);
+				continue;
+			}
+
+			const WordType* row = rows_.data() + state * rowWords_;
+			for (size_t i = 0; i < rowWords_; ++i)
+			{
+				words_[i] |= row[i];
+			}
+		}
+
+		for (size_t i = 0; i < rowWords_; ++i)
+		{
+			for (WordType word = words_[i]; word; word &= word - 1)
+			{
+				states_.push_back(static_cast<StateType>(
+					i * WORD_BITS + __builtin_ctzll(word)));
+			}
+		}
+
+		normalForm = StateSet(states_.begin(), states_.end());
+	}
 
-	NormalFormRelSimulation(Rel preorder) : preorder_(preorder) {}
+public: // public functions
 
 	/*
-	 * All states that are simulated by some state which is allready
-	 * in normal form are also added to this normal form.
+	 * Rows are built from the inverted index of the preorder
+	 * which maps a state to the states simulated by it
 	 */
-	void applyRule(StateSet& normalForm)
+	NormalFormRelSimulation(const Rel& /*preorder*/, const IndexType& inv) :
+		rowCount_(0),
+		rowWords_(0),
+		rows_(),
+		words_(),
+		states_(),
+		normalForms_()
 	{
-		for (auto& state : normalForm)
+		for (auto& stateToSimulated : inv)
 		{
-			for (size_t r=0; r < preorder_.size(); r++) // for all states in simulation
+			rowCount_ = std::max(rowCount_, stateToSimulated.first + 1);
+			for (auto& simulated : stateToSimulated.second)
 			{
-				if (preorder_.get(r,state))
-				{
-					normalForm.insert(r);
-				}
+				rowCount_ = std::max(rowCount_, simulated + 1);
+			}
+		}
+
+		rowWords_ = (rowCount_ + WORD_BITS - 1) / WORD_BITS;
+		rows_.assign(rowCount_ * rowWords_, 0);
+		words_.assign(rowWords_, 0);
+
+		for (size_t state = 0; state < rowCount_; ++state)
+		{ // the preorder is reflexive
+			rows_[state * rowWords_ + state / WORD_BITS] |=
+				WordType(1) << (state % WORD_BITS);
+		}
+
+		for (auto& stateToSimulated : inv)
+		{
+			WordType* row = rows_.data() + stateToSimulated.first * rowWords_;
+			for (auto& simulated : stateToSimulated.second)
+			{
+				row[simulated / WORD_BITS] |= WordType(1) << (simulated % WORD_BITS);
 			}
 		}
 	}
+
+	/*
+	 * All states that are simulated by some state of the macrostate
+	 * are added to its normal form. The macrostate has to be kept
+	 * on the same address while the normal form is used.
+	 */
+	const StateSet& GetNormalForm(const StateSet& macroState)
+	{
+		auto inserted = normalForms_.insert(std::make_pair(&macroState, StateSet()));
+		if (inserted.second)
+		{
+			Saturate(macroState, inserted.first->second);
+		}
+
+		return inserted.first->second;
+	}
 };
+
+template <class Rel, class StateSet>
+const size_t VATA::NormalFormRelSimulation<Rel,StateSet>::WORD_BITS;
+
 #endif
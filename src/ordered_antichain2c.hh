@@ -56,6 +56,13 @@ public:
 
 	OrderedAntichain2C() : antichain_(), data_() {}
 
+	// use the index of signatures of the antichain
+	void setSignature(const typename Antichain2C::SignatureFunc& signature) {
+
+		this->antichain_.setSignature(signature);
+
+	}
+
 	const typename Antichain2C::TList* lookup(const first_type& key) const {
 
 		return this->antichain_.lookup(key);
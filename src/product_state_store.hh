@@ -0,0 +1,108 @@
+/*****************************************************************************
+ *	VATA Finite Automata Library
+ *
+ *	Copyright (c) 2013	Martin Hruska <xhrusk16@stud.fit.vutbr.cz>
+ *
+ *	Description:
+ *	Header file for store of explored product states of congruence
+ *	algorithm.
+ *
+ *****************************************************************************/
+
+
+#ifndef UTIL_PRODUCT_STATE_STORE_
+#define UTIL_PRODUCT_STATE_STORE_
+
+// VATA headers
+#include <vata/vata.hh>
+
+// Standard library headers
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Boost headers
+#include <boost/functional/hash.hpp>
+
+namespace VATA {
+	template <class ProductState, class SymbolType> class ProductStateStore;
+}
+
+/*
+ * Store of explored product states. Every product state gets an id given
+ * by the order of its insertion and it keeps the id of the product state
+ * from which it has been reached with the symbol of the transition
+ * (the initial product state has no parent), so the word leading to any
+ * explored product state can be reconstructed.
+ */
+GCC_DIAG_OFF(effc++)
+template <class ProductState, class SymbolType>
+class VATA::ProductStateStore {
+GCC_DIAG_ON(effc++)
+public: // data types
+	typedef size_t IdType;
+
+	static const IdType NO_ID = static_cast<IdType>(-1);
+
+private: // private data types
+	struct Parent {
+		IdType id;
+		SymbolType symbol;
+	};
+
+private: // private data members
+	std::unordered_map<ProductState,IdType,boost::hash<ProductState>> ids_;
+	std::vector<Parent> parents_; // id -> parent
+
+public:
+	ProductStateStore() :
+		ids_(),
+		parents_()
+	{}
+
+	/*
+	 * Insert the product state reached from the parent by the symbol
+	 * @return Id of the product state and true if it has been inserted
+	 */
+	std::pair<IdType,bool> Insert(const ProductState& state,
+			IdType parent = NO_ID, const SymbolType& symbol = SymbolType()) {
+		auto res = ids_.insert(std::make_pair(state, parents_.size()));
+		if (res.second) {
+			Parent p = {parent, symbol};
+			parents_.push_back(p);
+		}
+		return std::make_pair(res.first->second, res.second);
+	}
+
+	/*
+	 * Returns id of the product state or NO_ID
+	 */
+	IdType Find(const ProductState& state) const {
+		auto iter = ids_.find(state);
+		return iter == ids_.end() ? NO_ID : iter->second;
+	}
+
+	/*
+	 * Store the word leading from the initial product state
+	 * to the product state with the given id (NO_ID gives empty word)
+	 */
+	template <class Word>
+	void GetWord(IdType id, Word& word) const {
+		word.clear();
+		for ( ; id != NO_ID; id = parents_[id].id) {
+			if (parents_[id].id != NO_ID) {
+				word.push_back(parents_[id].symbol);
+			}
+		}
+		std::reverse(word.begin(), word.end());
+	}
+
+	size_t size() const { return parents_.size(); }
+};
+
+template <class ProductState, class SymbolType>
+const typename VATA::ProductStateStore<ProductState,SymbolType>::IdType
+	VATA::ProductStateStore<ProductState,SymbolType>::NO_ID;
+
+#endif
@@ -0,0 +1,144 @@
+/*****************************************************************************
+ *	VATA Finite Automata Library
+ *
+ *	Copyright (c) 2013	Martin Hruska <xhrusk16@stud.fit.vutbr.cz>
+ *
+ *	Description:
+ *	Header file for immutable set of states stored as a sorted array.
+ *
+ *****************************************************************************/
+
+
+#ifndef UTIL_SORTED_STATE_SET_
+#define UTIL_SORTED_STATE_SET_
+
+// VATA headers
+#include <vata/vata.hh>
+
+// Standard library headers
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+// Boost headers
+#include <boost/functional/hash.hpp>
+
+namespace VATA {
+	template <class State> class SortedStateSet;
+}
+
+/*
+ * Immutable set of states (macrostate) stored as a sorted array without
+ * duplicates. Small sets are stored inside of the object, bigger ones in
+ * a buffer which is shared by copies of the set, so copying takes constant
+ * time. Subset, equality and union are computed by merging of the arrays,
+ * a membership by binary search, and the hash is computed just once when
+ * the set is created.
+ */
+GCC_DIAG_OFF(effc++)
+template <class State>
+class VATA::SortedStateSet {
+GCC_DIAG_ON(effc++)
+public: // data types
+	typedef State value_type;
+	typedef const State* const_iterator;
+	typedef const_iterator iterator;
+
+	static const size_t INLINE_SIZE = 4;
+
+private: // private data members
+	size_t size_;
+	size_t hash_;
+	State inline_[INLINE_SIZE];
+	std::shared_ptr<const std::vector<State>> buffer_;
+
+	// The states have to be sorted and unique
+	void Init(std::vector<State>&& states) {
+		size_ = states.size();
+		hash_ = boost::hash_range(states.begin(), states.end());
+		if (size_ <= INLINE_SIZE) {
+			std::copy(states.begin(), states.end(), inline_);
+		}
+		else {
+			buffer_ = std::make_shared<const std::vector<State>>(std::move(states));
+		}
+	}
+
+public:
+	SortedStateSet() :
+		size_(0),
+		hash_(0),
+		inline_(),
+		buffer_()
+	{
+		Init(std::vector<State>());
+	}
+
+	/*
+	 * Creates set of the given states, they are sorted and duplicities
+	 * are removed
+	 */
+	explicit SortedStateSet(std::vector<State> states) :
+		size_(0),
+		hash_(0),
+		inline_(),
+		buffer_()
+	{
+		std::sort(states.begin(), states.end());
+		states.erase(std::unique(states.begin(), states.end()), states.end());
+		Init(std::move(states));
+	}
+
+	template <class InputIterator>
+	SortedStateSet(InputIterator first, InputIterator last) :
+		SortedStateSet(std::vector<State>(first, last))
+	{}
+
+	const_iterator begin() const {
+		return size_ <= INLINE_SIZE ? inline_ : buffer_->data();
+	}
+
+	const_iterator end() const { return begin() + size_; }
+
+	size_t size() const { return size_; }
+	bool empty() const { return 0 == size_; }
+	size_t GetHash() const { return hash_; }
+
+	size_t count(const State& state) const {
+		return std::binary_search(begin(), end(), state);
+	}
+
+	bool IsSubsetOf(const SortedStateSet& rhs) const {
+		return size_ <= rhs.size_ && std::includes(rhs.begin(), rhs.end(), begin(), end());
+	}
+
+	bool operator==(const SortedStateSet& rhs) const {
+		return size_ == rhs.size_ && hash_ == rhs.hash_ &&
+			std::equal(begin(), end(), rhs.begin());
+	}
+
+	bool operator!=(const SortedStateSet& rhs) const {
+		return !(*this == rhs);
+	}
+
+	static SortedStateSet Union(const SortedStateSet& lhs, const SortedStateSet& rhs) {
+		if (lhs.IsSubsetOf(rhs)) {
+			return rhs;
+		}
+
+		std::vector<State> states;
+		states.reserve(lhs.size_ + rhs.size_);
+		std::set_union(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+			std::back_inserter(states));
+
+		SortedStateSet res;
+		res.Init(std::move(states));
+		return res;
+	}
+};
+
+template <class State>
+const size_t VATA::SortedStateSet<State>::INLINE_SIZE;
+
+#endif
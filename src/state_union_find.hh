@@ -0,0 +1,92 @@
+/*****************************************************************************
+ *	VATA Finite Automata Library
+ *
+ *	Copyright (c) 2013	Martin Hruska <xhrusk16@stud.fit.vutbr.cz>
+ *
+ *	Description:
+ *	Header file for union-find structure over states.
+ *
+ *****************************************************************************/
+
+
+#ifndef UTIL_STATE_UNION_FIND_
+#define UTIL_STATE_UNION_FIND_
+
+// VATA headers
+#include <vata/vata.hh>
+
+// Standard library headers
+#include <utility>
+#include <vector>
+
+namespace VATA {
+	class StateUnionFind;
+}
+
+/*
+ * Union-find over states (dense numbers given by translators), the
+ * structure grows on demand. Smaller classes are merged to the bigger
+ * ones and paths are halved while finding, so operations take almost
+ * constant time.
+ */
+GCC_DIAG_OFF(effc++)
+class VATA::StateUnionFind {
+GCC_DIAG_ON(effc++)
+private:
+	std::vector<size_t> parents_;
+	std::vector<size_t> sizes_; // valid for representatives only
+
+	void Reserve(size_t element) {
+		if (element < parents_.size()) {
+			return;
+		}
+
+		const size_t oldSize = parents_.size();
+		parents_.resize(element + 1);
+		sizes_.resize(element + 1, 1);
+		for (size_t i = oldSize; i <= element; ++i) {
+			parents_[i] = i;
+		}
+	}
+
+public:
+	StateUnionFind() :
+		parents_(),
+		sizes_()
+	{}
+
+	/*
+	 * Returns representative of the class of the element
+	 */
+	size_t Find(size_t element) {
+		Reserve(element);
+		while (parents_[element] != element) {
+			parents_[element] = parents_[parents_[element]];
+			element = parents_[element];
+		}
+
+		return element;
+	}
+
+	/*
+	 * Merges classes of the both elements
+	 * @return false when the elements are already in the same class
+	 */
+	bool Union(size_t lhs, size_t rhs) {
+		lhs = Find(lhs);
+		rhs = Find(rhs);
+		if (lhs == rhs) {
+			return false;
+		}
+
+		if (sizes_[lhs] < sizes_[rhs]) {
+			std::swap(lhs, rhs);
+		}
+		parents_[rhs] = lhs;
+		sizes_[lhs] += sizes_[rhs];
+
+		return true;
+	}
+};
+
+#endif
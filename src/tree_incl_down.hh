@@ -12,8 +12,12 @@
 #ifndef _VATA_TREE_INCL_DOWN_HH_
 #define _VATA_TREE_INCL_DOWN_HH_
 
+// Standard library headers
+#include <algorithm>
+
 // VATA headers
 #include <vata/vata.hh>
+#include <vata/incl_param.hh>
 
 namespace VATA
 {
@@ -24,7 +28,8 @@ namespace VATA
 		class Rel
 	>
 	bool CheckDownwardTreeInclusion(const Aut& smaller, const Aut& bigger,
-		const Rel& preorder);
+		const Rel& preorder, size_t cacheMemory = 0,
+		CacheStatistics* cacheStatistics = nullptr);
 }
 
 /**
@@ -33,6 +38,12 @@ namespace VATA
  * This is a general method for tree automata to check language inclusion
  * downward.
  *
+ * Half of the memory budget @p cacheMemory (in bytes, 0 means unlimited) is
+ * given to the cache of comparisons of macrostates, the other half bounds the
+ * memory of macrostates kept alive only by antichains of the functor; their
+ * entries are evicted when the bound is exceeded (see Util::MacrostateBudget).
+ * Counters of the caches are stored into @p cacheStatistics (if given).
+ *
  * @todo  Write this documentation
  */
 template
@@ -42,9 +53,11 @@ template
 	class Rel
 >
 bool VATA::CheckDownwardTreeInclusion(
-	const Aut&     smaller,
-	const Aut&     bigger,
-	const Rel&     preorder)
+	const Aut&           smaller,
+	const Aut&           bigger,
+	const Rel&           preorder,
+	size_t               cacheMemory,
+	CacheStatistics*     cacheStatistics)
 {
 	typedef DownwardInclFctor<Aut, Rel> InclFctor;
 
@@ -56,6 +69,14 @@ bool VATA::CheckDownwardTreeInclusion(
 
 	typename InclFctor::LteCache lteCache;
 
+	if (cacheMemory)
+	{
+		lteCache.setCapacity(std::max<size_t>(1,
+			cacheMemory / 2 / InclFctor::LteCache::ENTRY_MEMORY));
+	}
+
+	CacheStatistics stats;
+
 	typename InclFctor::BiggerTypeCache biggerTypeCache(
 			[&lteCache](const StateSet* v) {
 				lteCache.invalidateFirst(v);
@@ -78,13 +99,18 @@ bool VATA::CheckDownwardTreeInclusion(
 	typename InclFctor::InclAntichainType antecedent;
 	typename InclFctor::ConsequentType consequent;
 
+	typename InclFctor::MacrostateBudget budget(biggerTypeCache,
+		cacheMemory ? std::max<size_t>(1, cacheMemory / 2) : 0);
+
 	InclFctor downFctor(smaller, bigger, biggerTypeCache, workset, incl, nonIncl,
 		preorder, preorderSmaller, preorderBigger, compSmaller, compBigger,
-		antecedent, consequent);
+		antecedent, consequent, budget, stats);
 
 	StateSet finalStatesBigger(bigger.GetFinalStates().begin(),
 		bigger.GetFinalStates().end());
 
+	bool result = true;
+
 	for (const StateType& smSt : smaller.GetFinalStates())
 	{	// for each final state of the smaller automaton
 		if (downFctor.IsImpliedByPreorder(
@@ -99,12 +125,27 @@ bool VATA::CheckDownwardTreeInclusion(
 
 		if (!downFctor.InclusionHolds())
 		{	// in case inclusion does not hold for some LHS state
-			return false;
+			result = false;
+			break;
 		}
 	}
 
-	// inclusion holds for all LHS states
-	return true;
+	if (nullptr != cacheStatistics)
+	{
+		stats.lte.hits = lteCache.hits();
+		stats.lte.misses = lteCache.misses();
+		stats.lte.evictions = lteCache.evictions();
+
+		stats.macrostates.hits = biggerTypeCache.hits();
+		stats.macrostates.misses = biggerTypeCache.misses();
+		stats.macrostates.evictions = budget.evictedMacrostates();
+
+		stats.antichains.evictions = budget.evictedEntries();
+
+		*cacheStatistics = stats;
+	}
+
+	return result;
 }
 
 #endif
@@ -33,7 +33,9 @@ namespace VATA { namespace Util {
  * This class serves as a cache for objects of the type @p T. It maps an object
  * of type @p T on a unique shared pointer. The cache also performs memory
  * management---in the case there is no shared pointer pointing on the object,
- * it is released. A custom @p Deleter function may be provided.
+ * it is released. A custom @p Deleter function may be provided. The cache
+ * counts hits and misses of lookups and the approximate memory taken by the
+ * objects (which are expected to be containers).
  */
 template <
 	class T,
@@ -51,6 +53,10 @@ protected:// data members
 	TToWeakTPtrMap store_;
 	Deleter deleter_;
 
+	size_t hits_;
+	size_t misses_;
+	size_t memory_;
+
 	struct DeleteElementF
 	{
 		Cache& cache_;
@@ -63,21 +69,40 @@ protected:// data members
 		void operator()(const T* v)
 		{
 			cache_.deleter_(v);
+			cache_.memory_ -= elementMemory(*v);
 			cache_.store_.erase(*v);
 		}
 	};
 
 public:   // methods
 
+	/**
+	 * @brief  Approximate memory taken by a cached object in bytes
+	 */
+	static size_t elementMemory(
+		const T&                  x)
+	{
+		// the node of the store with a bucket, the control block of the shared
+		// pointer and the content of the container
+		return sizeof(typename TToWeakTPtrMap::value_type) + 8 * sizeof(void*) +
+			x.size() * sizeof(*x.begin());
+	}
+
 	Cache() :
 		store_(),
-		deleter_([](const T*) {})
+		deleter_([](const T*) {}),
+		hits_(0),
+		misses_(0),
+		memory_(0)
 	{ }
 
 	explicit Cache(
 		const Deleter&            deleter) :
 		store_(),
-		deleter_(deleter)
+		deleter_(deleter),
+		hits_(0),
+		misses_(0),
+		memory_(0)
 	{ }
 
 	~Cache()
@@ -100,9 +125,13 @@ public:   // methods
 
 		if (!p.second)
 		{
+			++hits_;
 			return TPtr(p.first->second);
 		}
 
+		++misses_;
+		memory_ += elementMemory(p.first->first);
+
 		auto ptr = TPtr(const_cast<T*>(&p.first->first), DeleteElementF(*this));
 
 		p.first->second = WeakTPtr(ptr);
@@ -115,6 +144,29 @@ public:   // methods
 	{
 		return store_.empty();
 	}
+
+	size_t size() const
+	{
+		return store_.size();
+	}
+
+	size_t hits() const
+	{
+		return hits_;
+	}
+
+	size_t misses() const
+	{
+		return misses_;
+	}
+
+	/**
+	 * @brief  Approximate memory taken by the cached objects in bytes
+	 */
+	size_t memory() const
+	{
+		return memory_;
+	}
 };
 
 
@@ -15,6 +15,7 @@
 // Standard library headers
 #include <unordered_map>
 #include <set>
+#include <vector>
 
 
 // Boost headers
@@ -27,6 +28,17 @@ namespace VATA { namespace Util {
 }}
 
 
+/**
+ * @brief  A cache for results of a binary operation
+ *
+ * The cache stores results of a binary operation on pairs of arguments and
+ * allows to invalidate all results for a given first or second argument. The
+ * number of stored results may be bounded, in which case results are evicted
+ * using the generalised CLOCK policy: every result gets a credit given by the
+ * (logarithm of the) cost of its computation, the hand of the clock takes one
+ * credit from every result it passes and evicts the first result without any
+ * credit. Hits restore the credit, so cheap or rarely used results go first.
+ */
 template <
 	class T1,
 	class T2,
@@ -35,27 +47,170 @@ class VATA::Util::CachedBinaryOp
 {
 public:
 
+	struct Entry
+	{
+		V value;
+		size_t credit;
+		size_t slot;      // position in the clock
+	};
+
 	typedef std::pair<T1, T2> Key;
-	typedef std::unordered_map<Key, V, boost::hash<Key>> KeyToVMap;
+	typedef std::unordered_map<Key, Entry, boost::hash<Key>> KeyToVMap;
 	typedef std::set<typename KeyToVMap::value_type*> KeyToVMapValueTypeSet;
 	typedef std::unordered_map<T1, KeyToVMapValueTypeSet, boost::hash<T1>> T1ToKeyToVMapValueTypeSetMap;
 	typedef std::unordered_map<T2, KeyToVMapValueTypeSet, boost::hash<T2>> T2ToKeyToVMapValueTypeSetMap;
 
+	/**
+	 * @brief  Approximate memory taken by one result
+	 *
+	 * Counts the node of the store (with a bucket), nodes of both sets of the
+	 * reverse indices and the slot in the clock.
+	 */
+	static const size_t ENTRY_MEMORY =
+		sizeof(typename KeyToVMap::value_type) + 14 * sizeof(void*);
+
 protected:
 
 	KeyToVMap store_;
 	T1ToKeyToVMapValueTypeSetMap storeMap1_;
 	T2ToKeyToVMapValueTypeSetMap storeMap2_;
 
+	std::vector<typename KeyToVMap::value_type*> clock_;
+	size_t hand_;
+
+	size_t capacity_;
+
+	size_t hits_;
+	size_t misses_;
+	size_t evictions_;
+
+	static size_t credit(size_t cost)
+	{
+		size_t res = 1;
+
+		while (cost >>= 1)
+		{
+			++res;
+		}
+
+		return res;
+	}
+
+	void removeFromClock(typename KeyToVMap::value_type* item)
+	{
+		const size_t slot = item->second.slot;
+
+		assert(slot < clock_.size());
+		assert(clock_[slot] == item);
+
+		clock_[slot] = clock_.back();
+		clock_[slot]->second.slot = slot;
+		clock_.pop_back();
+	}
+
+	template <class T, class Map>
+	static void removeFromMap(Map& storeMap, const T& x,
+		typename KeyToVMap::value_type* item)
+	{
+		auto i = storeMap.find(x);
+
+		assert(i != storeMap.end());
+
+		i->second.erase(item);
+
+		if (i->second.empty())
+		{
+			storeMap.erase(i);
+		}
+	}
+
+	void evict()
+	{
+		assert(!clock_.empty());
+
+		while (true)
+		{
+			if (hand_ >= clock_.size())
+			{
+				hand_ = 0;
+			}
+
+			auto item = clock_[hand_];
+
+			if (0 == item->second.credit)
+			{
+				break;
+			}
+
+			--item->second.credit;
+			++hand_;
+		}
+
+		auto item = clock_[hand_];
+		const Key key = item->first;
+
+		removeFromMap(storeMap1_, key.first, item);
+		removeFromMap(storeMap2_, key.second, item);
+		removeFromClock(item);
+		store_.erase(key);
+
+		++evictions_;
+	}
+
 public:
 
-	CachedBinaryOp() : store_(), storeMap1_(), storeMap2_() {}
+	CachedBinaryOp() :
+		store_(),
+		storeMap1_(),
+		storeMap2_(),
+		clock_(),
+		hand_(0),
+		capacity_(0),
+		hits_(0),
+		misses_(0),
+		evictions_(0)
+	{ }
 
 	void clear()
 	{
 		storeMap1_.clear();
 		storeMap2_.clear();
 		store_.clear();
+		clock_.clear();
+		hand_ = 0;
+	}
+
+	/**
+	 * @brief  Bounds the number of stored results (0 ... unbounded)
+	 */
+	void setCapacity(size_t capacity)
+	{
+		capacity_ = capacity;
+
+		while (capacity_ && (store_.size() > capacity_))
+		{
+			this->evict();
+		}
+	}
+
+	size_t size() const
+	{
+		return store_.size();
+	}
+
+	size_t hits() const
+	{
+		return hits_;
+	}
+
+	size_t misses() const
+	{
+		return misses_;
+	}
+
+	size_t evictions() const
+	{
+		return evictions_;
 	}
 
 	void invalidateFirst(const T1& x)
@@ -69,12 +224,11 @@ public:
 
 		for (auto& item : i->second)
 		{
-			auto j = storeMap2_.find(item->first.second);
+			const Key key = item->first;
 
-			assert(j != storeMap2_.end());
-
-			j->second.erase(item);
-			store_.erase(item->first);
+			removeFromMap(storeMap2_, key.second, item);
+			removeFromClock(item);
+			store_.erase(key);
 		}
 
 		storeMap1_.erase(i);
@@ -91,37 +245,67 @@ public:
 
 		for (auto& item : i->second)
 		{
-			auto j = storeMap1_.find(item->first.first);
-
-			assert(j != storeMap1_.end());
+			const Key key = item->first;
 
-			j->second.erase(item);
-			store_.erase(item->first);
+			removeFromMap(storeMap1_, key.first, item);
+			removeFromClock(item);
+			store_.erase(key);
 		}
 
 		storeMap2_.erase(i);
 	}
 
+	/**
+	 * @brief  Returns the result of @p f on @p x and @p y
+	 *
+	 * The result is computed only if it is not in the cache. The @p cost of
+	 * the computation is used for the eviction.
+	 */
 	template <class F>
-	V lookup(const T1& x, const T2& y, F f)
+	V lookup(const T1& x, const T2& y, F f, size_t cost = 1)
 	{
-		auto p = store_.insert(std::make_pair(std::make_pair(x, y), V()));
+		Key key = std::make_pair(x, y);
 
-		if (p.second)
+		auto i = store_.find(key);
+
+		if (i != store_.end())
 		{
-			p.first->second = f(x, y);
+			++hits_;
+			i->second.credit = credit(cost);
+
+			return i->second.value;
+		}
+
+		++misses_;
 
-			storeMap1_.insert(
-				std::make_pair(x, KeyToVMapValueTypeSet())
-			).first->second.insert(&*p.first);
+		V value = f(x, y);
 
-			storeMap2_.insert(
-				std::make_pair(y, KeyToVMapValueTypeSet())
-			).first->second.insert(&*p.first);
+		if (capacity_ && (store_.size() >= capacity_))
+		{
+			this->evict();
 		}
 
-		return p.first->second;
+		Entry entry = {value, credit(cost), clock_.size()};
+
+		auto p = store_.insert(std::make_pair(key, entry));
+
+		assert(p.second);
+
+		clock_.push_back(&*p.first);
+
+		storeMap1_.insert(
+			std::make_pair(x, KeyToVMapValueTypeSet())
+		).first->second.insert(&*p.first);
+
+		storeMap2_.insert(
+			std::make_pair(y, KeyToVMapValueTypeSet())
+		).first->second.insert(&*p.first);
+
+		return value;
 	}
 };
 
+template <class T1, class T2, class V>
+const size_t VATA::Util::CachedBinaryOp<T1, T2, V>::ENTRY_MEMORY;
+
 #endif
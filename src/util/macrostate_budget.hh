@@ -0,0 +1,192 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Description:
+ *    Memory budget of macrostates kept alive by antichains.
+ *
+ *****************************************************************************/
+
+#ifndef _VATA_MACROSTATE_BUDGET_HH_
+#define _VATA_MACROSTATE_BUDGET_HH_
+
+// standard library headers
+#include <algorithm>
+#include <initializer_list>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// insert class to proper namespace
+namespace VATA { namespace Util {
+	template <class Cache> class MacrostateBudget;
+}}
+
+
+/**
+ * @brief  A memory budget of macrostates kept alive by antichains
+ *
+ * Macrostates of a Util::Cache are released when nothing points to them.
+ * Besides the antichains of known answers, they are pointed to by the
+ * workset and the stack of the inclusion checking, which cannot be freed.
+ * Only macrostates pointed to by the antichains alone are counted against the
+ * budget. When they exceed it, entries of the antichains are evicted until
+ * the freeable memory drops to half of the budget. The macrostates with the
+ * most memory per entry go first, so the fewest answers are lost.
+ *
+ * Counting the freeable memory visits all entries of the antichains, so it
+ * is done again only after the cache grows enough for the freeable memory to
+ * exceed the budget again.
+ */
+template <class Cache>
+class VATA::Util::MacrostateBudget
+{
+public:   // data types
+
+	using TPtr = typename Cache::TPtr;
+
+private:  // data types
+
+	using T = typename TPtr::element_type;
+
+	// entries of the antichains and all owners of a macrostate
+	struct Refs
+	{
+		size_t entries;
+		long owners;
+
+		Refs() :
+			entries(0),
+			owners(0)
+		{ }
+	};
+
+private:  // data members
+
+	const Cache& cache_;
+
+	// 0 means unlimited
+	size_t budget_;
+
+	// memory of the cache at which the freeable memory is counted again
+	size_t nextCheck_;
+
+	size_t evictedEntries_;
+	size_t evictedMacrostates_;
+
+public:   // methods
+
+	MacrostateBudget(
+		const Cache&              cache,
+		size_t                    budget) :
+		cache_(cache),
+		budget_(budget),
+		nextCheck_(budget),
+		evictedEntries_(0),
+		evictedMacrostates_(0)
+	{ }
+
+	/**
+	 * @brief  Evicts entries of antichains when the budget is exceeded
+	 *
+	 * @param[in, out]  antichains  The antichains with answers that can be
+	 *                              dropped (pairs of a state and a pointer
+	 *                              to a macrostate)
+	 *
+	 * @returns  The number of evicted entries
+	 */
+	template <class Antichain>
+	size_t enforce(
+		std::initializer_list<Antichain*>      antichains)
+	{
+		if (!budget_ || (cache_.memory() <= nextCheck_))
+		{
+			return 0;
+		}
+
+		std::unordered_map<const T*, Refs> refs;
+		for (Antichain* antichain : antichains)
+		{
+			for (const auto& keyListPair : antichain->data())
+			{
+				for (const TPtr& ptr : keyListPair.second)
+				{
+					Refs& ref = refs[ptr.get()];
+					++ref.entries;
+					ref.owners = ptr.use_count();
+				}
+			}
+		}
+
+		// macrostates with all owners in the antichains, by memory per entry
+		std::vector<std::pair<size_t, const T*>> candidates;
+		size_t freeable = 0;
+		for (const auto& ptrRefsPair : refs)
+		{
+			if (static_cast<long>(ptrRefsPair.second.entries) != ptrRefsPair.second.owners)
+			{
+				continue;
+			}
+
+			const size_t memory = Cache::elementMemory(*ptrRefsPair.first);
+			freeable += memory;
+			candidates.push_back(
+				std::make_pair(memory / ptrRefsPair.second.entries, ptrRefsPair.first));
+		}
+
+		std::unordered_set<const T*> evicted;
+		if (freeable > budget_)
+		{
+			std::sort(candidates.begin(), candidates.end(),
+				[](const std::pair<size_t, const T*>& lhs,
+					const std::pair<size_t, const T*>& rhs)
+				{
+					return lhs.first > rhs.first;
+				});
+
+			for (const auto& candidate : candidates)
+			{
+				if (freeable <= budget_ / 2)
+				{
+					break;
+				}
+
+				freeable -= Cache::elementMemory(*candidate.second);
+				evicted.insert(candidate.second);
+			}
+		}
+
+		size_t removed = 0;
+		if (!evicted.empty())
+		{
+			for (Antichain* antichain : antichains)
+			{
+				removed += antichain->removeIf(
+					[&evicted](const typename Antichain::first_type&, const TPtr& ptr)
+					{
+						return evicted.count(ptr.get()) > 0;
+					});
+			}
+		}
+
+		evictedEntries_ += removed;
+		evictedMacrostates_ += evicted.size();
+
+		// the evicted macrostates are released by now
+		nextCheck_ = cache_.memory() + budget_ - freeable;
+
+		return removed;
+	}
+
+	size_t evictedEntries() const
+	{
+		return evictedEntries_;
+	}
+
+	size_t evictedMacrostates() const
+	{
+		return evictedMacrostates_;
+	}
+};
+
+
+#endif
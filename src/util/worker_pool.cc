@@ -0,0 +1,167 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Ondrej Vales <xvales03@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Worker pool.
+ *
+ *****************************************************************************/
+
+#include "worker_pool.hh"
+
+// Standard library headers
+#include <algorithm>
+
+using VATA::Util::WorkerPool;
+
+WorkerPool::WorkerPool(size_t workers) :
+	threads_(),
+	queues_(),
+	lock_(),
+	started_(),
+	finished_(),
+	task_(nullptr),
+	round_(0),
+	running_(0),
+	quit_(false),
+	error_()
+{
+	for (size_t worker = 0; worker < std::max<size_t>(workers, 1); ++worker)
+	{
+		this->queues_.emplace_back(new Queue());
+	}
+
+	for (size_t worker = 1; worker < this->queues_.size(); ++worker)
+	{
+		this->threads_.emplace_back(&WorkerPool::loop, this, worker);
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> guard(this->lock_);
+		this->quit_ = true;
+	}
+
+	this->started_.notify_all();
+	for (auto& thread : this->threads_)
+	{
+		thread.join();
+	}
+}
+
+// the calling thread works as worker 0
+void WorkerPool::run(size_t tasks, const Task& task)
+{
+	// contiguous blocks of tasks, so neighbouring tasks stay with one worker
+	const size_t workers = this->queues_.size();
+	for (size_t worker = 0; worker < workers; ++worker)
+	{
+		std::lock_guard<std::mutex> guard(this->queues_[worker]->lock);
+		for (size_t index = worker * tasks / workers;
+			index < (worker + 1) * tasks / workers; ++index)
+		{
+			this->queues_[worker]->tasks.push_back(index);
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> guard(this->lock_);
+		this->task_ = &task;
+		this->running_ = this->threads_.size();
+		this->error_ = nullptr;
+		++this->round_;
+	}
+
+	this->started_.notify_all();
+
+	this->work(0);
+
+	std::unique_lock<std::mutex> guard(this->lock_);
+	this->finished_.wait(guard, [this]{ return 0 == this->running_; });
+	this->task_ = nullptr;
+	if (this->error_)
+	{
+		std::rethrow_exception(this->error_);
+	}
+}
+
+// takes a task from the front of the own deque or steals one from the back
+// of another deque
+bool WorkerPool::next(size_t worker, size_t& index)
+{
+	{
+		Queue& own = *this->queues_[worker];
+		std::lock_guard<std::mutex> guard(own.lock);
+		if (!own.tasks.empty())
+		{
+			index = own.tasks.front();
+			own.tasks.pop_front();
+			return true;
+		}
+	}
+
+	for (size_t offset = 1; offset < this->queues_.size(); ++offset)
+	{
+		Queue& victim = *this->queues_[(worker + offset) % this->queues_.size()];
+		std::lock_guard<std::mutex> guard(victim.lock);
+		if (!victim.tasks.empty())
+		{
+			index = victim.tasks.back();
+			victim.tasks.pop_back();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// runs tasks until all deques are empty
+void WorkerPool::work(size_t worker)
+{
+	size_t index;
+	while (this->next(worker, index))
+	{
+		try
+		{
+			(*this->task_)(worker, index);
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> guard(this->lock_);
+			if (!this->error_)
+			{
+				this->error_ = std::current_exception();
+			}
+		}
+	}
+}
+
+// waits for rounds and works on them
+void WorkerPool::loop(size_t worker)
+{
+	size_t seen = 0;
+	std::unique_lock<std::mutex> guard(this->lock_);
+	while (true)
+	{
+		this->started_.wait(guard,
+			[this, seen]{ return this->quit_ || this->round_ != seen; });
+		if (this->quit_)
+		{
+			return;
+		}
+
+		seen = this->round_;
+
+		guard.unlock();
+		this->work(worker);
+		guard.lock();
+
+		if (0 == --this->running_)
+		{
+			this->finished_.notify_one();
+		}
+	}
+}
@@ -0,0 +1,98 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Ondrej Vales <xvales03@fit.vutbr.cz>
+ *
+ *  Description:
+ *    Worker pool header file.
+ *
+ *****************************************************************************/
+
+#ifndef _VATA_WORKER_POOL_HH_
+#define _VATA_WORKER_POOL_HH_
+
+// VATA headers
+#include <vata/vata.hh>
+
+// Standard library headers
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// insert class to proper namespace
+namespace VATA {
+	namespace Util {
+		class WorkerPool;
+	}
+}
+
+/**
+ * @brief  A pool of worker threads running rounds of independent tasks
+ *
+ * Tasks of a round are split into contiguous blocks, one work-stealing deque
+ * per worker. A worker takes tasks from the front of its own deque and when
+ * it runs out of them it steals from the back of deques of other workers.
+ * The calling thread works as worker 0 and @p run returns when all tasks of
+ * the round are finished (an exception of a task is rethrown there).
+ */
+GCC_DIAG_OFF(effc++)
+class VATA::Util::WorkerPool {
+GCC_DIAG_ON(effc++)
+
+public:
+
+	// runs the task (worker, task index)
+	typedef std::function<void(size_t, size_t)> Task;
+
+private:
+
+	// deque of a worker
+	struct Queue {
+
+		std::mutex lock;
+		std::deque<size_t> tasks;
+
+		Queue() : lock(), tasks() {}
+
+	};
+
+	std::vector<std::thread> threads_;            // workers except the calling thread
+	std::vector<std::unique_ptr<Queue>> queues_;  // tasks of workers
+	std::mutex lock_;                             // guards the round state below
+	std::condition_variable started_;
+	std::condition_variable finished_;
+	const Task* task_;                            // task of the current round
+	size_t round_;                                // number of started rounds
+	size_t running_;                              // workers still running the round
+	bool quit_;                                   // workers should exit
+	std::exception_ptr error_;                    // first exception of the round
+
+	bool next(size_t worker, size_t& index);
+	void work(size_t worker);
+	void loop(size_t worker);
+
+public:
+
+	explicit WorkerPool(size_t workers);
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	size_t size() const {
+
+		return this->queues_.size();
+
+	}
+
+	// runs tasks 0 .. tasks-1 and waits for them
+	void run(size_t tasks, const Task& task);
+
+};
+
+#endif
@@ -0,0 +1,325 @@
+/*****************************************************************************
+ *  VATA Tree Automata Library
+ *
+ *  Description:
+ *    Test suite for the binary relation
+ *
+ *****************************************************************************/
+
+// VATA headers
+#include <vata/vata.hh>
+#include <vata/util/binary_relation.hh>
+#include <vata/util/convert.hh>
+
+using VATA::Util::BinaryRelation;
+using VATA::Util::Convert;
+
+// Standard library headers
+#include <algorithm>
+#include <random>
+
+// Boost headers
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE BinaryRelation
+#include <boost/test/unit_test.hpp>
+
+// testing headers
+#include "log_fixture.hh"
+
+
+/******************************************************************************
+ *                                  Constants                                 *
+ ******************************************************************************/
+
+// sizes around the boundaries of words (64 bits) and rows (512 bits)
+const std::vector<size_t> SIZES = {1, 2, 63, 64, 65, 127, 130, 511, 513};
+
+// random relations generated for each size and density
+const size_t RELATIONS = 3;
+
+
+/******************************************************************************
+ *                                  Fixtures                                  *
+ ******************************************************************************/
+
+/**
+ * @brief  BinaryRelation testing fixture
+ *
+ * Compares BinaryRelation with a bit-by-bit reference on random relations.
+ */
+class BinaryRelationFixture : public LogFixture
+{
+protected:// data types
+
+	typedef std::vector<std::vector<bool>> RefRelation;
+
+protected:// data members
+
+	std::mt19937 generator_;
+
+protected:// methods
+
+	BinaryRelationFixture() :
+		generator_(42)
+	{ }
+
+	bool randomBool(double density)
+	{
+		return std::bernoulli_distribution(density)(generator_);
+	}
+
+	size_t randomIndex(size_t size)
+	{
+		return std::uniform_int_distribution<size_t>(0, size - 1)(generator_);
+	}
+
+	/**
+	 * @brief  Fills a random relation and its reference
+	 *
+	 * The relation starts with a small number of allocated rows, so that it
+	 * grows while being resized.
+	 */
+	void randomRelation(
+		size_t             size,
+		double             density,
+		BinaryRelation&    rel,
+		RefRelation&       ref)
+	{
+		rel = BinaryRelation(0, false, 1);
+		rel.resize(size);
+		ref.assign(size, std::vector<bool>(size, false));
+
+		for (size_t i = 0; i < size; ++i)
+		{
+			for (size_t j = 0; j < size; ++j)
+			{
+				ref[i][j] = this->randomBool(density);
+				rel.set(i, j, ref[i][j]);
+			}
+		}
+	}
+
+	void checkRelation(
+		const BinaryRelation&    rel,
+		const RefRelation&       ref,
+		const std::string&       desc)
+	{
+		BOOST_REQUIRE_MESSAGE(rel.size() == ref.size(),
+			desc + ": expected size " + Convert::ToString(ref.size()) +
+			", got " + Convert::ToString(rel.size()));
+
+		for (size_t i = 0; i < ref.size(); ++i)
+		{
+			for (size_t j = 0; j < ref.size(); ++j)
+			{
+				if (rel.get(i, j) != ref[i][j])
+				{
+					BOOST_ERROR(desc + ": wrong pair (" + Convert::ToString(i) + ", " +
+						Convert::ToString(j) + "), expected " +
+						Convert::ToString(ref[i][j]));
+					return;
+				}
+			}
+		}
+
+		// the rows are enumerated word by word
+		BinaryRelation::IndexType index;
+		rel.buildIndex(index);
+		for (size_t i = 0; i < ref.size(); ++i)
+		{
+			std::vector<size_t> images;
+			for (size_t j = 0; j < ref.size(); ++j)
+			{
+				if (ref[i][j])
+				{
+					images.push_back(j);
+				}
+			}
+
+			BOOST_REQUIRE_MESSAGE(index[i] == images,
+				desc + ": wrong images of " + Convert::ToString(i));
+		}
+	}
+
+	/**
+	 * @brief  Runs @p test on random relations of all sizes and densities
+	 */
+	template <class Test>
+	void forRandomRelations(Test test)
+	{
+		for (size_t size : SIZES)
+		{
+			for (double density : {0.05, 0.5, 0.95})
+			{
+				for (size_t relation = 0; relation < RELATIONS; ++relation)
+				{
+					BinaryRelation rel;
+					RefRelation ref;
+					this->randomRelation(size, density, rel, ref);
+
+					test(rel, ref, "size " + Convert::ToString(size) + ", density " +
+						Convert::ToString(density));
+				}
+			}
+		}
+	}
+};
+
+
+/******************************************************************************
+ *                              Start of testing                              *
+ ******************************************************************************/
+
+
+BOOST_FIXTURE_TEST_SUITE(suite, BinaryRelationFixture)
+
+BOOST_AUTO_TEST_CASE(storage)
+{
+	forRandomRelations([this](BinaryRelation& rel, RefRelation& ref,
+		const std::string& desc)
+	{
+		checkRelation(rel, ref, desc);
+
+		// overwrite random pairs
+		for (size_t k = 0; k < ref.size(); ++k)
+		{
+			size_t i = randomIndex(ref.size());
+			size_t j = randomIndex(ref.size());
+			bool val = randomBool(0.5);
+
+			ref[i][j] = val;
+			rel.set(i, j, val);
+		}
+
+		checkRelation(rel, ref, desc + ", overwritten");
+
+		for (bool val : {false, true})
+		{
+			rel.reset(val);
+			for (auto& row : ref)
+			{
+				std::fill(row.begin(), row.end(), val);
+			}
+
+			checkRelation(rel, ref, desc + ", reset to " + Convert::ToString(val));
+		}
+	});
+}
+
+BOOST_AUTO_TEST_CASE(transposed)
+{
+	forRandomRelations([this](BinaryRelation& rel, RefRelation& ref,
+		const std::string& desc)
+	{
+		RefRelation refTransposed(ref.size(), std::vector<bool>(ref.size()));
+		for (size_t i = 0; i < ref.size(); ++i)
+		{
+			for (size_t j = 0; j < ref.size(); ++j)
+			{
+				refTransposed[j][i] = ref[i][j];
+			}
+		}
+
+		// the destination holds a bigger relation before
+		BinaryRelation dst(ref.size() + 70, true);
+		checkRelation(rel.transposed(dst), refTransposed, desc + ", transposed");
+	});
+}
+
+BOOST_AUTO_TEST_CASE(restricted)
+{
+	forRandomRelations([this](BinaryRelation& rel, RefRelation& ref,
+		const std::string& desc)
+	{
+		// random distinct elements in a random order
+		std::vector<size_t> elems;
+		for (size_t i = 0; i < ref.size(); ++i)
+		{
+			if (randomBool(0.7))
+			{
+				elems.push_back(i);
+			}
+		}
+
+		std::shuffle(elems.begin(), elems.end(), generator_);
+
+		RefRelation refRestricted(elems.size(), std::vector<bool>(elems.size()));
+		for (size_t i = 0; i < elems.size(); ++i)
+		{
+			for (size_t j = 0; j < elems.size(); ++j)
+			{
+				refRestricted[i][j] = ref[elems[i]][elems[j]];
+			}
+		}
+
+		BinaryRelation dst(ref.size(), true);
+		checkRelation(rel.restricted(elems, dst), refRestricted,
+			desc + ", restricted to " + Convert::ToString(elems.size()));
+	});
+}
+
+BOOST_AUTO_TEST_CASE(resize)
+{
+	forRandomRelations([this](BinaryRelation& rel, RefRelation& ref,
+		const std::string& desc)
+	{
+		for (size_t k = 0; k < 4; ++k)
+		{
+			size_t size = randomIndex(2 * ref.size() + 2);
+			bool defVal = randomBool(0.5);
+
+			for (auto& row : ref)
+			{
+				row.resize(size, defVal);
+			}
+
+			ref.resize(size, std::vector<bool>(size, defVal));
+			rel.resize(size, defVal);
+
+			checkRelation(rel, ref, desc + ", resized to " +
+				Convert::ToString(size) + " with " + Convert::ToString(defVal));
+		}
+
+		// new elements are not related
+		size_t elem = rel.alloc();
+		BOOST_REQUIRE(elem == ref.size());
+		for (auto& row : ref)
+		{
+			row.push_back(false);
+		}
+
+		ref.push_back(std::vector<bool>(ref.size() + 1, false));
+
+		checkRelation(rel, ref, desc + ", allocated");
+	});
+}
+
+BOOST_AUTO_TEST_CASE(split)
+{
+	forRandomRelations([this](BinaryRelation& rel, RefRelation& ref,
+		const std::string& desc)
+	{
+		// enough splits to cross a boundary of words
+		for (size_t k = 0; k < 70; ++k)
+		{
+			size_t i = randomIndex(ref.size());
+			bool reflexive = randomBool(0.5);
+
+			// the new element has the images and co-images of i
+			const size_t elem = ref.size();
+			for (auto& row : ref)
+			{
+				row.push_back(row[i]);
+			}
+
+			ref.push_back(ref[i]);
+			ref[elem][elem] = reflexive;
+
+			BOOST_REQUIRE(rel.split(i, reflexive) == elem);
+		}
+
+		checkRelation(rel, ref, desc + ", split");
+	});
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,790 @@
+/*****************************************************************************
+ *  VATA Finite Automata Library
+ *
+ *  Copyright (c) 2013  Martin Hruska <xhrusk16@stud.fit.vutbr.cz>
+ *
+ *  Description:
+ *    Test suite for explicit finite automaton
+ *
+ *****************************************************************************/
+
+// VATA headers
+#include <vata/vata.hh>
+#include <vata/explicit_finite_aut.hh>
+#include <vata/parsing/timbuk_parser.hh>
+#include <vata/util/convert.hh>
+#include <vata/util/util.hh>
+
+using VATA::AutBase;
+using VATA::EqParam;
+using VATA::ExplicitFiniteAut;
+using VATA::InclParam;
+using VATA::Parsing::TimbukParser;
+using VATA::SimParam;
+using VATA::Util::Convert;
+
+// Boost headers
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE ExplicitFiniteAut
+#include <boost/test/unit_test.hpp>
+
+// testing headers
+#include "log_fixture.hh"
+
+
+/******************************************************************************
+ *                                  Constants                                 *
+ ******************************************************************************/
+
+const fs::path FA_INCLUSION_TIMBUK_FILE =
+	AUT_DIR / "fa_inclusion_timbuk.txt";
+
+const fs::path FA_EQUIVALENCE_TIMBUK_FILE =
+	AUT_DIR / "fa_equivalence_timbuk.txt";
+
+// even number of a's
+const std::string DET_EVEN_A =
+	"Ops a:1 b:1 x:0\n"
+	"Automaton DET_EVEN_A\n"
+	"States p0 p1\n"
+	"Final States p0\n"
+	"Transitions\n"
+	"x -> p0\n"
+	"a(p0) -> p1\n"
+	"b(p0) -> p0\n"
+	"a(p1) -> p0\n"
+	"b(p1) -> p1\n"
+	;
+
+// even number of a's, the states of DET_EVEN_A are doubled
+const std::string DET_EVEN_A_BIG =
+	"Ops a:1 b:1 x:0\n"
+	"Automaton DET_EVEN_A_BIG\n"
+	"States r0 r1 r2 r3\n"
+	"Final States r0 r2\n"
+	"Transitions\n"
+	"x -> r0\n"
+	"a(r0) -> r1\n"
+	"b(r0) -> r2\n"
+	"a(r1) -> r2\n"
+	"b(r1) -> r3\n"
+	"a(r2) -> r3\n"
+	"b(r2) -> r0\n"
+	"a(r3) -> r0\n"
+	"b(r3) -> r1\n"
+	;
+
+// even number of b's
+const std::string DET_EVEN_B =
+	"Ops a:1 b:1 x:0\n"
+	"Automaton DET_EVEN_B\n"
+	"States s0 s1\n"
+	"Final States s0\n"
+	"Transitions\n"
+	"x -> s0\n"
+	"a(s0) -> s0\n"
+	"b(s0) -> s1\n"
+	"a(s1) -> s1\n"
+	"b(s1) -> s0\n"
+	;
+
+// a b*, transitions to the sink are missing
+const std::string DET_AB =
+	"Ops a:1 b:1 x:0\n"
+	"Automaton DET_AB\n"
+	"States p0 p1\n"
+	"Final States p1\n"
+	"Transitions\n"
+	"x -> p0\n"
+	"a(p0) -> p1\n"
+	"b(p1) -> p1\n"
+	;
+
+// a b*, the loop is unrolled and transitions to the sink are missing
+const std::string DET_AB_BIG =
+	"Ops a:1 b:1 x:0\n"
+	"Automaton DET_AB_BIG\n"
+	"States r0 r1 r2\n"
+	"Final States r1 r2\n"
+	"Transitions\n"
+	"x -> r0\n"
+	"a(r0) -> r1\n"
+	"b(r1) -> r2\n"
+	"b(r2) -> r1\n"
+	;
+
+// a b* | a b (b b)* a, transitions to the sink are missing
+const std::string DET_AB_ABBA =
+	"Ops a:1 b:1 x:0\n"
+	"Automaton DET_AB_ABBA\n"
+	"States r0 r1 r2 r3\n"
+	"Final States r1 r2 r3\n"
+	"Transitions\n"
+	"x -> r0\n"
+	"a(r0) -> r1\n"
+	"b(r1) -> r2\n"
+	"b(r2) -> r1\n"
+	"a(r2) -> r3\n"
+	;
+
+// a b*, the sink is explicit
+const std::string DET_AB_COMPLETE =
+	"Ops a:1 b:1 x:0\n"
+	"Automaton DET_AB_COMPLETE\n"
+	"States q0 q1 q2\n"
+	"Final States q1\n"
+	"Transitions\n"
+	"x -> q0\n"
+	"a(q0) -> q1\n"
+	"b(q0) -> q2\n"
+	"a(q1) -> q2\n"
+	"b(q1) -> q1\n"
+	"a(q2) -> q2\n"
+	"b(q2) -> q2\n"
+	;
+
+// the empty language, no state is useful
+const std::string DET_EMPTY =
+	"Ops a:1 b:1 x:0\n"
+	"Automaton DET_EMPTY\n"
+	"States q0 q1\n"
+	"Final States\n"
+	"Transitions\n"
+	"x -> q0\n"
+	"a(q0) -> q1\n"
+	"b(q1) -> q1\n"
+	;
+
+// the second to last symbol is a, nondeterministic
+const std::string NONDET_SECOND_LAST_A =
+	"Ops a:1 b:1 x:0\n"
+	"Automaton NONDET_SECOND_LAST_A\n"
+	"States q0 q1 q2\n"
+	"Final States q2\n"
+	"Transitions\n"
+	"x -> q0\n"
+	"a(q0) -> q0\n"
+	"b(q0) -> q0\n"
+	"a(q0) -> q1\n"
+	"a(q1) -> q2\n"
+	"b(q1) -> q2\n"
+	;
+
+// the last symbol is a, nondeterministic
+const std::string NONDET_LAST_A =
+	"Ops a:1 b:1 x:0\n"
+	"Automaton NONDET_LAST_A\n"
+	"States q0 q1\n"
+	"Final States q1\n"
+	"Transitions\n"
+	"x -> q0\n"
+	"a(q0) -> q0\n"
+	"b(q0) -> q0\n"
+	"a(q0) -> q1\n"
+	;
+
+// a*
+const std::string NONDET_A_STAR =
+	"Ops a:1 x:0\n"
+	"Automaton NONDET_A_STAR\n"
+	"States q0\n"
+	"Final States q0\n"
+	"Transitions\n"
+	"x -> q0\n"
+	"a(q0) -> q0\n"
+	;
+
+// a^n for n other than 3, nondeterministic
+const std::string NONDET_A_STAR_BUT_3 =
+	"Ops a:1 x:0\n"
+	"Automaton NONDET_A_STAR_BUT_3\n"
+	"States r0 r1 r2 s0 s1 s2 s3 s4\n"
+	"Final States r0 r1 r2 s4\n"
+	"Transitions\n"
+	"x -> r0\n"
+	"x -> s0\n"
+	"a(r0) -> r1\n"
+	"a(r1) -> r2\n"
+	"a(s0) -> s1\n"
+	"a(s1) -> s2\n"
+	"a(s2) -> s3\n"
+	"a(s3) -> s4\n"
+	"a(s4) -> s4\n"
+	;
+
+
+/******************************************************************************
+ *                                  Fixtures                                  *
+ ******************************************************************************/
+
+/**
+ * @brief  ExplicitFiniteAut testing fixture
+ *
+ * Fixture for test of ExplicitFiniteAut
+ */
+class ExplicitFiniteAutFixture : public LogFixture
+{
+protected:// data types
+
+	typedef ExplicitFiniteAut AutType;
+	typedef std::vector<std::string> StringWord;
+
+protected:// data members
+
+	TimbukParser parser_;
+
+protected:// methods
+
+	ExplicitFiniteAutFixture() :
+		parser_()
+	{ }
+
+	AutType readAut(const std::string& str)
+	{
+		AutType aut;
+		aut.LoadFromString(parser_, str);
+		return aut;
+	}
+
+	/**
+	 * @brief  Checks equivalence of deterministic automata
+	 *
+	 * The congruence algorithm decides deterministic automata by
+	 * Hopcroft-Karp, the result is compared with the expected one and with
+	 * the result of inclusion checking in the both directions.
+	 */
+	void testDeterministicEquivalence(
+		const std::string&       lhsStr,
+		const std::string&       rhsStr,
+		bool                     expectedResult)
+	{
+		AutType lhs = readAut(lhsStr);
+		AutType rhs = readAut(rhsStr);
+
+		// inclusions do not take the Hopcroft-Karp path
+		InclParam ip;
+		ip.SetAlgorithm(InclParam::e_algorithm::congruences);
+		BOOST_REQUIRE_MESSAGE(expectedResult ==
+			(AutType::CheckInclusion(lhs, rhs, ip) && AutType::CheckInclusion(rhs, lhs, ip)),
+			"\n\nInclusions disagree with the expected result " +
+			Convert::ToString(expectedResult) + " for:\n" + lhsStr + "\n" + rhsStr);
+
+		for (auto order : {EqParam::e_search_order::breadth,
+			EqParam::e_search_order::depth})
+		{
+			EqParam ep;
+			ep.SetAlgorithm(EqParam::e_algorithm::bisimulation);
+			ep.SetUseCongr(true);
+			ep.SetSearchOrder(order);
+
+			BOOST_CHECK_MESSAGE(
+				expectedResult == AutType::CheckEquivalence(lhs, rhs, ep),
+				"\n\nError checking equivalence: expected " +
+				Convert::ToString(expectedResult) + " for:\n" + lhsStr + "\n" + rhsStr);
+			BOOST_CHECK_MESSAGE(
+				expectedResult == AutType::CheckEquivalence(rhs, lhs, ep),
+				"\n\nError checking equivalence: expected " +
+				Convert::ToString(expectedResult) + " for:\n" + rhsStr + "\n" + lhsStr);
+		}
+	}
+
+	StringWord translateWord(const AutType::Word& word, const AutType& aut)
+	{
+		AutType::AbstractAlphabet::BwdTranslatorPtr symbolTransl =
+			aut.GetAlphabet()->GetSymbolBackTransl();
+
+		StringWord result;
+		for (const auto& symbol : word)
+		{
+			result.push_back((*symbolTransl)(symbol));
+		}
+
+		return result;
+	}
+
+	/**
+	 * @brief  Checks whether an automaton accepts a word
+	 *
+	 * The word is accepted iff the language of the automaton accepting
+	 * just the word is included in the language of @p aut.
+	 */
+	bool accepts(const AutType& aut, const StringWord& word)
+	{
+		std::string wordStr =
+			"Automaton WORD\n"
+			"Final States w" + Convert::ToString(word.size()) + "\n"
+			"Transitions\n"
+			"x -> w0\n";
+		for (size_t i = 0; i < word.size(); ++i)
+		{
+			wordStr += word[i] + "(w" + Convert::ToString(i) + ") -> w" +
+				Convert::ToString(i + 1) + "\n";
+		}
+
+		InclParam ip;
+		ip.SetAlgorithm(InclParam::e_algorithm::congruences);
+		return AutType::CheckInclusion(readAut(wordStr), aut, ip);
+	}
+
+	/**
+	 * @brief  Checks that no word shorter than @p length over @p alphabet
+	 *         is accepted by just one of the automata
+	 */
+	bool noShorterWitness(
+		const AutType&                    lhs,
+		const AutType&                    rhs,
+		const std::vector<std::string>&   alphabet,
+		size_t                            length,
+		bool                              onlyLhs)
+	{
+		std::vector<StringWord> words = {StringWord()};
+		for (size_t len = 0; len < length; ++len)
+		{
+			std::vector<StringWord> longerWords;
+			for (const StringWord& word : words)
+			{
+				const bool inLhs = accepts(lhs, word);
+				const bool inRhs = accepts(rhs, word);
+				if (onlyLhs ? (inLhs && !inRhs) : (inLhs != inRhs))
+				{
+					return false;
+				}
+
+				for (const std::string& symbol : alphabet)
+				{
+					longerWords.push_back(word);
+					longerWords.back().push_back(symbol);
+				}
+			}
+
+			words.swap(longerWords);
+		}
+
+		return true;
+	}
+
+	/**
+	 * @brief  Checks the counterexample of a failed inclusion
+	 *
+	 * The word needs to be accepted by @p smallerStr and not by
+	 * @p biggerStr, for the breadth-first order it needs to be a shortest one.
+	 */
+	void testInclusionCounterexample(
+		const std::string&                smallerStr,
+		const std::string&                biggerStr,
+		const std::vector<std::string>&   alphabet)
+	{
+		AutType smaller = readAut(smallerStr);
+		AutType bigger = readAut(biggerStr);
+
+		for (auto order : {InclParam::e_search_order::breadth,
+			InclParam::e_search_order::depth})
+		{
+			InclParam ip;
+			ip.SetAlgorithm(InclParam::e_algorithm::congruences);
+			ip.SetSearchOrder(order);
+
+			AutType::Word word;
+			BOOST_REQUIRE_MESSAGE(!AutType::CheckInclusion(smaller, bigger, ip, word),
+				"\n\nInclusion unexpectedly holds for:\n" + smallerStr + "\n" + biggerStr);
+
+			StringWord strWord = translateWord(word, smaller);
+			BOOST_CHECK_MESSAGE(accepts(smaller, strWord) && !accepts(bigger, strWord),
+				"\n\nInvalid counterexample " + Convert::ToString(strWord) +
+				" for:\n" + smallerStr + "\n" + biggerStr);
+
+			if (InclParam::e_search_order::breadth == order)
+			{
+				BOOST_CHECK_MESSAGE(
+					noShorterWitness(smaller, bigger, alphabet, strWord.size(), true),
+					"\n\nCounterexample " + Convert::ToString(strWord) +
+					" is not a shortest one for:\n" + smallerStr + "\n" + biggerStr);
+			}
+		}
+	}
+
+	/**
+	 * @brief  Checks the counterexample of a failed equivalence
+	 *
+	 * The word needs to be accepted by just one of the automata, for the
+	 * breadth-first order it needs to be a shortest one.
+	 */
+	void testEquivalenceCounterexample(
+		const std::string&                lhsStr,
+		const std::string&                rhsStr,
+		const std::vector<std::string>&   alphabet)
+	{
+		AutType lhs = readAut(lhsStr);
+		AutType rhs = readAut(rhsStr);
+
+		for (auto order : {EqParam::e_search_order::breadth,
+			EqParam::e_search_order::depth})
+		{
+			EqParam ep;
+			ep.SetAlgorithm(EqParam::e_algorithm::bisimulation);
+			ep.SetUseCongr(true);
+			ep.SetSearchOrder(order);
+
+			AutType::Word word;
+			BOOST_REQUIRE_MESSAGE(!AutType::CheckEquivalence(lhs, rhs, ep, word),
+				"\n\nEquivalence unexpectedly holds for:\n" + lhsStr + "\n" + rhsStr);
+
+			StringWord strWord = translateWord(word, lhs);
+			BOOST_CHECK_MESSAGE(accepts(lhs, strWord) != accepts(rhs, strWord),
+				"\n\nInvalid counterexample " + Convert::ToString(strWord) +
+				" for:\n" + lhsStr + "\n" + rhsStr);
+
+			if (EqParam::e_search_order::breadth == order)
+			{
+				BOOST_CHECK_MESSAGE(
+					noShorterWitness(lhs, rhs, alphabet, strWord.size(), false),
+					"\n\nCounterexample " + Convert::ToString(strWord) +
+					" is not a shortest one for:\n" + lhsStr + "\n" + rhsStr);
+			}
+		}
+	}
+
+	/**
+	 * @brief  Runs @p test on the pairs of automata of @p filename
+	 *
+	 * The files list deterministic automata together with their reversed
+	 * (nondeterministic) versions. The automata passed to @p test are
+	 * sanitized for inclusion.
+	 */
+	template <class Test>
+	void forAutomataPairs(const fs::path& filename, Test test)
+	{
+		auto testfileContent = ParseTestFile(filename.string());
+
+		for (auto testcase : testfileContent)
+		{
+			BOOST_REQUIRE_MESSAGE(testcase.size() == 3, "Invalid format of a testcase: " +
+				Convert::ToString(testcase));
+
+			std::string inputSmallerFile = (AUT_DIR / testcase[0]).string();
+			std::string inputBiggerFile = (AUT_DIR / testcase[1]).string();
+			bool expectedResult = static_cast<bool>(
+				Convert::FromString<unsigned>(testcase[2]));
+
+			AutType smaller = readAut(VATA::Util::ReadFile(inputSmallerFile));
+			AutType bigger = readAut(VATA::Util::ReadFile(inputBiggerFile));
+
+			AutBase::SanitizeAutsForInclusion(smaller, bigger);
+
+			test(smaller, bigger, expectedResult, inputSmallerFile + " <= " +
+				inputBiggerFile);
+		}
+	}
+
+	/**
+	 * @brief  Checks inclusion of automata sanitized for inclusion
+	 *
+	 * The forward simulation (if used) is computed over the union of the
+	 * automata, the congruence algorithm then runs on the union.
+	 */
+	bool checkInclusion(
+		const AutType&           smaller,
+		const AutType&           bigger,
+		InclParam                ip,
+		AutType::Word*           counterexample = nullptr)
+	{
+		AutBase::StateDiscontBinaryRelation sim;
+
+		AutType newSmaller = smaller;
+		if (ip.GetUseSimulation())
+		{
+			AutType unionAut = AutType::UnionDisjointStates(smaller, bigger);
+
+			SimParam sp;
+			sp.SetRelation(SimParam::e_sim_relation::FA_FORWARD);
+			sim = unionAut.ComputeSimulation(sp);
+			ip.SetSimulation(&sim);
+
+			if (InclParam::e_algorithm::congruences == ip.GetAlgorithm())
+			{
+				newSmaller = unionAut;
+			}
+		}
+
+		if (nullptr != counterexample)
+		{
+			return AutType::CheckInclusion(newSmaller, bigger, ip, *counterexample);
+		}
+
+		return AutType::CheckInclusion(newSmaller, bigger, ip);
+	}
+
+	/**
+	 * @brief  Checks antichain inclusion on FA_INCLUSION_TIMBUK_FILE
+	 */
+	void testAntichainInclusion(bool useSimulation)
+	{
+		forAutomataPairs(FA_INCLUSION_TIMBUK_FILE, [this, useSimulation](
+			const AutType& smaller, const AutType& bigger, bool expectedResult,
+			const std::string& desc)
+		{
+			InclParam ip;
+			ip.SetUseSimulation(useSimulation);
+
+			bool doesInclusionHold = checkInclusion(smaller, bigger, ip);
+
+			BOOST_CHECK_MESSAGE(expectedResult == doesInclusionHold,
+				"\n\nError checking inclusion " + desc + ": expected " +
+				Convert::ToString(expectedResult) + ", got " +
+				Convert::ToString(doesInclusionHold));
+		});
+	}
+
+	/**
+	 * @brief  Checks the parallel breadth-first congruence inclusion
+	 *
+	 * The result and the counterexample of 4 threads need to be the same
+	 * as of 1 thread, the result also needs to agree with antichains.
+	 */
+	void testParallelInclusion(bool useSimulation)
+	{
+		forAutomataPairs(FA_INCLUSION_TIMBUK_FILE, [this, useSimulation](
+			const AutType& smaller, const AutType& bigger, bool expectedResult,
+			const std::string& desc)
+		{
+			InclParam antichainsIp;
+			antichainsIp.SetUseSimulation(useSimulation);
+			BOOST_CHECK_MESSAGE(
+				expectedResult == checkInclusion(smaller, bigger, antichainsIp),
+				"\n\nError checking inclusion " + desc + " by antichains");
+
+			std::vector<AutType::Word> words;
+			for (unsigned threads : {1, 4})
+			{
+				InclParam ip;
+				ip.SetAlgorithm(InclParam::e_algorithm::congruences);
+				ip.SetSearchOrder(InclParam::e_search_order::breadth);
+				ip.SetUseSimulation(useSimulation);
+				ip.SetThreads(threads);
+
+				words.push_back(AutType::Word());
+				bool doesInclusionHold = checkInclusion(smaller, bigger, ip, &words.back());
+
+				BOOST_CHECK_MESSAGE(expectedResult == doesInclusionHold,
+					"\n\nError checking inclusion " + desc + " with " +
+					Convert::ToString(threads) + " threads: expected " +
+					Convert::ToString(expectedResult) + ", got " +
+					Convert::ToString(doesInclusionHold));
+
+				if (!doesInclusionHold)
+				{
+					StringWord strWord = translateWord(words.back(), smaller);
+					BOOST_CHECK_MESSAGE(accepts(smaller, strWord) && !accepts(bigger, strWord),
+						"\n\nInvalid counterexample " + Convert::ToString(strWord) +
+						" of " + desc + " with " + Convert::ToString(threads) + " threads");
+				}
+			}
+
+			BOOST_CHECK_MESSAGE(words[0] == words[1],
+				"\n\nCounterexamples of " + desc + " differ: " +
+				Convert::ToString(translateWord(words[0], smaller)) + " with 1 thread, " +
+				Convert::ToString(translateWord(words[1], smaller)) + " with 4 threads");
+		});
+	}
+
+	/**
+	 * @brief  Checks the parallel breadth-first congruence equivalence
+	 *
+	 * The result and the counterexample of 4 threads need to be the same
+	 * as of 1 thread, the result also needs to agree with antichains
+	 * checking the inclusion in the both directions.
+	 */
+	void testParallelEquivalence(bool useSimulation)
+	{
+		forAutomataPairs(FA_EQUIVALENCE_TIMBUK_FILE, [this, useSimulation](
+			const AutType& lhs, const AutType& rhs, bool expectedResult,
+			const std::string& desc)
+		{
+			InclParam antichainsIp;
+			antichainsIp.SetUseSimulation(useSimulation);
+			BOOST_CHECK_MESSAGE(expectedResult == (checkInclusion(lhs, rhs, antichainsIp) &&
+				checkInclusion(rhs, lhs, antichainsIp)),
+				"\n\nError checking equivalence " + desc + " by antichains");
+
+			std::vector<AutType::Word> words;
+			for (unsigned threads : {1, 4})
+			{
+				EqParam ep;
+				ep.SetAlgorithm(EqParam::e_algorithm::bisimulation);
+				ep.SetUseCongr(true);
+				ep.SetSearchOrder(EqParam::e_search_order::breadth);
+				ep.SetUseSimulation(useSimulation);
+				ep.SetThreads(threads);
+
+				words.push_back(AutType::Word());
+				bool doesEquivalenceHold = AutType::CheckEquivalence(lhs, rhs, ep, words.back());
+
+				BOOST_CHECK_MESSAGE(expectedResult == doesEquivalenceHold,
+					"\n\nError checking equivalence " + desc + " with " +
+					Convert::ToString(threads) + " threads: expected " +
+					Convert::ToString(expectedResult) + ", got " +
+					Convert::ToString(doesEquivalenceHold));
+
+				if (!doesEquivalenceHold)
+				{
+					StringWord strWord = translateWord(words.back(), lhs);
+					BOOST_CHECK_MESSAGE(accepts(lhs, strWord) != accepts(rhs, strWord),
+						"\n\nInvalid counterexample " + Convert::ToString(strWord) +
+						" of " + desc + " with " + Convert::ToString(threads) + " threads");
+				}
+			}
+
+			BOOST_CHECK_MESSAGE(words[0] == words[1],
+				"\n\nCounterexamples of " + desc + " differ: " +
+				Convert::ToString(translateWord(words[0], lhs)) + " with 1 thread, " +
+				Convert::ToString(translateWord(words[1], lhs)) + " with 4 threads");
+		});
+	}
+};
+
+
+/******************************************************************************
+ *                              Start of testing                              *
+ ******************************************************************************/
+
+
+BOOST_FIXTURE_TEST_SUITE(suite, ExplicitFiniteAutFixture)
+
+BOOST_AUTO_TEST_CASE(aut_det_equivalence_complete)
+{
+	testDeterministicEquivalence(DET_EVEN_A, DET_EVEN_A, true);
+	testDeterministicEquivalence(DET_EVEN_A, DET_EVEN_A_BIG, true);
+	testDeterministicEquivalence(DET_EVEN_A, DET_EVEN_B, false);
+	testDeterministicEquivalence(DET_EVEN_A_BIG, DET_EVEN_B, false);
+}
+
+BOOST_AUTO_TEST_CASE(aut_det_equivalence_missing_transitions)
+{
+	testDeterministicEquivalence(DET_AB, DET_AB_BIG, true);
+	testDeterministicEquivalence(DET_AB, DET_AB_COMPLETE, true);
+	testDeterministicEquivalence(DET_AB, DET_AB_ABBA, false);
+	testDeterministicEquivalence(DET_AB_COMPLETE, DET_AB_ABBA, false);
+	testDeterministicEquivalence(DET_AB, DET_EVEN_B, false);
+}
+
+BOOST_AUTO_TEST_CASE(aut_det_equivalence_empty)
+{
+	testDeterministicEquivalence(DET_EMPTY, DET_EMPTY, true);
+	testDeterministicEquivalence(DET_EMPTY, DET_AB, false);
+}
+
+BOOST_AUTO_TEST_CASE(aut_inclusion_counterexample)
+{
+	testInclusionCounterexample(NONDET_SECOND_LAST_A, NONDET_LAST_A, {"a", "b"});
+	testInclusionCounterexample(NONDET_LAST_A, NONDET_SECOND_LAST_A, {"a", "b"});
+	testInclusionCounterexample(NONDET_A_STAR, NONDET_A_STAR_BUT_3, {"a"});
+	testInclusionCounterexample(DET_AB_ABBA, DET_AB, {"a", "b"});
+	testInclusionCounterexample(DET_EVEN_A, DET_EVEN_B, {"a", "b"});
+}
+
+BOOST_AUTO_TEST_CASE(aut_equivalence_counterexample)
+{
+	testEquivalenceCounterexample(NONDET_SECOND_LAST_A, NONDET_LAST_A, {"a", "b"});
+	testEquivalenceCounterexample(NONDET_A_STAR_BUT_3, NONDET_A_STAR, {"a"});
+	testEquivalenceCounterexample(DET_AB, DET_AB_ABBA, {"a", "b"});
+	testEquivalenceCounterexample(DET_EVEN_A_BIG, DET_EVEN_B, {"a", "b"});
+	testEquivalenceCounterexample(DET_EMPTY, DET_AB, {"a", "b"});
+}
+
+BOOST_AUTO_TEST_CASE(aut_inclusion_antichains)
+{
+	testAntichainInclusion(false);
+}
+
+BOOST_AUTO_TEST_CASE(aut_inclusion_antichains_sim)
+{
+	testAntichainInclusion(true);
+}
+
+BOOST_AUTO_TEST_CASE(aut_simulation_threads)
+{
+	forAutomataPairs(FA_INCLUSION_TIMBUK_FILE, [](const AutType& smaller,
+		const AutType& bigger, bool, const std::string& desc)
+	{
+		AutType unionAut = AutType::UnionDisjointStates(smaller, bigger);
+
+		std::vector<AutBase::StateDiscontBinaryRelation> sims;
+		for (unsigned threads : {1, 4})
+		{
+			SimParam sp;
+			sp.SetRelation(SimParam::e_sim_relation::FA_FORWARD);
+			sp.SetThreads(threads);
+			sims.push_back(unionAut.ComputeSimulation(sp));
+		}
+
+		BOOST_REQUIRE_MESSAGE(sims[0].size() == sims[1].size(),
+			"\n\nSimulations of the union of " + desc + " with 1 and 4 threads differ in size");
+
+		AutBase::StateDiscontBinaryRelation::IndexType index;
+		sims[0].buildIndex(index);
+		for (const auto& lhs : index)
+		{
+			for (const auto& rhs : index)
+			{
+				BOOST_CHECK_MESSAGE(
+					sims[0].get(lhs.first, rhs.first) == sims[1].get(lhs.first, rhs.first),
+					"\n\nSimulations of the union of " + desc + " with 1 and 4 threads differ on (" +
+					Convert::ToString(lhs.first) + ", " + Convert::ToString(rhs.first) + ")");
+			}
+		}
+	});
+}
+
+BOOST_AUTO_TEST_CASE(aut_inclusion_cache_statistics)
+{
+	forAutomataPairs(FA_INCLUSION_TIMBUK_FILE, [this](const AutType& smaller,
+		const AutType& bigger, bool, const std::string& desc)
+	{
+		std::vector<VATA::CacheStatistics> stats;
+		for (unsigned threads : {1, 4})
+		{
+			stats.push_back(VATA::CacheStatistics());
+
+			InclParam ip;
+			ip.SetAlgorithm(InclParam::e_algorithm::congruences);
+			ip.SetSearchOrder(InclParam::e_search_order::breadth);
+			ip.SetThreads(threads);
+			ip.SetCacheStatistics(&stats.back());
+
+			checkInclusion(smaller, bigger, ip);
+		}
+
+		BOOST_CHECK_MESSAGE(stats[0].finiteMacrostates.misses > 0,
+			"\n\nNo macrostates cached checking " + desc);
+
+		// the posts are merged in the same order for any number of threads
+		BOOST_CHECK_MESSAGE(
+			(stats[0].finiteMacrostates.hits == stats[1].finiteMacrostates.hits) &&
+			(stats[0].finiteMacrostates.misses == stats[1].finiteMacrostates.misses) &&
+			(stats[0].finiteMacrostateCollisions == stats[1].finiteMacrostateCollisions),
+			"\n\nCounters of the cache of macrostates checking " + desc +
+			" differ with 1 and 4 threads");
+	});
+}
+
+BOOST_AUTO_TEST_CASE(aut_inclusion_congr_parallel)
+{
+	testParallelInclusion(false);
+}
+
+BOOST_AUTO_TEST_CASE(aut_inclusion_congr_parallel_sim)
+{
+	testParallelInclusion(true);
+}
+
+BOOST_AUTO_TEST_CASE(aut_equivalence_congr_parallel)
+{
+	testParallelEquivalence(false);
+}
+
+BOOST_AUTO_TEST_CASE(aut_equivalence_congr_parallel_sim)
+{
+	testParallelEquivalence(true);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -12,6 +12,9 @@
 #include <vata/vata.hh>
 #include <vata/explicit_tree_aut.hh>
 
+// Standard library headers
+#include <set>
+
 #include "log_fixture.hh"
 
 /******************************************************************************
@@ -21,6 +24,13 @@
 const fs::path UNREACHABLE_TIMBUK_FILE =
 	AUT_DIR / "td_unreachable_removal_timbuk.txt";
 
+const fs::path INCLUSION_ARTMC_TIMBUK_FILE =
+	AUT_DIR / "inclusion_artmc_timbuk.txt";
+
+// an included pair whose check overflows a small cache memory in every variant
+const fs::path EVICTION_SMALLER_FILE = AUT_DIR / "artmc_timbuk" / "A0053";
+const fs::path EVICTION_BIGGER_FILE = AUT_DIR / "artmc_timbuk" / "A0055";
+
 /******************************************************************************
  *                                  Fixtures                                  *
  ******************************************************************************/
@@ -51,6 +61,62 @@ BOOST_AUTO_TEST_CASE(aut_down_simulation)
 	testDownwardSimulation();
 }
 
+BOOST_AUTO_TEST_CASE(aut_simulation_threads)
+{
+	auto testfileContent = ParseTestFile(LOAD_TIMBUK_FILE.string());
+
+	for (auto testcase : testfileContent)
+	{
+		BOOST_REQUIRE_MESSAGE(testcase.size() == 1, "Invalid format of a testcase: " +
+			Convert::ToString(testcase));
+
+		std::string filename = (AUT_DIR / testcase[0]).string();
+		BOOST_TEST_MESSAGE("Computing simulations with threads for " + filename + "...");
+		std::string autStr = VATA::Util::ReadFile(filename);
+
+		StateDict stateDict;
+		AutType aut;
+		readAut(aut, stateDict, autStr);
+
+		// states without transitions are not in the relations
+		std::set<StateType> states;
+		for (const Transition& trans : aut)
+		{
+			states.insert(trans.GetParent());
+			states.insert(trans.GetChildren().begin(), trans.GetChildren().end());
+		}
+
+		for (auto relation : {SimParam::e_sim_relation::TA_DOWNWARD,
+			SimParam::e_sim_relation::TA_UPWARD})
+		{
+			if ((SimParam::e_sim_relation::TA_UPWARD == relation) && states.empty())
+			{	// the upward LTS of an automaton without transitions is empty
+				continue;
+			}
+
+			std::vector<StateDiscontBinaryRelation> sims;
+			for (unsigned threads : {1, 4})
+			{
+				SimParam sp;
+				sp.SetRelation(relation);
+				sp.SetNumStates(stateDict.size());
+				sp.SetThreads(threads);
+				sims.push_back(aut.ComputeSimulation(sp));
+			}
+
+			for (const StateType& lhs : states)
+			{
+				for (const StateType& rhs : states)
+				{
+					BOOST_CHECK_MESSAGE(sims[0].get(lhs, rhs) == sims[1].get(lhs, rhs),
+						"\n\nSimulations of " + filename + " with 1 and 4 threads differ on (" +
+						stateDict.TranslateBwd(lhs) + ", " + stateDict.TranslateBwd(rhs) + ")");
+				}
+			}
+		}
+	}
+}
+
 BOOST_AUTO_TEST_CASE(aut_down_inclusion_nonrec_nosim)
 {
 	VATA::InclParam ip;
@@ -85,6 +151,148 @@ BOOST_AUTO_TEST_CASE(aut_down_inclusion_opt_rec_sim)
 	testInclusion(ip);
 }
 
+BOOST_AUTO_TEST_CASE(aut_down_inclusion_opt_nonrec_nosim)
+{
+	VATA::InclParam ip;
+	ip.SetDirection(InclParam::e_direction::downward);
+	ip.SetUseDownwardCacheImpl(true);
+	testInclusion(ip);
+}
+
+BOOST_AUTO_TEST_CASE(aut_down_inclusion_opt_nonrec_sim)
+{
+	VATA::InclParam ip;
+	ip.SetDirection(InclParam::e_direction::downward);
+	ip.SetUseDownwardCacheImpl(true);
+	ip.SetUseSimulation(true);
+	testInclusion(ip);
+}
+
+BOOST_AUTO_TEST_CASE(aut_down_inclusion_deep)
+{
+	// a chain of unary transitions deep enough to overflow the call stack of
+	// a recursive check
+	const size_t depth = 20000;
+
+	auto chain = [depth](size_t finalState) -> std::string
+	{
+		std::string str = "Ops a:1 c:0\nAutomaton chain\nStates";
+		for (size_t state = 0; state <= depth; ++state)
+		{
+			str += " q" + Convert::ToString(state);
+		}
+
+		str += "\nFinal States q" + Convert::ToString(finalState) +
+			"\nTransitions\nc -> q0\n";
+		for (size_t state = 0; state < depth; ++state)
+		{
+			str += "a(q" + Convert::ToString(state) + ") -> q" +
+				Convert::ToString(state + 1) + "\n";
+		}
+
+		return str;
+	};
+
+	const std::string autChainStr = chain(depth);
+	const std::string autShorterStr = chain(depth - 1);
+
+	for (bool rec : {false, true})
+	{
+		for (bool optC : {false, true})
+		{
+			VATA::InclParam ip;
+			ip.SetDirection(InclParam::e_direction::downward);
+			ip.SetUseRecursion(rec);
+			ip.SetUseDownwardCacheImpl(optC);
+
+			const std::string variant = " with rec=" + Convert::ToString(rec) +
+				", optC=" + Convert::ToString(optC);
+
+			for (const std::string* autBiggerStr : {&autChainStr, &autShorterStr})
+			{
+				AutType autSmaller;
+				readAut(autSmaller, autChainStr);
+
+				AutType autBigger;
+				readAut(autBigger, *autBiggerStr);
+
+				AutBase::SanitizeAutsForInclusion(autSmaller, autBigger);
+
+				bool expectedResult = (&autChainStr == autBiggerStr);
+				bool doesInclusionHold = AutType::CheckInclusion(autSmaller, autBigger, ip);
+
+				BOOST_CHECK_MESSAGE(expectedResult == doesInclusionHold,
+					"\n\nError checking inclusion of deep chains" + variant +
+					": expected " + Convert::ToString(expectedResult) + ", got " +
+					Convert::ToString(doesInclusionHold));
+			}
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(aut_down_inclusion_cache_memory)
+{
+	for (bool rec : {false, true})
+	{
+		for (bool optC : {false, true})
+		{
+			VATA::InclParam ip;
+			ip.SetDirection(InclParam::e_direction::downward);
+			ip.SetUseRecursion(rec);
+			ip.SetUseDownwardCacheImpl(optC);
+			ip.SetCacheMemory(1);
+			testInclusion(ip);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(aut_down_inclusion_cache_memory_eviction)
+{
+	const std::string inputSmallerFile = EVICTION_SMALLER_FILE.string();
+	const std::string inputBiggerFile = EVICTION_BIGGER_FILE.string();
+
+	for (bool rec : {false, true})
+	{
+		for (bool optC : {false, true})
+		{
+			AutType autSmaller;
+			readAut(autSmaller, VATA::Util::ReadFile(inputSmallerFile));
+
+			AutType autBigger;
+			readAut(autBigger, VATA::Util::ReadFile(inputBiggerFile));
+
+			AutBase::SanitizeAutsForInclusion(autSmaller, autBigger);
+
+			VATA::CacheStatistics stats;
+
+			VATA::InclParam ip;
+			ip.SetDirection(InclParam::e_direction::downward);
+			ip.SetUseRecursion(rec);
+			ip.SetUseDownwardCacheImpl(optC);
+			ip.SetCacheMemory(1024);
+			ip.SetCacheStatistics(&stats);
+
+			const std::string variant = inputSmallerFile + " <= " + inputBiggerFile +
+				" with rec=" + Convert::ToString(rec) + ", optC=" + Convert::ToString(optC);
+
+			BOOST_CHECK_MESSAGE(AutType::CheckInclusion(autSmaller, autBigger, ip),
+				"\n\nError checking inclusion " + variant + ": expected 1, got 0");
+
+			BOOST_CHECK_MESSAGE(stats.lte.evictions > 0,
+				"\n\nNo comparisons of macrostates evicted checking " + variant);
+
+			if (optC)
+			{	// without the cache implementation, the macrostates and antichains
+				// of this pair may fit into the budget
+				BOOST_CHECK_MESSAGE(stats.antichains.evictions > 0,
+					"\n\nNo entries of antichains evicted checking " + variant);
+				BOOST_CHECK_MESSAGE(stats.macrostates.evictions > 0,
+					"\n\nNo macrostates evicted checking " + variant);
+			}
+		}
+	}
+}
+
 BOOST_AUTO_TEST_CASE(aut_up_inclusion)
 {
 	VATA::InclParam ip;
@@ -100,6 +308,105 @@ BOOST_AUTO_TEST_CASE(aut_up_inclusion_sim)
 	testInclusion(ip);
 }
 
+BOOST_AUTO_TEST_CASE(aut_up_inclusion_congr)
+{
+	VATA::InclParam ip;
+	ip.SetAlgorithm(InclParam::e_algorithm::congruences);
+	testInclusion(ip);
+}
+
+BOOST_AUTO_TEST_CASE(aut_up_inclusion_congr_order)
+{
+	for (auto order : {InclParam::e_search_order::size,
+		InclParam::e_search_order::breadth, InclParam::e_search_order::depth,
+		InclParam::e_search_order::final})
+	{
+		VATA::InclParam ip;
+		ip.SetAlgorithm(InclParam::e_algorithm::congruences);
+		ip.SetSearchOrder(order);
+		testInclusion(ip);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(aut_up_inclusion_congr_order_artmc)
+{
+	// the small automata do not exercise the search orders enough, so the
+	// results on these larger pairs are checked against antichains
+	auto testfileContent = ParseTestFile(INCLUSION_ARTMC_TIMBUK_FILE.string());
+
+	for (auto testcase : testfileContent)
+	{
+		BOOST_REQUIRE_MESSAGE(testcase.size() == 2, "Invalid format of a testcase: " +
+			Convert::ToString(testcase));
+
+		std::string inputSmallerFile = (AUT_DIR / testcase[0]).string();
+		std::string inputBiggerFile = (AUT_DIR / testcase[1]).string();
+
+		AutType autSmaller;
+		readAut(autSmaller, VATA::Util::ReadFile(inputSmallerFile));
+
+		AutType autBigger;
+		readAut(autBigger, VATA::Util::ReadFile(inputBiggerFile));
+
+		AutBase::SanitizeAutsForInclusion(autSmaller, autBigger);
+
+		VATA::InclParam antichainsIp;
+		antichainsIp.SetDirection(InclParam::e_direction::upward);
+		bool expectedResult = AutType::CheckInclusion(autSmaller, autBigger, antichainsIp);
+
+		for (auto order : {InclParam::e_search_order::size,
+			InclParam::e_search_order::breadth, InclParam::e_search_order::depth,
+			InclParam::e_search_order::final})
+		{
+			VATA::InclParam ip;
+			ip.SetAlgorithm(InclParam::e_algorithm::congruences);
+			ip.SetSearchOrder(order);
+
+			bool doesInclusionHold = AutType::CheckInclusion(autSmaller, autBigger, ip);
+
+			BOOST_CHECK_MESSAGE(expectedResult == doesInclusionHold,
+				"\n\nError checking inclusion " + inputSmallerFile + " <= " +
+				inputBiggerFile + " with order " +
+				Convert::ToString(static_cast<unsigned>(order)) + ": expected " +
+				Convert::ToString(expectedResult) + ", got " +
+				Convert::ToString(doesInclusionHold));
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(aut_up_inclusion_congr_threads)
+{
+	VATA::InclParam ip;
+	ip.SetAlgorithm(InclParam::e_algorithm::congruences);
+	ip.SetThreads(4);
+	testInclusion(ip);
+}
+
+BOOST_AUTO_TEST_CASE(aut_up_inclusion_threads)
+{
+	VATA::InclParam ip;
+	ip.SetDirection(InclParam::e_direction::upward);
+	ip.SetThreads(4);
+	testInclusion(ip);
+}
+
+BOOST_AUTO_TEST_CASE(aut_up_inclusion_sim_threads)
+{
+	VATA::InclParam ip;
+	ip.SetDirection(InclParam::e_direction::upward);
+	ip.SetUseSimulation(true);
+	ip.SetThreads(4);
+	testInclusion(ip);
+}
+
+BOOST_AUTO_TEST_CASE(aut_up_inclusion_congr_sim)
+{
+	VATA::InclParam ip;
+	ip.SetAlgorithm(InclParam::e_algorithm::congruences);
+	ip.SetUseSimulation(true);
+	testInclusion(ip);
+}
+
 BOOST_AUTO_TEST_CASE(iterators)
 {
 	this->runOnAutomataSet(